@@ -0,0 +1,359 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// ClangExBench.cpp
+//
+// Created By: Bryan J Muscedere
+// Date: 19/10/26.
+//
+// Microbenchmarks for the graph core. Each benchmark runs on synthetic
+// graphs of several sizes where most entities have a few outgoing edges,
+// a few have many and edges favour a small set of popular targets.
+//
+// Copyright (C) 2017, Bryan J. Muscedere
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <boost/filesystem.hpp>
+#include "../Graph/TAGraph.h"
+#include "../Graph/LowMemoryTAGraph.h"
+#include "../TupleAttribute/TAProcessor.h"
+#include "../Walker/ASTWalker.h"
+
+using namespace std;
+namespace bs = boost::filesystem;
+
+/** Synthetic Graph Settings */
+const static unsigned int GRAPH_SEED = 42;
+const static int NODES_PER_FILE = 20;
+const static int MAX_FAN_OUT = 200;
+const static double FAN_OUT_ALPHA = 1.5;
+const static double POPULARITY_SKEW = 3.0;
+const static double VARIABLE_RATIO = 0.3;
+const static double EXTERNAL_RATIO = 0.05;
+const static int NAMES_PER_OVERLOAD = 2;
+const static int NUM_QUERIES = 1024;
+
+/** Synthetic Graph */
+typedef struct {
+    vector<string> IDs;
+    vector<string> names;
+    vector<ClangNode::NodeType> types;
+    vector<int> srcs;
+    vector<string> dsts;
+    vector<ClangEdge::EdgeType> edgeTypes;
+} SyntheticGraph;
+
+/**
+ * Generates a graph with files, functions and variables. Every entity
+ * is contained in a file. Fan-out follows a Pareto distribution and
+ * targets are skewed towards popular entities. A few edges point to
+ * entities outside of the graph.
+ * @param numNodes The number of entities.
+ * @return The synthetic graph.
+ */
+SyntheticGraph generateGraph(int numNodes){
+    SyntheticGraph spec;
+    mt19937 rand(GRAPH_SEED);
+    uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    //Generates the entities.
+    int numFiles = max(1, numNodes / NODES_PER_FILE);
+    for (int i = 0; i < numNodes; i++){
+        spec.IDs.push_back(ASTWalker::generateMD5("entity" + to_string(i)));
+        if (i < numFiles) {
+            spec.names.push_back("src/file" + to_string(i) + ".cpp");
+            spec.types.push_back(ClangNode::FILE);
+        } else {
+            bool variable = uniform(rand) < VARIABLE_RATIO;
+            spec.names.push_back(((variable) ? "var" : "func") + to_string(i / NAMES_PER_OVERLOAD));
+            spec.types.push_back((variable) ? ClangNode::VARIABLE : ClangNode::FUNCTION);
+        }
+    }
+
+    //Generates the edges.
+    for (int i = numFiles; i < numNodes; i++){
+        spec.srcs.push_back(i % numFiles);
+        spec.dsts.push_back(spec.IDs.at(i));
+        spec.edgeTypes.push_back(ClangEdge::FILE_CONTAIN);
+        if (spec.types.at(i) != ClangNode::FUNCTION) continue;
+
+        double fanOut = floor(1.0 / pow(1.0 - uniform(rand), 1.0 / FAN_OUT_ALPHA));
+        for (int j = 0; j < min((int) fanOut, MAX_FAN_OUT); j++){
+            if (uniform(rand) < EXTERNAL_RATIO) {
+                spec.srcs.push_back(i);
+                spec.dsts.push_back(ASTWalker::generateMD5("external" + to_string(spec.dsts.size())));
+                spec.edgeTypes.push_back(ClangEdge::CALLS);
+                continue;
+            }
+
+            int dst = numFiles + (int) ((numNodes - numFiles) * pow(uniform(rand), POPULARITY_SKEW));
+            if (dst >= numNodes) dst = numNodes - 1;
+            spec.srcs.push_back(i);
+            spec.dsts.push_back(spec.IDs.at(dst));
+            spec.edgeTypes.push_back((spec.types.at(dst) == ClangNode::VARIABLE) ?
+                                     ClangEdge::REFERENCES : ClangEdge::CALLS);
+        }
+    }
+
+    return spec;
+}
+
+/**
+ * Adds the entities of a synthetic graph.
+ * @param graph The graph to fill.
+ * @param spec The synthetic graph.
+ */
+void addNodes(TAGraph* graph, const SyntheticGraph& spec){
+    for (int i = 0; i < spec.IDs.size(); i++){
+        graph->TAGraph::addNode(new ClangNode(spec.IDs.at(i), spec.names.at(i), spec.types.at(i)));
+    }
+}
+
+/**
+ * Adds the relations of a synthetic graph. Relations are unresolved
+ * like the ones the walkers create.
+ * @param graph The graph to fill.
+ * @param spec The synthetic graph.
+ */
+void addEdges(TAGraph* graph, const SyntheticGraph& spec){
+    for (int i = 0; i < spec.srcs.size(); i++){
+        graph->TAGraph::addEdge(new ClangEdge(spec.IDs.at(spec.srcs.at(i)), spec.dsts.at(i), spec.edgeTypes.at(i)));
+    }
+}
+
+/**
+ * Builds a TAGraph from a synthetic graph.
+ * @param spec The synthetic graph.
+ * @return The new graph.
+ */
+TAGraph* buildGraph(const SyntheticGraph& spec){
+    TAGraph* graph = new TAGraph();
+    addNodes(graph, spec);
+    addEdges(graph, spec);
+    return graph;
+}
+
+/**
+ * Benchmarks adding entities.
+ * @param state The benchmark state.
+ */
+static void BM_AddNode(benchmark::State& state){
+    SyntheticGraph spec = generateGraph((int) state.range(0));
+    for (auto _ : state){
+        state.PauseTiming();
+        TAGraph* graph = new TAGraph();
+        vector<ClangNode*> nodes;
+        for (int i = 0; i < spec.IDs.size(); i++){
+            nodes.push_back(new ClangNode(spec.IDs.at(i), spec.names.at(i), spec.types.at(i)));
+        }
+        state.ResumeTiming();
+
+        for (ClangNode* node : nodes) graph->addNode(node);
+
+        state.PauseTiming();
+        delete graph;
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * spec.IDs.size());
+}
+BENCHMARK(BM_AddNode)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+
+/**
+ * Benchmarks adding relations.
+ * @param state The benchmark state.
+ */
+static void BM_AddEdge(benchmark::State& state){
+    SyntheticGraph spec = generateGraph((int) state.range(0));
+    for (auto _ : state){
+        state.PauseTiming();
+        TAGraph* graph = new TAGraph();
+        addNodes(graph, spec);
+        vector<ClangEdge*> edges;
+        for (int i = 0; i < spec.srcs.size(); i++){
+            edges.push_back(new ClangEdge(spec.IDs.at(spec.srcs.at(i)), spec.dsts.at(i), spec.edgeTypes.at(i)));
+        }
+        state.ResumeTiming();
+
+        for (ClangEdge* edge : edges) graph->addEdge(edge);
+
+        state.PauseTiming();
+        delete graph;
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * spec.srcs.size());
+}
+BENCHMARK(BM_AddEdge)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+
+/**
+ * Benchmarks looking up relations. Half of the lookups miss.
+ * @param state The benchmark state.
+ */
+static void BM_EdgeExists(benchmark::State& state){
+    SyntheticGraph spec = generateGraph((int) state.range(0));
+    TAGraph* graph = buildGraph(spec);
+
+    mt19937 rand(GRAPH_SEED);
+    uniform_int_distribution<int> pick(0, (int) spec.srcs.size() - 1);
+    vector<int> queries;
+    for (int i = 0; i < NUM_QUERIES; i++) queries.push_back(pick(rand));
+
+    for (auto _ : state){
+        for (int i = 0; i < queries.size(); i++){
+            int edge = queries.at(i);
+            ClangEdge::EdgeType type = (i % 2 == 0) ? spec.edgeTypes.at(edge) : ClangEdge::INHERITS;
+            benchmark::DoNotOptimize(graph->edgeExists(spec.IDs.at(spec.srcs.at(edge)), spec.dsts.at(edge), type));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * queries.size());
+    delete graph;
+}
+BENCHMARK(BM_EdgeExists)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMicrosecond);
+
+/**
+ * Benchmarks looking up entities by name.
+ * @param state The benchmark state.
+ */
+static void BM_FindNodeByName(benchmark::State& state){
+    SyntheticGraph spec = generateGraph((int) state.range(0));
+    TAGraph* graph = buildGraph(spec);
+
+    mt19937 rand(GRAPH_SEED);
+    uniform_int_distribution<int> pick(0, (int) spec.names.size() - 1);
+    vector<string> queries;
+    for (int i = 0; i < NUM_QUERIES; i++) queries.push_back(spec.names.at(pick(rand)));
+
+    for (auto _ : state){
+        for (const string& name : queries) benchmark::DoNotOptimize(graph->findNodeByName(name));
+    }
+    state.SetItemsProcessed(state.iterations() * queries.size());
+    delete graph;
+}
+BENCHMARK(BM_FindNodeByName)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMicrosecond);
+
+/**
+ * Benchmarks resolving the relations of a graph.
+ * @param state The benchmark state.
+ */
+static void BM_ResolveExternalReferences(benchmark::State& state){
+    SyntheticGraph spec = generateGraph((int) state.range(0));
+    Printer* print = new Printer();
+    for (auto _ : state){
+        state.PauseTiming();
+        TAGraph* graph = buildGraph(spec);
+        state.ResumeTiming();
+
+        graph->resolveExternalReferences(print, true);
+
+        state.PauseTiming();
+        delete graph;
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * spec.srcs.size());
+    delete print;
+}
+BENCHMARK(BM_ResolveExternalReferences)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+
+/**
+ * Benchmarks generating the TA for a graph.
+ * @param state The benchmark state.
+ */
+static void BM_GenerateTAFormat(benchmark::State& state){
+    SyntheticGraph spec = generateGraph((int) state.range(0));
+    TAGraph* graph = buildGraph(spec);
+
+    size_t bytes = 0;
+    for (auto _ : state){
+        string output = graph->generateTAFormat();
+        bytes += output.size();
+        benchmark::DoNotOptimize(output.data());
+    }
+    state.SetBytesProcessed(bytes);
+    delete graph;
+}
+BENCHMARK(BM_GenerateTAFormat)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+
+/**
+ * Benchmarks spilling a low-memory graph to disk.
+ * @param state The benchmark state.
+ */
+static void BM_PurgeCurrentGraph(benchmark::State& state){
+    SyntheticGraph spec = generateGraph((int) state.range(0));
+    bs::path dir = bs::temp_directory_path() / bs::unique_path();
+    bs::create_directories(dir);
+
+    LowMemoryTAGraph::LowMemoryConfig config;
+    LowMemoryTAGraph* graph = new LowMemoryTAGraph(dir.string(), config);
+    for (auto _ : state){
+        state.PauseTiming();
+        addNodes(graph, spec);
+        addEdges(graph, spec);
+        state.ResumeTiming();
+
+        graph->purgeCurrentGraph();
+    }
+    state.SetItemsProcessed(state.iterations() * (spec.IDs.size() + spec.srcs.size()));
+
+    delete graph;
+    bs::remove_all(dir);
+}
+BENCHMARK(BM_PurgeCurrentGraph)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+
+/**
+ * Benchmarks reading a TA file.
+ * @param state The benchmark state.
+ */
+static void BM_ReadTAFile(benchmark::State& state){
+    SyntheticGraph spec = generateGraph((int) state.range(0));
+    TAGraph* graph = buildGraph(spec);
+    Printer* print = new Printer();
+
+    //Writes the file once.
+    bs::path file = bs::temp_directory_path() / bs::unique_path("%%%%-%%%%.ta");
+    if (!graph->writeTAFile(file.string())) {
+        state.SkipWithError("The TA file could not be written.");
+        delete graph;
+        delete print;
+        return;
+    }
+    delete graph;
+
+    for (auto _ : state){
+        TAProcessor processor("$INSTANCE", print);
+        benchmark::DoNotOptimize(processor.readTAFile(file.string()));
+    }
+    state.SetBytesProcessed(state.iterations() * bs::file_size(file));
+
+    bs::remove(file);
+    delete print;
+}
+BENCHMARK(BM_ReadTAFile)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+
+/**
+ * Benchmarks hashing entity IDs.
+ * @param state The benchmark state.
+ */
+static void BM_GenerateMD5(benchmark::State& state){
+    string text = "src/dir/file.cpp[" + string((size_t) state.range(0), 'x') + "]";
+    for (auto _ : state) benchmark::DoNotOptimize(ASTWalker::generateMD5(text));
+    state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_GenerateMD5)->RangeMultiplier(4)->Range(16, 1024);
+
+BENCHMARK_MAIN();
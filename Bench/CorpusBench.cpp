@@ -0,0 +1,372 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// CorpusBench.cpp
+//
+// Created By: Bryan J Muscedere
+// Date: 19/10/26.
+//
+// End to end scaling benchmark. Generates a reproducible synthetic C++
+// project with a compilation database and runs ClangEx on it in blob,
+// partial and low-memory mode. Reports throughput, peak RSS and the
+// size of the generated model for each mode.
+//
+// Copyright (C) 2017, Bryan J. Muscedere
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+
+using namespace std;
+namespace bs = boost::filesystem;
+namespace po = boost::program_options;
+
+/** Corpus Settings */
+typedef struct {
+    int files = 100;
+    int functions = 20;
+    int fanOut = 4;
+    int depth = 3;
+    int fanIn = 5;
+    int records = 2;
+    unsigned int seed = 42;
+} CorpusConfig;
+
+/** Run Results */
+typedef struct {
+    bool success = false;
+    double seconds = 0;
+    long long peakMemory = 0;
+    long long outputSize = 0;
+    long long facts = 0;
+} RunResult;
+
+/** Benchmark Modes */
+const static vector<pair<string, string>> MODES = {{"blob", "-b"}, {"partial", ""}, {"parallel", "-j 4"},
+                                                   {"low", "-b -l"}};
+const static pair<string, string> SAME_MODES = {"partial", "parallel"};
+const static string OUTPUT_NAME = "out";
+const static double BYTES_PER_MB = 1024.0 * 1024.0;
+
+/**
+ * Writes the header for a file. Each header declares the functions of
+ * its file, a chain of classes and a few structs, unions and enums.
+ * @param stream The stream to write to.
+ * @param file The file number.
+ * @param config The corpus settings.
+ */
+void writeHeader(ostream& stream, int file, const CorpusConfig& config){
+    stream << "#ifndef CORPUS_H" << file << endl << "#define CORPUS_H" << file << endl << endl;
+
+    //Records.
+    for (int i = 0; i < config.records; i++){
+        stream << "struct S" << file << "_" << i << " { int a; double b; };" << endl;
+        stream << "union U" << file << "_" << i << " { int a; float b; };" << endl;
+        stream << "enum E" << file << "_" << i << " { E" << file << "_" << i << "_A, E" << file << "_" << i << "_B };"
+               << endl;
+    }
+
+    //Class hierarchy.
+    for (int i = 0; i < config.depth; i++){
+        stream << "class C" << file << "_" << i;
+        if (i > 0) stream << " : public C" << file << "_" << i - 1;
+        stream << " {" << endl << "public:" << endl << "    virtual int m" << i << "(int x);" << endl
+               << "    int field" << i << ";" << endl << "};" << endl;
+    }
+
+    //Functions.
+    for (int i = 0; i < config.functions; i++) stream << "int f" << file << "_" << i << "(int x);" << endl;
+    stream << endl << "#endif" << endl;
+}
+
+/**
+ * Writes the source for a file. Functions call random functions from
+ * the headers the file includes.
+ * @param stream The stream to write to.
+ * @param file The file number.
+ * @param config The corpus settings.
+ * @param rand The random generator.
+ */
+void writeSource(ostream& stream, int file, const CorpusConfig& config, mt19937& rand){
+    //Picks the included headers.
+    vector<int> includes = {file};
+    uniform_int_distribution<int> pickFile(0, config.files - 1);
+    while ((int) includes.size() < config.fanIn && (int) includes.size() < config.files){
+        int include = pickFile(rand);
+        if (find(includes.begin(), includes.end(), include) == includes.end()) includes.push_back(include);
+    }
+    for (int include : includes) stream << "#include \"h" << include << ".h\"" << endl;
+    stream << endl;
+
+    //Globals that use the records.
+    for (int i = 0; i < config.records; i++){
+        stream << "S" << file << "_" << i << " gs" << i << ";" << endl;
+        stream << "U" << file << "_" << i << " gu" << i << ";" << endl;
+        stream << "E" << file << "_" << i << " ge" << i << " = E" << file << "_" << i << "_A;" << endl;
+    }
+
+    //Methods.
+    for (int i = 0; i < config.depth; i++){
+        stream << "int C" << file << "_" << i << "::m" << i << "(int x) { return x + field" << i << "; }" << endl;
+    }
+
+    //Functions.
+    uniform_int_distribution<int> pickInclude(0, (int) includes.size() - 1);
+    uniform_int_distribution<int> pickFunction(0, config.functions - 1);
+    for (int i = 0; i < config.functions; i++){
+        stream << "int f" << file << "_" << i << "(int x) {" << endl << "    int total = x;" << endl;
+        for (int j = 0; j < config.fanOut; j++){
+            stream << "    total += f" << includes.at(pickInclude(rand)) << "_" << pickFunction(rand) << "(total - 1);"
+                   << endl;
+        }
+        if (config.records > 0) stream << "    total += gs0.a;" << endl;
+        stream << "    return total;" << endl << "}" << endl;
+    }
+}
+
+/**
+ * Generates the corpus and its compilation database.
+ * @param root The directory of the corpus.
+ * @param config The corpus settings.
+ * @param lines The number of lines generated.
+ * @return Whether the corpus was written.
+ */
+bool generateCorpus(bs::path root, const CorpusConfig& config, long long* lines){
+    bs::create_directories(root / "include");
+    bs::create_directories(root / "src");
+    root = bs::canonical(root);
+
+    mt19937 rand(config.seed);
+    *lines = 0;
+    ofstream database((root / "compile_commands.json").string());
+    if (!database.is_open()) return false;
+    database << "[" << endl;
+
+    for (int i = 0; i < config.files; i++){
+        stringstream header, source;
+        writeHeader(header, i, config);
+        writeSource(source, i, config, rand);
+
+        bs::path headerFile = root / "include" / ("h" + to_string(i) + ".h");
+        bs::path sourceFile = root / "src" / ("f" + to_string(i) + ".cpp");
+        ofstream headerOut(headerFile.string()), sourceOut(sourceFile.string());
+        if (!headerOut.is_open() || !sourceOut.is_open()) return false;
+        headerOut << header.str();
+        sourceOut << source.str();
+
+        string text = header.str() + source.str();
+        *lines += count(text.begin(), text.end(), '\n');
+
+        database << "  {\"directory\": \"" << root.string() << "\", \"command\": \"c++ -std=c++11 -I"
+                 << (root / "include").string() << " -c " << sourceFile.string() << "\", \"file\": \""
+                 << sourceFile.string() << "\"}" << ((i + 1 < config.files) ? "," : "") << endl;
+    }
+
+    database << "]" << endl;
+    return !database.fail();
+}
+
+/**
+ * Counts the instances and relations in a TA file.
+ * @param fileName The TA file.
+ * @return The number of facts.
+ */
+long long countFacts(string fileName){
+    ifstream file(fileName);
+    long long facts = 0;
+    bool inFacts = false;
+
+    string line;
+    while (getline(file, line)){
+        if (line.find("FACT TUPLE") == 0) {
+            inFacts = true;
+        } else if (line.find("FACT ATTRIBUTE") == 0 || line.find("SCHEME") == 0) {
+            inFacts = false;
+        } else if (inFacts && line.size() > 0) {
+            facts++;
+        }
+    }
+
+    return facts;
+}
+
+/**
+ * Reads the facts and attributes of a TA file. The lines are sorted
+ * since their order depends on how the graph was built.
+ * @param fileName The TA file.
+ * @return The sorted lines.
+ */
+vector<string> readModel(string fileName){
+    ifstream file(fileName);
+    vector<string> model;
+    bool inFacts = false;
+
+    string line;
+    while (getline(file, line)){
+        if (line.find("FACT TUPLE") == 0) inFacts = true;
+        if (inFacts && line.size() > 0) model.push_back(line);
+    }
+
+    sort(model.begin(), model.end());
+    return model;
+}
+
+/**
+ * Runs ClangEx with a set of commands and waits for it to finish.
+ * @param clangex The ClangEx executable.
+ * @param workDir The directory ClangEx runs in.
+ * @param commands The commands to send.
+ * @param result The time and peak memory of the run.
+ */
+void runClangEx(string clangex, bs::path workDir, string commands, RunResult* result){
+    int fds[2];
+    if (pipe(fds) != 0) return;
+
+    auto start = chrono::steady_clock::now();
+    pid_t pid = fork();
+    if (pid < 0) return;
+
+    //Runs ClangEx in the work directory with its output in a log.
+    if (pid == 0) {
+        close(fds[1]);
+        dup2(fds[0], STDIN_FILENO);
+        int log = open((workDir / "clangex.log").string().c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (log >= 0) {
+            dup2(log, STDOUT_FILENO);
+            dup2(log, STDERR_FILENO);
+        }
+        if (chdir(workDir.string().c_str()) != 0) _exit(1);
+        execl(clangex.c_str(), clangex.c_str(), (char*) nullptr);
+        _exit(1);
+    }
+
+    //Sends the commands.
+    close(fds[0]);
+    if (write(fds[1], commands.c_str(), commands.size()) != (ssize_t) commands.size()) {
+        cerr << "Warning: Not every command was sent to ClangEx." << endl;
+    }
+    close(fds[1]);
+
+    int status;
+    struct rusage usage;
+    if (wait4(pid, &status, 0, &usage) != pid) return;
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+    result->seconds = elapsed.count();
+    result->peakMemory = (long long) usage.ru_maxrss * 1024;
+    result->success = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+/**
+ * Runs the end to end benchmark.
+ * @param argc The number of arguments.
+ * @param argv The arguments.
+ * @return The exit code.
+ */
+int main(int argc, const char** argv){
+    CorpusConfig config;
+    string clangex, outDir;
+    po::options_description desc("Options");
+    desc.add_options()
+            ("help,h", "Prints this message.")
+            ("out,o", po::value<string>(&outDir)->default_value("corpus"), "The directory to generate into.")
+            ("clangex,c", po::value<string>(&clangex), "The ClangEx executable. Only generates when not given.")
+            ("files", po::value<int>(&config.files)->default_value(config.files), "The number of source files.")
+            ("functions", po::value<int>(&config.functions)->default_value(config.functions), "Functions per file.")
+            ("fan-out", po::value<int>(&config.fanOut)->default_value(config.fanOut), "Calls per function.")
+            ("depth", po::value<int>(&config.depth)->default_value(config.depth), "Class hierarchy depth per file.")
+            ("fan-in", po::value<int>(&config.fanIn)->default_value(config.fanIn), "Headers included per file.")
+            ("records", po::value<int>(&config.records)->default_value(config.records),
+             "Structs, unions and enums per file.")
+            ("seed", po::value<unsigned int>(&config.seed)->default_value(config.seed), "The random seed.");
+
+    po::variables_map vm;
+    try {
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+        po::notify(vm);
+        if (config.files < 1 || config.functions < 1 || config.fanOut < 0 || config.depth < 0 ||
+                config.fanIn < 1 || config.records < 0)
+            throw po::error("The corpus settings must be positive!");
+    } catch (po::error& e) {
+        cerr << "Error: " << e.what() << endl << desc;
+        return 1;
+    }
+    if (vm.count("help")) {
+        cout << "Usage: " << argv[0] << " [options]" << endl << desc;
+        return 0;
+    }
+
+    //Generates the corpus.
+    bs::path root = bs::path(outDir) / "project";
+    long long lines;
+    if (!generateCorpus(root, config, &lines)) {
+        cerr << "Error: The corpus could not be written to " << root.string() << "." << endl;
+        return 1;
+    }
+    root = bs::canonical(root);
+    cout << "Generated " << config.files << " files with " << lines << " lines in " << root.string() << endl;
+    if (clangex.compare("") == 0) return 0;
+    clangex = bs::canonical(clangex).string();
+
+    //Runs each mode.
+    bool success = true;
+    for (auto mode : MODES){
+        bs::path workDir = bs::canonical(bs::path(outDir)) / mode.first;
+        bs::remove_all(workDir);
+        bs::create_directories(workDir);
+
+        string commands = "compdb " + (root / "compile_commands.json").string() + "\n"
+                          "generate " + mode.second + " --metrics " + (workDir / "metrics.json").string() + "\n"
+                          "output " + OUTPUT_NAME + "\n"
+                          "quit!\n";
+
+        RunResult result;
+        runClangEx(clangex, workDir, commands, &result);
+        bs::path output = workDir / (OUTPUT_NAME + ".ta");
+        if (!result.success || !bs::exists(output)) {
+            cerr << mode.first << ": ClangEx failed. See " << (workDir / "clangex.log").string() << "." << endl;
+            success = false;
+            continue;
+        }
+        result.outputSize = (long long) bs::file_size(output);
+        result.facts = countFacts(output.string());
+
+        cout << mode.first << ": " << result.seconds << " s, " << config.files / result.seconds << " TUs/s, "
+             << result.facts / result.seconds << " facts/s, " << result.peakMemory / BYTES_PER_MB << " MB peak RSS, "
+             << result.outputSize / BYTES_PER_MB << " MB output (" << result.facts << " facts)" << endl;
+    }
+
+    //Checks that the parallel run produced the same model as the serial one.
+    bs::path first = bs::canonical(bs::path(outDir)) / SAME_MODES.first / (OUTPUT_NAME + ".ta");
+    bs::path second = bs::canonical(bs::path(outDir)) / SAME_MODES.second / (OUTPUT_NAME + ".ta");
+    if (success && readModel(first.string()) != readModel(second.string())) {
+        cerr << SAME_MODES.second << ": The model differs from the " << SAME_MODES.first << " model." << endl;
+        success = false;
+    }
+
+    return (success) ? 0 : 1;
+}
@@ -0,0 +1,177 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// TAReadBench.cpp
+//
+// Created By: Bryan J Muscedere
+// Date: 19/10/26.
+//
+// Benchmark that measures how quickly TA files can be read. Reports the
+// throughput of the raw tokenizer and of the full TA processor in MB/s,
+// and how the processor scales as more threads read the file.
+//
+// Copyright (C) 2017, Bryan J. Muscedere
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../TupleAttribute/TAScanner.h"
+#include "../TupleAttribute/TAProcessor.h"
+
+using namespace std;
+
+/** Benchmark Settings */
+const static int DEFAULT_ITERATIONS = 3;
+const static double BYTES_PER_MB = 1024.0 * 1024.0;
+
+/**
+ * Tokenizes every line of a TA file.
+ * @param fileName The file to scan.
+ * @param bytes The number of bytes scanned.
+ * @return The number of tokens found.
+ */
+size_t scanFile(string fileName, size_t* bytes){
+    TAScanner scanner(fileName);
+    if (!scanner.isOpen()) return 0;
+    *bytes = scanner.getSize();
+
+    boost::string_ref line;
+    vector<boost::string_ref> tokens;
+    bool blockComment = false;
+    size_t numTokens = 0;
+    while (scanner.nextLine(line)){
+        TAScanner::tokenize(line, blockComment, tokens);
+        numTokens += tokens.size();
+    }
+
+    return numTokens;
+}
+
+/**
+ * Prints the throughput of a benchmark.
+ * @param name The name of the benchmark.
+ * @param bytes The number of bytes processed per iteration.
+ * @param times The time of each iteration in seconds.
+ */
+void printResult(string name, size_t bytes, vector<double> times){
+    double best = times.at(0);
+    double total = 0;
+    for (double time : times){
+        if (time < best) best = time;
+        total += time;
+    }
+    double mean = total / times.size();
+
+    cout << name << ": " << bytes / BYTES_PER_MB / best << " MB/s best, "
+         << bytes / BYTES_PER_MB / mean << " MB/s mean over " << times.size() << " runs" << endl;
+}
+
+/**
+ * Times the TA processor with a given number of threads.
+ * @param fileName The file to read.
+ * @param threads The number of threads.
+ * @param iterations The number of runs.
+ * @param print The printer for errors.
+ * @param times The time of each run in seconds.
+ * @return Whether every run was successful.
+ */
+bool timeProcessor(string fileName, int threads, int iterations, Printer* print, vector<double>& times){
+    times.clear();
+    for (int i = 0; i < iterations; i++){
+        TAProcessor processor("$INSTANCE", print);
+        processor.setThreads(threads);
+
+        auto start = chrono::steady_clock::now();
+        bool succ = processor.readTAFile(fileName);
+        chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+        if (!succ) return false;
+        times.push_back(elapsed.count());
+    }
+
+    return true;
+}
+
+/**
+ * Gets the best time of a set of runs.
+ * @param times The time of each run in seconds.
+ * @return The best time.
+ */
+double bestTime(const vector<double>& times){
+    double best = times.at(0);
+    for (double time : times){
+        if (time < best) best = time;
+    }
+
+    return best;
+}
+
+/**
+ * Runs the TA read benchmark.
+ * @param argc The number of arguments.
+ * @param argv The TA file and the number of iterations.
+ * @return The exit code.
+ */
+int main(int argc, const char** argv){
+    if (argc < 2){
+        cerr << "Usage: " << argv[0] << " <file.ta> [iterations]" << endl;
+        return 1;
+    }
+    string fileName = argv[1];
+    int iterations = (argc > 2) ? stoi(argv[2]) : DEFAULT_ITERATIONS;
+    if (iterations < 1) iterations = 1;
+
+    //Benchmarks the tokenizer.
+    size_t bytes = 0;
+    size_t numTokens = 0;
+    vector<double> scanTimes;
+    for (int i = 0; i < iterations; i++){
+        auto start = chrono::steady_clock::now();
+        numTokens = scanFile(fileName, &bytes);
+        chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+        scanTimes.push_back(elapsed.count());
+    }
+    if (bytes == 0){
+        cerr << "Could not read " << fileName << "." << endl;
+        return 1;
+    }
+    cout << fileName << ": " << bytes / BYTES_PER_MB << " MB, " << numTokens << " tokens" << endl;
+    printResult("Tokenizer", bytes, scanTimes);
+
+    //Benchmarks the full processor.
+    Printer* print = new Printer();
+    vector<double> readTimes;
+    if (!timeProcessor(fileName, 1, iterations, print, readTimes)){
+        delete print;
+        return 1;
+    }
+    printResult("TAProcessor", bytes, readTimes);
+
+    //Benchmarks the processor with more threads.
+    double baseTime = bestTime(readTimes);
+    int maxThreads = (int) thread::hardware_concurrency();
+    for (int threads = 2; threads <= maxThreads; threads *= 2){
+        if (!timeProcessor(fileName, threads, iterations, print, readTimes)){
+            delete print;
+            return 1;
+        }
+        printResult("TAProcessor (" + to_string(threads) + " threads)", bytes, readTimes);
+        cout << "  Speedup: " << baseTime / bestTime(readTimes) << "x" << endl;
+    }
+
+    delete print;
+    return 0;
+}
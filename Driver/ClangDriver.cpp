@@ -25,20 +25,35 @@
 /////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include <regex>
+#include <deque>
+#include <mutex>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <condition_variable>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
 #include <unordered_map>
+#include <unordered_set>
 #include <boost/foreach.hpp>
 #include <fstream>
-#include <llvm/Support/CommandLine.h>
+#include <sstream>
 #include "clang/Tooling/Tooling.h"
+#include "clang/Basic/Version.h"
 #include <boost/algorithm/string/classification.hpp>
 #include <boost/algorithm/string/split.hpp>
 #include <boost/algorithm/string.hpp>
 #include "clang/Frontend/FrontendAction.h"
 #include "../Graph/LowMemoryTAGraph.h"
-#include "../TupleAttribute/TAProcessor.h"
+#include "../Graph/ConcurrentTAGraph.h"
 #include "../Walker/ASTWalker.h"
 #include "../Walker/BlobWalker.h"
 #include "../Walker/PartialWalker.h"
+#include "../Walker/ExtractAction.h"
+#include "../Metrics/Metrics.h"
 
 using namespace std;
 using namespace clang::tooling;
@@ -67,6 +82,13 @@ void ClangDriver::cleanup(){
     for (TAGraph* graph : graphs) {
         delete graph;
     }
+    graphs.clear();
+
+    delete projectDB;
+    delete detectedDB;
+    projectDB = nullptr;
+    detectedDB = nullptr;
+    projectRoot = "";
 }
 
 /**
@@ -142,6 +164,22 @@ int ClangDriver::getNumFiles(){
     return (int) files.size();
 }
 
+/**
+ * Gets the files in the queue.
+ * @return The queued files.
+ */
+vector<path> ClangDriver::getFiles(){
+    return files;
+}
+
+/**
+ * Gets every directory that was searched for files.
+ * @return The directories that were added.
+ */
+vector<path> ClangDriver::getDirectories(){
+    return directories;
+}
+
 /**
  * Enables a feature based on a string.
  * @param feature The feature to enable.
@@ -206,53 +244,49 @@ bool ClangDriver::disableFeature(string feature){
  * @param blobMode Whether blob mode is enabled.
  * @param mergeFile Whether the user wants to merge files.
  * @param verboseMode Whether the user wants verbose output.
+ * @param jobs The number of files processed at once or the number of
+ * threads reading the initial TA file.
  * @return The success of ClangEx.
  */
-bool ClangDriver::processAllFiles(bool blobMode, string mergeFile, bool lowMemory, int startNum){
+bool ClangDriver::processAllFiles(bool blobMode, string mergeFile, bool lowMemory, int startNum, int jobs){
     bool success = true;
+    compileErrors = false;
 
-    int argc = 0;
-    char **argv = prepareArgs(&argc, 0, getNumFiles());
-    llvm::cl::OptionCategory* ClangExCategory = new llvm::cl::OptionCategory("ClangEx");
-    CommonOptionsParser* OptionsParser = new CommonOptionsParser(argc, (const char **) argv, *ClangExCategory);
+    CompilationDatabase* compilations = getCompilations();
 
     //Sets up the printer.
     Printer* clangPrint = new Printer();
 
     //Gets whether whether we're dealing with a merge.
     TAGraph *mergeGraph = nullptr;
+    ConcurrentTAGraph *concurrentGraph = nullptr;
     bool merge = false;
-    if (mergeFile.compare("") != 0) {
+    if (recoveryMode && recoveryGraph != nullptr) {
+        //Picks up the graph being recovered.
+        mergeGraph = recoveryGraph;
+    } else if (mergeFile.compare("") != 0) {
         //We're dealing with a merge.
         merge = true;
         clangPrint->printMerge(mergeFile);
 
-        //Loads the file.
-        TAProcessor processor = TAProcessor(INSTANCE_FLAG, clangPrint);
-        bool succ = processor.readTAFile(mergeFile);
+        //Streams the file into the starting graph.
+        if (!lowMemory) mergeGraph = new TAGraph();
+        else if (lowMemoryPath.empty()) mergeGraph = new LowMemoryTAGraph(lowMemoryConfig);
+        else mergeGraph = new LowMemoryTAGraph(lowMemoryPath.string(), lowMemoryConfig);
 
+        mergeGraph->setReadThreads(jobs);
+        bool succ = mergeGraph->loadTAFile(mergeFile, clangPrint);
         if (!succ) {
+            delete mergeGraph;
             delete clangPrint;
-            delete OptionsParser;
-            for (int i = 0; i < argc; i++) delete[] argv[i];
-            delete[] argv;
-            delete ClangExCategory;
-            return false;
-        }
-
-        //Gets the graph.
-        TAGraph *graph = processor.writeTAGraph();
-        if (graph == nullptr) {
-            delete clangPrint;
-            delete OptionsParser;
-            for (int i = 0; i < argc; i++) delete[] argv[i];
-            delete[] argv;
-            delete ClangExCategory;
             return false;
         }
     } else if (lowMemory){
-        if (lowMemoryPath.empty()) mergeGraph = new LowMemoryTAGraph();
-        else mergeGraph = new LowMemoryTAGraph(lowMemoryPath.string());
+        if (lowMemoryPath.empty()) mergeGraph = new LowMemoryTAGraph(lowMemoryConfig);
+        else mergeGraph = new LowMemoryTAGraph(lowMemoryPath.string(), lowMemoryConfig);
+    } else if (jobs > 1){
+        concurrentGraph = new ConcurrentTAGraph();
+        mergeGraph = concurrentGraph;
     } else {
         mergeGraph = new TAGraph();
     }
@@ -261,20 +295,52 @@ bool ClangDriver::processAllFiles(bool blobMode, string mergeFile, bool lowMemor
     TAGraph::ClangExclude exclude = toggle;
 
     //Dump settings.
-    if (lowMemory) static_cast<LowMemoryTAGraph*>(mergeGraph)->dumpSettings(files, exclude, blobMode);
+    if (lowMemory) static_cast<LowMemoryTAGraph*>(mergeGraph)->dumpSettings(files, exclude, blobMode, usrMode);
 
     //Creates the command line arguments.
     int fileSplit = (lowMemory) ? FILE_SPLIT : getNumFiles();
     clangPrint->printProcessStatus(Printer::COMPILING);
-    for (int i = startNum; i < getNumFiles(); i += fileSplit) {
-        runAnalysis(blobMode, lowMemory, mergeGraph, i, clangPrint, exclude, OptionsParser);
-        if (lowMemory) static_cast<LowMemoryTAGraph*>(mergeGraph)->purgeCurrentGraph();
+    if (concurrentGraph != nullptr) {
+#if CLANG_VERSION_MAJOR < 8
+        //Older tools change the working directory of the process, so each file is compiled in its own process.
+        path workDir = temp_directory_path() / unique_path("clangex-%%%%-%%%%-%%%%");
+        create_directories(workDir);
+#endif
+
+        //Each worker runs the next file on its own and adds it to the shared graph.
+        atomic<int> next(startNum);
+        auto worker = [&] {
+            for (int i = next++; i < getNumFiles(); i = next++) {
+                concurrentGraph->startTU(i);
+#if CLANG_VERSION_MAJOR < 8
+                runAnalysisInProcess(blobMode, mergeGraph, i, clangPrint, exclude, compilations, workDir.string());
+#else
+                runAnalysis(blobMode, false, mergeGraph, i, clangPrint, exclude, compilations, true);
+#endif
+            }
+        };
+
+        vector<thread> workers;
+        for (int i = 0; i < jobs; i++) workers.push_back(thread(worker));
+        for (auto& cur : workers) cur.join();
+        concurrentGraph->collect();
+
+#if CLANG_VERSION_MAJOR < 8
+        boost::system::error_code error;
+        remove_all(workDir, error);
+#endif
+    } else {
+        for (int i = startNum; i < getNumFiles(); i += fileSplit) {
+            runAnalysis(blobMode, lowMemory, mergeGraph, i, clangPrint, exclude, compilations);
+            if (lowMemory && !static_cast<LowMemoryTAGraph*>(mergeGraph)->commitFile(i, files.at(i).string())) {
+                cerr << "Warning: " << files.at(i).string() << " could not be committed to the journal." << endl;
+            }
+        }
     }
 
     //Shifts the graphs.
     if (success) {
-        mergeGraph->resolveExternalReferences(clangPrint, false);
-        mergeGraph->resolveFiles(exclude);
+        resolveGraph(mergeGraph, clangPrint, exclude);
         graphs.push_back(mergeGraph);
     }
 
@@ -283,10 +349,6 @@ bool ClangDriver::processAllFiles(bool blobMode, string mergeFile, bool lowMemor
 
     //Returns the success code.
     delete clangPrint;
-    delete OptionsParser;
-    for (int i = 0; i < argc; i++) delete[] argv[i];
-    delete[] argv;
-    delete ClangExCategory;
     return success;
 }
 
@@ -298,11 +360,15 @@ bool ClangDriver::processAllFiles(bool blobMode, string mergeFile, bool lowMemor
  * @param i The starting file.
  * @param clangPrint System to print messages.
  * @param exclude Items to exclude.
- * @param OptionsParser ClangEx options.
+ * @param compilations The compile commands for each file.
+ * @param singleFile Whether only the current file is compiled.
+ * @param astMemory The most AST memory used by a file.
+ * @param includes Where the headers each file includes are collected.
  * @return Whether the analysis was successful.
  */
 bool ClangDriver::runAnalysis(bool blobMode, bool lowMemory, TAGraph* mergeGraph, int i, Printer* clangPrint,
-                              TAGraph::ClangExclude exclude, CommonOptionsParser* OptionsParser) {
+                              TAGraph::ClangExclude exclude, CompilationDatabase* compilations,
+                              bool singleFile, size_t* astMemory, map<string, set<string>>* includes) {
     ASTWalker *walker;
     std::unique_ptr<FrontendActionFactory> act;
     bool success = true;
@@ -312,15 +378,26 @@ bool ClangDriver::runAnalysis(bool blobMode, bool lowMemory, TAGraph* mergeGraph
 
     if (lowMemory) static_cast<LowMemoryTAGraph*>(mergeGraph)->dumpCurrentFile(i, files.at(i).string());
 
+    //Gets the files to compile.
+    vector<string> sources = curList;
+    if (!lowMemory && !singleFile) {
+        sources.clear();
+        for (path curFile : files) sources.push_back(curFile.string());
+    }
+
     //Sets up the processor.
-    ClangTool* Tool = new ClangTool(OptionsParser->getCompilations(),
-                                    (lowMemory) ? curList : OptionsParser->getSourcePathList());
+    vector<shared_ptr<const string>> cachedContents;
+    ClangTool* Tool = createTool(compilations, sources);
+    mapCachedFiles(Tool, &cachedContents);
+    Tool->appendArgumentsAdjuster(getInsertArgumentAdjuster(INCLUDE_ARG.c_str(), ArgumentInsertPosition::END));
 
     if (blobMode) {
         walker = new BlobWalker(clangPrint, lowMemory, exclude, mergeGraph);
     } else {
         walker = new PartialWalker(clangPrint, lowMemory, exclude, mergeGraph);
     }
+    walker->setUSRMode(usrMode);
+    walker->setPathFilter((pathFilter.isEmpty()) ? nullptr : &pathFilter);
 
     //Generates a matcher system.
     MatchFinder finder;
@@ -328,17 +405,27 @@ bool ClangDriver::runAnalysis(bool blobMode, bool lowMemory, TAGraph* mergeGraph
     //Next, processes the matching conditions.
     walker->generateASTMatches(&finder);
 
-    //Runs the Clang tool.
-    act = newFrontendActionFactory(&finder);
+    //Runs the Clang tool. Everything but matching is counted as parsing.
+    //Works out which function bodies the matchers need.
+    BodySkipConsumer::BodyPolicy bodies;
+    bodies.skipAll = declsOnly || !walker->needsFunctionBodies();
+    bodies.skipOutsideMain = !blobMode;
+    bodies.filter = (pathFilter.isEmpty()) ? nullptr : &pathFilter;
+
+    act.reset(new ExtractActionFactory(&finder, mergeGraph, !exclude.cFile, includes, bodies));
+    auto start = chrono::steady_clock::now();
     int code = Tool->run(act.get());
+    Metrics::addTime(Metrics::PARSE, chrono::steady_clock::now() - start - walker->getMatchTime());
     act.reset();
     clangPrint->printFileNameDone();
 
     //Gets the code and checks for warnings.
     if (code != 0) {
         cerr << "Error: Compilation errors were detected." << endl;
+        compileErrors = true;
         success = false;
     }
+    if (astMemory != nullptr) *astMemory = walker->getASTMemory();
 
     delete walker;
     delete Tool;
@@ -346,6 +433,451 @@ bool ClangDriver::runAnalysis(bool blobMode, bool lowMemory, TAGraph* mergeGraph
     return success;
 }
 
+/**
+ * Runs the analysis of a single file in a child process and merges its
+ * facts into a graph. The facts come back through a fragment in the
+ * work directory, which is removed once it's merged.
+ * @param blobMode Blob mode toggle.
+ * @param mergeGraph Graph to merge in.
+ * @param i The file to process.
+ * @param clangPrint System to print messages.
+ * @param exclude Items to exclude.
+ * @param compilations The compile commands for each file.
+ * @param workDir The directory the fragment is passed through.
+ * @return Whether the facts of the file were merged.
+ */
+bool ClangDriver::runAnalysisInProcess(bool blobMode, TAGraph* mergeGraph, int i, Printer* clangPrint,
+                                       TAGraph::ClangExclude exclude, CompilationDatabase* compilations,
+                                       string workDir){
+    string fragmentFile = getFragmentName(workDir, files.at(i));
+    string errors;
+    bool succ = runInProcess([&](string* result) {
+        TAGraph* fragment = new TAGraph();
+        runAnalysis(blobMode, false, fragment, i, clangPrint, exclude, compilations, true);
+        *result = (compileErrors) ? "1" : "0";
+
+        bool written = fragment->writeFragment(fragmentFile);
+        delete fragment;
+        return written;
+    }, &errors);
+    if (errors.compare("1") == 0) compileErrors = true;
+
+    //Merges the facts of the file.
+    TAGraph* fragment = new TAGraph();
+    if (succ) succ = fragment->loadFragment(fragmentFile, clangPrint);
+    if (succ) {
+        mergeGraph->mergeGraph(fragment);
+    } else {
+        cerr << "Error: " << files.at(i).string() << " could not be processed." << endl;
+        compileErrors = true;
+    }
+    delete fragment;
+
+    boost::system::error_code error;
+    boost::filesystem::remove(fragmentFile, error);
+    boost::filesystem::remove(fragmentFile + TAGraph::PATHS_EXT, error);
+    return succ;
+}
+
+/**
+ * Runs a task in a child process and waits for it. The result of the
+ * task is sent back through a pipe with its size first, since other
+ * children may keep the pipe open after this one is done.
+ * @param task The task to run. Takes where its result goes.
+ * @param result Where the result of the task is stored.
+ * @return Whether the task ran and succeeded.
+ */
+bool ClangDriver::runInProcess(const function<bool(string*)>& task, string* result){
+    int fds[2];
+    if (pipe(fds) != 0) return false;
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return false;
+    }
+
+    //Runs the task and sends back its result.
+    if (pid == 0) {
+        close(fds[0]);
+        string output;
+        bool succ = task(&output);
+        uint64_t size = output.size();
+        output = string((const char*) &size, sizeof(size)) + output;
+        for (size_t pos = 0; pos < output.size();){
+            ssize_t written = write(fds[1], output.data() + pos, output.size() - pos);
+            if (written < 0 && errno == EINTR) continue;
+            if (written <= 0) {
+                succ = false;
+                break;
+            }
+            pos += written;
+        }
+        cout.flush();
+        cerr.flush();
+        _exit((succ) ? 0 : 1);
+    }
+
+    //Reads the size and then the result.
+    close(fds[1]);
+    uint64_t size = 0;
+    string output;
+    bool succ = true;
+    for (size_t pos = 0, total = sizeof(size); succ && pos < total;){
+        char buffer[4096];
+        size_t wanted = min(sizeof(buffer), total - pos);
+        ssize_t numRead = read(fds[0], buffer, wanted);
+        if (numRead < 0 && errno == EINTR) continue;
+        if (numRead <= 0) {
+            succ = false;
+            break;
+        }
+
+        output.append(buffer, numRead);
+        pos += numRead;
+        if (pos == sizeof(size)) {
+            memcpy(&size, output.data(), sizeof(size));
+            output.clear();
+            total += size;
+        }
+    }
+    close(fds[0]);
+
+    int status = 0;
+    while (waitpid(pid, &status, 0) < 0) {
+        if (errno != EINTR) return false;
+    }
+    if (result != nullptr) *result = output;
+    return succ && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+/**
+ * Creates a tool that compiles the given sources. Each tool gets its own
+ * file system so changing into a compile command's directory doesn't move
+ * the other tools running at the same time.
+ * @param compilations The compile commands for each file.
+ * @param sources The files to compile.
+ * @return The new tool.
+ */
+ClangTool* ClangDriver::createTool(CompilationDatabase* compilations, const vector<string>& sources){
+#if CLANG_VERSION_MAJOR >= 8
+    llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> baseFS(llvm::vfs::createPhysicalFileSystem().release());
+    return new ClangTool(*compilations, sources, std::make_shared<clang::PCHContainerOperations>(), baseFS);
+#else
+    return new ClangTool(*compilations, sources);
+#endif
+}
+
+/**
+ * Gives a tool the contents of the cached files so it doesn't read
+ * them from disk again.
+ * @param tool The tool.
+ * @param held Keeps the contents alive until the tool is done.
+ */
+void ClangDriver::mapCachedFiles(ClangTool* tool, vector<shared_ptr<const string>>* held){
+    lock_guard<mutex> guard(fileCacheLock);
+    if (!fileCache) return;
+
+    for (auto const& entry : cachedFiles){
+        tool->mapVirtualFile(entry.first, *entry.second.content);
+        held->push_back(entry.second.content);
+    }
+}
+
+/**
+ * Adds the headers that files included to the file cache. Headers are
+ * read once and the cache stops growing at its size limit.
+ * @param includes The headers each file included.
+ */
+void ClangDriver::cacheFiles(const map<string, set<string>>& includes){
+    {
+        lock_guard<mutex> guard(fileCacheLock);
+        if (!fileCache || fileCacheSize >= FILE_CACHE_LIMIT) return;
+    }
+
+    for (auto const& entry : includes){
+        for (string header : entry.second){
+            {
+                lock_guard<mutex> guard(fileCacheLock);
+                if (cachedFiles.find(header) != cachedFiles.end()) continue;
+            }
+
+            //Reads the header.
+            boost::system::error_code error;
+            CachedFile cur;
+            cur.modified = last_write_time(header, error);
+            if (!error) cur.size = file_size(header, error);
+            if (error) continue;
+
+            std::ifstream file(header, std::ios::binary);
+            stringstream content;
+            content << file.rdbuf();
+            if (!file.good() || content.str().size() != cur.size) continue;
+            cur.content = make_shared<const string>(content.str());
+
+            lock_guard<mutex> guard(fileCacheLock);
+            if (!fileCache || fileCacheSize + cur.size > FILE_CACHE_LIMIT) return;
+            if (cachedFiles.insert(make_pair(header, cur)).second) fileCacheSize += cur.size;
+        }
+    }
+}
+
+/**
+ * Drops cached files that changed on disk since they were read.
+ */
+void ClangDriver::revalidateFileCache(){
+    lock_guard<mutex> guard(fileCacheLock);
+    for (auto it = cachedFiles.begin(); it != cachedFiles.end();){
+        boost::system::error_code error;
+        time_t modified = last_write_time(it->first, error);
+        uintmax_t size = (error) ? 0 : file_size(it->first, error);
+        if (error || modified != it->second.modified || size != it->second.size) {
+            fileCacheSize -= it->second.size;
+            it = cachedFiles.erase(it);
+        } else {
+            it++;
+        }
+    }
+}
+
+/**
+ * Runs ClangEx on each file in the queue on its own and writes
+ * every result to a fragment. Fragments are not resolved and can be
+ * combined later with linkFragments. Files are run on a pool of
+ * workers, longest first based on the times from earlier runs, and
+ * only a few files that used a lot of memory before run at once.
+ * Before Clang 8, each file is compiled in its own process since the
+ * tools change the working directory of the whole process. The headers
+ * each file includes are kept in an index next to the fragments. Files
+ * whose fragment is newer than the file and its headers are skipped,
+ * so an interrupted run picks up where it stopped.
+ * @param blobMode Whether blob mode is enabled.
+ * @param fragmentDir The directory to write the fragments to.
+ * @param jobs The number of files processed at once.
+ * @param heavyLimit The number of memory heavy files processed at once.
+ * @return Whether every fragment was written.
+ */
+bool ClangDriver::generateFragments(bool blobMode, string fragmentDir, int jobs, int heavyLimit){
+    path dirPath = fragmentDir;
+    if (!exists(dirPath)) create_directories(dirPath);
+    if (!is_directory(dirPath)){
+        cerr << "Error: The fragment location " << fragmentDir << " must be a directory." << endl;
+        return false;
+    }
+    fragmentDir = absolute(dirPath).string();
+
+    CompilationDatabase* compilations = getCompilations();
+    compileErrors = false;
+    revalidateFileCache();
+
+    //Sets up the printer.
+    Printer* clangPrint = new Printer();
+    TAGraph::ClangExclude exclude = toggle;
+
+    if (jobs < 1) jobs = 1;
+    if (heavyLimit < 1) heavyLimit = max(1, jobs / 2);
+
+    //Orders the files by their cost in earlier runs.
+    StatsStore store(getStatsFile(fragmentDir));
+    store.load();
+    vector<string> names;
+    vector<char> heavy;
+    for (path curFile : files) {
+        names.push_back(absolute(curFile).string());
+        heavy.push_back(store.isHeavy(names.back()));
+    }
+    vector<int> order = store.orderByCost(names);
+    DepsIndex deps(fragmentDir + "/" + DepsIndex::DEPS_FILE);
+    deps.load();
+    deque<int> queue;
+    for (int i : order) {
+        if (!isFragmentCurrent(getFragmentName(fragmentDir, files.at(i)), files.at(i), &deps)) queue.push_back(i);
+    }
+
+    //Each worker takes the next file that it's allowed to run.
+    bool success = true;
+    int heavyRunning = 0;
+    mutex queueLock;
+    condition_variable queueReady;
+    auto worker = [&] {
+        unique_lock<mutex> guard(queueLock);
+        while (queue.size() > 0) {
+            auto next = queue.begin();
+            while (next != queue.end() && heavy.at(*next) && heavyRunning >= heavyLimit) next++;
+            if (next == queue.end()) {
+                queueReady.wait(guard);
+                continue;
+            }
+
+            int i = *next;
+            queue.erase(next);
+            if (heavy.at(i)) heavyRunning++;
+            guard.unlock();
+
+            StatsStore::TUStats stats;
+            map<string, set<string>> includes;
+#if CLANG_VERSION_MAJOR < 8
+            bool succ = processFragmentInProcess(blobMode, fragmentDir, i, clangPrint, exclude, compilations, &stats,
+                                                 &includes);
+#else
+            bool succ = processFragment(blobMode, fragmentDir, i, clangPrint, exclude, compilations, &stats,
+                                        &includes);
+#endif
+            cacheFiles(includes);
+
+            guard.lock();
+            if (heavy.at(i)) heavyRunning--;
+            if (!succ) success = false;
+            store.setStats(names.at(i), stats);
+            for (auto const& entry : includes) deps.setIncludes(entry.first, entry.second);
+            queueReady.notify_all();
+        }
+    };
+
+    clangPrint->printProcessStatus(Printer::COMPILING);
+    vector<thread> workers;
+    for (int i = 0; i < jobs; i++) workers.push_back(thread(worker));
+    for (auto& cur : workers) cur.join();
+
+    if (!store.save()) cerr << "Warning: The file statistics could not be saved." << endl;
+    if (!deps.save()) cerr << "Warning: The include index could not be saved." << endl;
+
+    //Clears the queue.
+    files.clear();
+
+    delete clangPrint;
+    return success;
+}
+
+/**
+ * Links fragments into a single graph. Fragments are read in parallel
+ * and merged in order, so the same fragments always give the same graph.
+ * @param sources The fragment files or directories of fragments.
+ * @param jobs The number of fragments read at once.
+ * @return Whether the graph was linked.
+ */
+bool ClangDriver::linkFragments(vector<string> sources, int jobs){
+    if (jobs < 1) jobs = 1;
+
+    //Gets the fragments.
+    vector<string> fragments;
+    for (string source : sources){
+        vector<string> found = findFragments(source);
+        if (found.size() == 0) cerr << "Warning: No fragments were found in " << source << "." << endl;
+        fragments.insert(fragments.end(), found.begin(), found.end());
+    }
+    if (fragments.size() == 0){
+        cerr << "Error: There are no fragments to link." << endl;
+        return false;
+    }
+
+    //Reads and merges the fragments.
+    TAGraph* linkGraph = new TAGraph();
+    bool success = readFragments(fragments, jobs, [&](int i, TAGraph* fragment) {
+        linkGraph->linkGraph(fragment);
+    });
+    if (!success){
+        delete linkGraph;
+        return false;
+    }
+
+    //Resolves the combined graph.
+    resolveGraph(linkGraph);
+    graphs.push_back(linkGraph);
+
+    return true;
+}
+
+/**
+ * Reads fragments in parallel and hands them over in order, so the same
+ * fragments are always merged the same way. Reading stops at the first
+ * fragment that can't be read.
+ * @param fragments The fragment files.
+ * @param jobs The number of fragments read at once.
+ * @param link Takes the number and graph of each fragment. The graph is deleted afterwards.
+ * @return Whether every fragment was read.
+ */
+bool ClangDriver::readFragments(const vector<string>& fragments, int jobs,
+                                const function<void(int, TAGraph*)>& link){
+    if (jobs < 1) jobs = 1;
+    Printer* clangPrint = new Printer();
+
+    //Reads the fragments in batches.
+    bool success = true;
+    for (int start = 0; start < fragments.size() && success; start += jobs){
+        int end = min(start + jobs, (int) fragments.size());
+
+        vector<TAGraph*> parsed;
+        vector<char> results(end - start, 0);
+        vector<thread> workers;
+        for (int i = start; i < end; i++) parsed.push_back(new TAGraph());
+        for (int i = start; i < end; i++){
+            workers.push_back(thread([&, i] {
+                results.at(i - start) = parsed.at(i - start)->loadFragment(fragments.at(i), clangPrint);
+            }));
+        }
+        for (auto& worker : workers) worker.join();
+
+        //Merges the batch in order.
+        for (int i = start; i < end; i++){
+            TAGraph* fragment = parsed.at(i - start);
+            if (success && !results.at(i - start)){
+                cerr << "Error: The fragment " << fragments.at(i) << " could not be read." << endl;
+                success = false;
+            }
+
+            if (success) link(i, fragment);
+            delete fragment;
+        }
+    }
+
+    delete clangPrint;
+    return success;
+}
+
+/**
+ * Resolves a graph that was linked from fragments using the enabled
+ * language features.
+ * @param graph The graph to resolve.
+ */
+void ClangDriver::resolveGraph(TAGraph* graph){
+    Printer* clangPrint = new Printer();
+    resolveGraph(graph, clangPrint, toggle);
+    delete clangPrint;
+}
+
+/**
+ * Gets the compilation database for the queued files. A loaded project
+ * database is used first. Otherwise, one is detected from the first file
+ * and kept until the files move to a different directory.
+ * @return The compilation database.
+ */
+CompilationDatabase* ClangDriver::getCompilations(){
+    if (projectDB != nullptr) return projectDB;
+
+    //Checks whether the last database still applies.
+    string firstFile = (files.size() > 0) ? absolute(files.at(0)).string() : "";
+    string root = path(firstFile).parent_path().string();
+    if (detectedDB != nullptr && root.compare(detectedRoot) == 0) return detectedDB;
+
+    delete detectedDB;
+    detectedRoot = root;
+
+    //Detects the database.
+    string error;
+    unique_ptr<CompilationDatabase> db;
+    if (firstFile.compare("") != 0) db = CompilationDatabase::autoDetectFromSource(firstFile, error);
+    if (db) {
+        detectedDB = db.release();
+    } else {
+        cerr << "Warning: No compilation database was found. Running without flags." << endl;
+        detectedDB = new FixedCompilationDatabase(".", vector<string>());
+    }
+
+    return detectedDB;
+}
+
 /**
  * Recovers a low memory run. Only resolves.
  * @param startDir The starting directory.
@@ -369,9 +901,8 @@ bool ClangDriver::recoverCompact(string startDir){
 
     //Now, we iterate and compact each graph.
     for (int gNum : graphNums){
-        TAGraph* cur = new LowMemoryTAGraph(startDir, gNum);
-        cur->resolveExternalReferences(clangPrint, false);
-        cur->resolveFiles(toggle);
+        TAGraph* cur = new LowMemoryTAGraph(startDir, gNum, lowMemoryConfig);
+        resolveGraph(cur, clangPrint, toggle);
         graphs.push_back(cur);
     }
 
@@ -399,36 +930,51 @@ bool ClangDriver::recoverFull(string startDir){
 
     vector<string> ldFiles;
     bool blobMode;
+    bool ldUSRMode;
     TAGraph::ClangExclude ldExclude;
 
     for (int gNum : graphNums){
         bool succ = readSettings(startDir + "/" + to_string(gNum) + "-" + LowMemoryTAGraph::CUR_SETTING_LOC, &ldFiles,
-                                 &blobMode, &ldExclude);
+                                 &blobMode, &ldExclude, &ldUSRMode);
         if (!succ) {
             cerr << "Recovery Error: Settings could not be read for this file." << endl;
             return false;
         }
 
-        int startNum = readStartNum(startDir + "/" + to_string(gNum) + "-" + LowMemoryTAGraph::CUR_FILE_LOC);
+        //Rolls back to the last committed file. Only runs from before the journal use the file marker.
+        LowMemoryTAGraph* graph = new LowMemoryTAGraph(startDir, gNum, lowMemoryConfig);
+        int startNum = graph->recoverJournal();
+        if (startNum == LowMemoryTAGraph::JOURNAL_FAILED) {
+            //The graph isn't deleted since that would remove its spill files.
+            cerr << "Recovery Error: Graph " << gNum << " could not be rolled back to its journal." << endl;
+            return false;
+        } else if (startNum == LowMemoryTAGraph::JOURNAL_MISSING) {
+            startNum = readStartNum(startDir + "/" + to_string(gNum) + "-" + LowMemoryTAGraph::CUR_FILE_LOC);
+        }
 
         vector<path> oldFiles = files;
         TAGraph::ClangExclude oldExclude = toggle;
+        bool oldUSRMode = usrMode;
 
         //Sets up the file system.
         recoveryMode = true;
+        recoveryGraph = graph;
         auto tempLowMem = lowMemoryPath;
         lowMemoryPath = startDir;
         files.clear();
         for (string curFile : ldFiles) files.push_back(path(curFile));
         toggle = ldExclude;
+        usrMode = ldUSRMode;
 
         bool code = processAllFiles(blobMode, "", true, startNum);
 
         //Restores the system.
         recoveryMode = false;
+        recoveryGraph = nullptr;
         lowMemoryPath = tempLowMem;
         files = oldFiles;
         toggle = oldExclude;
+        usrMode = oldUSRMode;
 
         if (!code) {
             cerr << "Recovery Error: System could not process the current graph." << endl;
@@ -438,6 +984,14 @@ bool ClangDriver::recoverFull(string startDir){
     return true;
 }
 
+/**
+ * Checks whether any file failed to compile in the last run.
+ * @return Whether there were compilation errors.
+ */
+bool ClangDriver::hadCompileErrors(){
+    return compileErrors;
+}
+
 /**
  * Outputs an individual TA model to TA format.
  * @param modelNum The number of the model to output.
@@ -461,6 +1015,20 @@ bool ClangDriver::outputIndividualModel(int modelNum, string fileName){
     return true;
 }
 
+/**
+ * Streams an individual TA model to a descriptor and removes it.
+ * @param modelNum The number of the model to output.
+ * @param fd The descriptor to write to.
+ * @return Boolean indicating success.
+ */
+bool ClangDriver::outputModelStream(int modelNum, int fd){
+    if (modelNum < 0 || modelNum > getNumGraphs() - 1) return false;
+
+    bool succ = graphs.at(modelNum)->writeTAStream(fd);
+    deleteTAGraph(modelNum);
+    return succ;
+}
+
 /**
  * Outputs all models generated based on a file name.
  * @param baseFileName The base file name to output on.
@@ -542,6 +1110,51 @@ int ClangDriver::removeByRegex(string regex) {
     return num;
 }
 
+/**
+ * Adds the files from a compilation database to the queue. Each file
+ * is then compiled with its own flags from the database. Loading a new
+ * database replaces the last one.
+ * @param location The compile_commands.json file or its directory.
+ * @param includes Regular expressions for the files to keep.
+ * @param excludes Regular expressions for the files to drop.
+ * @return The number of files added or -1 if the database couldn't be used.
+ */
+int ClangDriver::addByCompilationDatabase(string location, vector<string> includes, vector<string> excludes){
+    string error;
+    ProjectDatabase* db = ProjectDatabase::loadFromPath(location, &error);
+    if (db == nullptr){
+        cerr << "Error: The compilation database could not be loaded." << endl << error << endl;
+        return -1;
+    }
+
+    //Sets up the filters.
+    string curRegex;
+    try {
+        for (string cur : includes) db->addFilter(curRegex = cur, true);
+        for (string cur : excludes) db->addFilter(curRegex = cur, false);
+    } catch (std::regex_error& e) {
+        cerr << "Error: The filter " << curRegex << " is not a valid regular expression." << endl;
+        delete db;
+        return -1;
+    }
+
+    //Skips files that are already queued.
+    unordered_set<string> queued;
+    for (path curFile : files) queued.insert(absolute(curFile).string());
+
+    int num = 0;
+    for (string curFile : db->getFiles()){
+        if (!queued.insert(absolute(curFile).string()).second) continue;
+        num += addFile(curFile);
+    }
+
+    delete projectDB;
+    projectDB = db;
+    path root = absolute(location);
+    projectRoot = (is_directory(root)) ? root.string() : root.parent_path().string();
+    return num;
+}
+
 /**
  * Changes the location of the low memory mode output.
  * @param curLoc The location to change to.
@@ -562,9 +1175,13 @@ bool ClangDriver::changeLowMemoryLoc(path curLoc){
             string dstRoot = curLoc.string() + "/" + to_string(cur) + "-";
             rename(srcRoot + LowMemoryTAGraph::CUR_SETTING_LOC, dstRoot + LowMemoryTAGraph::CUR_SETTING_LOC);
             rename(srcRoot + LowMemoryTAGraph::CUR_FILE_LOC, dstRoot + LowMemoryTAGraph::CUR_FILE_LOC);
+            rename(srcRoot + LowMemoryTAGraph::CUR_JOURNAL_LOC, dstRoot + LowMemoryTAGraph::CUR_JOURNAL_LOC);
             rename(srcRoot + LowMemoryTAGraph::BASE_INSTANCE_FN, dstRoot + LowMemoryTAGraph::BASE_INSTANCE_FN);
             rename(srcRoot + LowMemoryTAGraph::BASE_RELATION_FN, dstRoot + LowMemoryTAGraph::BASE_RELATION_FN);
             rename(srcRoot + LowMemoryTAGraph::BASE_ATTRIBUTE_FN, dstRoot + LowMemoryTAGraph::BASE_ATTRIBUTE_FN);
+            if (exists(srcRoot + LowMemoryTAGraph::BASE_INDEX_FN)) {
+                rename(srcRoot + LowMemoryTAGraph::BASE_INDEX_FN, dstRoot + LowMemoryTAGraph::BASE_INDEX_FN);
+            }
 
             static_cast<LowMemoryTAGraph*>(graphs.at(cur))->changeRoot(curLoc.string());
         }
@@ -574,6 +1191,93 @@ bool ClangDriver::changeLowMemoryLoc(path curLoc){
     return true;
 }
 
+/**
+ * Sets the settings used by new low memory graphs.
+ * @param config The low memory settings.
+ */
+void ClangDriver::setLowMemoryConfig(LowMemoryTAGraph::LowMemoryConfig config){
+    lowMemoryConfig = config;
+}
+
+/**
+ * Sets whether entities are identified by their Clang USR.
+ * @param enabled Whether USR IDs are used.
+ */
+void ClangDriver::setUSRMode(bool enabled){
+    usrMode = enabled;
+}
+
+/**
+ * Sets the filter for the files that facts are extracted from.
+ * @param filter The path filter.
+ */
+void ClangDriver::setPathFilter(PathFilter filter){
+    pathFilter = filter;
+}
+
+/**
+ * Sets where the statistics of earlier runs are kept.
+ * @param location The statistics file or the directory to keep it in.
+ */
+void ClangDriver::setStatsLocation(string location){
+    statsLocation = location;
+}
+
+/**
+ * Sets whether only declarations are extracted. Function bodies are
+ * skipped so calls and references aren't found.
+ * @param enabled Whether function bodies are skipped.
+ */
+void ClangDriver::setDeclsOnly(bool enabled){
+    declsOnly = enabled;
+}
+
+/**
+ * Sets whether the contents of included headers are kept between runs.
+ * Headers that many files include are then only read from disk once.
+ * Cached files that changed on disk are dropped before each run.
+ * @param enabled Whether header contents are kept.
+ */
+void ClangDriver::setFileCache(bool enabled){
+    lock_guard<mutex> guard(fileCacheLock);
+    fileCache = enabled;
+    if (enabled) return;
+
+    cachedFiles.clear();
+    fileCacheSize = 0;
+}
+
+/**
+ * Drops files from the file cache so they're read from disk again.
+ * @param changed The files that changed.
+ */
+void ClangDriver::invalidateFiles(const vector<string>& changed){
+    lock_guard<mutex> guard(fileCacheLock);
+    for (string file : changed){
+        auto it = cachedFiles.find(file);
+        if (it == cachedFiles.end()) continue;
+
+        fileCacheSize -= it->second.size;
+        cachedFiles.erase(it);
+    }
+}
+
+/**
+ * Checks whether a file has a C/C++ source extension.
+ * @param file The file to check.
+ * @return Whether the file is a source file.
+ */
+bool ClangDriver::isSourceFile(path file){
+    string extFile = extension(file);
+
+    //Iterates through the extension vector.
+    for (int i = 0; i < ext.size(); i++){
+        if (extFile.compare(ext.at(i)) == 0) return true;
+    }
+
+    return false;
+}
+
 /**
  * Adds a file to the queue.
  * @param file The file to add.
@@ -595,20 +1299,14 @@ int ClangDriver::addDirectory(path directory){
     vector<path> interiorDir = vector<path>();
     directory_iterator endIter;
 
+    //Remembers the directory for watching.
+    if (find(directories.begin(), directories.end(), directory) == directories.end()) directories.push_back(directory);
+
     //Start by iterating through and inspecting each file.
     for (directory_iterator iter(directory); iter != endIter; iter++){
         //Check what the current file is.
         if (is_regular_file(iter->path())){
-            //Check the extension.
-            string extFile = extension(iter->path());
-
-            //Iterates through the extension vector.
-            for (int i = 0; i < ext.size(); i++){
-                //Checks the file.
-                if (extFile.compare(ext.at(i)) == 0){
-                    numAdded += addFile(iter->path());
-                }
-            }
+            if (isSourceFile(iter->path())) numAdded += addFile(iter->path());
         } else if (is_directory(iter->path())){
             //Add the directory to the search system.
             interiorDir.push_back(iter->path());
@@ -759,22 +1457,8 @@ vector<string> ClangDriver::getDisabled(){
  * @return Success or failure of the output.
  */
 bool ClangDriver::outputTAString(int modelNum, string fileName){
-    //First, runs the graph builder process.
-    string tupleAttribute = graphs.at(modelNum)->generateTAFormat();
-
-    //Next, writes to disk.
-    std::ofstream taFile;
-    taFile.open(fileName.c_str());
-
-    //Check if the file is opened.
-    if (!taFile.is_open()){
-        return false;
-    }
-
-    taFile << tupleAttribute;
-    taFile.close();
-
-    return true;
+    //Streams the graph straight to disk.
+    return graphs.at(modelNum)->writeTAFile(fileName);
 }
 
 /**
@@ -792,6 +1476,187 @@ void ClangDriver::deleteTAGraph(int modelNum){
     delete curGraph;
 }
 
+/**
+ * Resolves references and files in a finished graph.
+ * @param graph The graph to resolve.
+ * @param clangPrint System to print messages.
+ * @param exclude Items to exclude.
+ */
+void ClangDriver::resolveGraph(TAGraph* graph, Printer* clangPrint, TAGraph::ClangExclude exclude){
+    Metrics::Timer timer(Metrics::RESOLVE);
+    graph->resolveExternalReferences(clangPrint, false);
+    graph->resolveFiles(exclude);
+}
+
+/**
+ * Runs ClangEx on a single file and writes its fragment.
+ * @param blobMode Whether blob mode is enabled.
+ * @param fragmentDir The directory to write the fragment to.
+ * @param i The file to process.
+ * @param clangPrint System to print messages.
+ * @param exclude Items to exclude.
+ * @param compilations The compile commands for each file.
+ * @param stats The statistics of the file.
+ * @param includes Where the headers the file includes are collected.
+ * @return Whether the fragment was written.
+ */
+bool ClangDriver::processFragment(bool blobMode, string fragmentDir, int i, Printer* clangPrint,
+                                  TAGraph::ClangExclude exclude, CompilationDatabase* compilations,
+                                  StatsStore::TUStats* stats, map<string, set<string>>* includes){
+    TAGraph* fragment = new TAGraph();
+
+    //Times the analysis.
+    auto start = chrono::steady_clock::now();
+    runAnalysis(blobMode, false, fragment, i, clangPrint, exclude, compilations, true, &stats->memory, includes);
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+    stats->seconds = elapsed.count();
+    stats->facts = fragment->getNodes().size() + fragment->getEdges().size();
+
+    //Writes the fragment.
+    string fragmentFile = getFragmentName(fragmentDir, files.at(i));
+    bool succ = fragment->writeFragment(fragmentFile);
+    if (!succ) cerr << "Error: The fragment " << fragmentFile << " could not be written." << endl;
+
+    delete fragment;
+    return succ;
+}
+
+/**
+ * Runs processFragment in a child process. The statistics come back on
+ * the first line, followed by an "F" line for each file with a "D" line
+ * for each header it includes.
+ * @param blobMode Whether blob mode is enabled.
+ * @param fragmentDir The directory to write the fragment to.
+ * @param i The file to process.
+ * @param clangPrint System to print messages.
+ * @param exclude Items to exclude.
+ * @param compilations The compile commands for each file.
+ * @param stats The statistics of the file.
+ * @param includes Where the headers the file includes are collected.
+ * @return Whether the fragment was written.
+ */
+bool ClangDriver::processFragmentInProcess(bool blobMode, string fragmentDir, int i, Printer* clangPrint,
+                                           TAGraph::ClangExclude exclude, CompilationDatabase* compilations,
+                                           StatsStore::TUStats* stats, map<string, set<string>>* includes){
+    string result;
+    bool succ = runInProcess([&](string* output) {
+        bool written = processFragment(blobMode, fragmentDir, i, clangPrint, exclude, compilations, stats,
+                                       includes);
+
+        stringstream ss;
+        ss << stats->seconds << "\t" << stats->memory << "\t" << stats->facts << "\t" << compileErrors << "\n";
+        for (auto const& entry : *includes){
+            ss << "F" << entry.first << "\n";
+            for (string header : entry.second) ss << "D" << header << "\n";
+        }
+        *output = ss.str();
+        return written;
+    }, &result);
+    if (!succ) cerr << "Error: " << files.at(i).string() << " could not be processed." << endl;
+
+    //Reads back the statistics and the headers.
+    stringstream ss(result);
+    string line;
+    bool errors = false;
+    if (getline(ss, line)) {
+        stringstream first(line);
+        first >> stats->seconds >> stats->memory >> stats->facts >> errors;
+    }
+    if (errors || !succ) compileErrors = true;
+
+    set<string>* headers = nullptr;
+    while (getline(ss, line)){
+        if (line.size() == 0) continue;
+        if (line.at(0) == 'F') headers = &(*includes)[line.substr(1)];
+        else if (line.at(0) == 'D' && headers != nullptr) headers->insert(line.substr(1));
+    }
+
+    return succ;
+}
+
+/**
+ * Gets the file that keeps the statistics of earlier runs. It's kept
+ * where it was set, next to the loaded compilation database, or with
+ * the fragments otherwise.
+ * @param fragmentDir The directory of fragments.
+ * @return The statistics file.
+ */
+string ClangDriver::getStatsFile(string fragmentDir){
+    if (statsLocation.compare("") != 0) {
+        if (is_directory(statsLocation)) return (path(statsLocation) / StatsStore::STATS_FILE).string();
+        return statsLocation;
+    }
+    if (projectRoot.compare("") != 0) return (path(projectRoot) / StatsStore::STATS_FILE).string();
+    return fragmentDir + "/" + StatsStore::STATS_FILE;
+}
+
+/**
+ * Gets the fragment file for a source file. The name includes a hash of
+ * the full path so files with the same name don't collide.
+ * @param fragmentDir The directory of fragments.
+ * @param file The source file.
+ * @return The fragment file name.
+ */
+string ClangDriver::getFragmentName(string fragmentDir, path file){
+    string hash = ASTWalker::generateMD5(absolute(file).string()).substr(0, FRAGMENT_HASH_LEN);
+    return fragmentDir + "/" + file.filename().string() + "-" + hash + DEFAULT_EXT;
+}
+
+/**
+ * Checks whether a fragment is complete and newer than its file and
+ * every header in the include index. Files missing from the index are
+ * never current since their headers aren't known.
+ * @param fragmentFile The fragment file.
+ * @param file The source file.
+ * @param deps The include index.
+ * @return Whether the fragment can be kept.
+ */
+bool ClangDriver::isFragmentCurrent(string fragmentFile, path file, DepsIndex* deps){
+    struct stat fragmentStat;
+    if (stat(fragmentFile.c_str(), &fragmentStat) != 0) return false;
+    if (!exists(path(fragmentFile + TAGraph::PATHS_EXT))) return false;
+
+    boost::system::error_code error;
+    path canonPath = canonical(file, error);
+    if (error) return false;
+    set<string> sources;
+    if (!deps->getIncludes(canonPath.string(), &sources)) return false;
+    sources.insert(canonPath.string());
+
+    //Anything modified at or after the fragment makes it stale.
+    for (string source : sources) {
+        struct stat sourceStat;
+        if (stat(source.c_str(), &sourceStat) != 0) return false;
+        if (sourceStat.st_mtim.tv_sec > fragmentStat.st_mtim.tv_sec) return false;
+        if (sourceStat.st_mtim.tv_sec == fragmentStat.st_mtim.tv_sec &&
+                sourceStat.st_mtim.tv_nsec >= fragmentStat.st_mtim.tv_nsec) return false;
+    }
+
+    return true;
+}
+
+/**
+ * Gets the fragments at a location. Directories are searched for TA
+ * files and the results are sorted so links are repeatable.
+ * @param source The fragment or directory of fragments.
+ * @return The list of fragment files.
+ */
+vector<string> ClangDriver::findFragments(path source){
+    vector<string> results;
+    if (!is_directory(source)){
+        if (exists(source)) results.push_back(source.string());
+        return results;
+    }
+
+    directory_iterator it(source), eod;
+    BOOST_FOREACH(path const &cur, std::make_pair(it, eod)){
+        if (is_regular_file(cur) && extension(cur) == DEFAULT_EXT) results.push_back(cur.string());
+    }
+    sort(results.begin(), results.end());
+
+    return results;
+}
+
 /**
  * Gets the number for all the low memory graphs in the file.
  * @param startDir The start directory to look in.
@@ -838,10 +1703,11 @@ vector<int> ClangDriver::getLMGraphs(string startDir){
  * @param files The files in the setting.
  * @param blobMode The blob mode toggle in the settings.
  * @param exclude The exclusions in the settings.
+ * @param usrMode The USR ID toggle in the settings.
  * @return Whether the read was successful.
  */
 bool ClangDriver::readSettings(string loc, vector<string>* files, bool* blobMode,
-                               TAGraph::ClangExclude* exclude){
+                               TAGraph::ClangExclude* exclude, bool* usrMode){
     std::ifstream settingFile(loc);
     if (!settingFile.is_open()) return false;
 
@@ -871,6 +1737,9 @@ bool ClangDriver::readSettings(string loc, vector<string>* files, bool* blobMode
 
     //Gets blob mode.
     if (sstream.get() == '1') *blobMode = true;
+
+    //Gets the ID mode. Older settings don't have it.
+    *usrMode = (sstream.get() == '1');
     return true;
 }
 
@@ -912,37 +1781,6 @@ int ClangDriver::extractIntegerWords(string str) {
     return -1;
 }
 
-/**
- * Generates an argv array based on the files in the queue and Clang's input format.
- * @param argc The number of tokens.
- * @return The new argv command.
- */
-char** ClangDriver::prepareArgs(int *argc, int startVal, int finalVal){
-    int size = BASE_LEN + (finalVal - startVal);
-
-    //Sets argc.
-    *argc = size;
-
-    //Next, argv.
-    char** argv = new char*[size];
-
-    //Copies the base start.
-    argv[0] = new char[DEFAULT_START.size() + 1];
-    argv[1] = new char[INCLUDE_DIR_LOC.size() + 1];
-
-    //Next, moves them over.
-    strcpy(argv[0], DEFAULT_START.c_str());
-    strcpy(argv[1], INCLUDE_DIR_LOC.c_str());
-
-    //Next, loops through the files and copies.
-    for (int i = 0, filePos = startVal; filePos < finalVal; i++, filePos++){
-        argv[i + BASE_LEN] = new char[files.at(filePos).string().size() + 1];
-        strcpy(argv[i + BASE_LEN], files.at(filePos).c_str());
-    }
-
-    return argv;
-}
-
 /**
  * Splits by a comma delimiter.
  * @param list The initial string.
@@ -27,11 +27,26 @@
 #ifndef CLANGEX_CLANGDRIVER_H
 #define CLANGEX_CLANGDRIVER_H
 
+#include <map>
+#include <set>
+#include <mutex>
+#include <atomic>
+#include <ctime>
+#include <memory>
+#include <functional>
 #include <vector>
 #include <string>
+#include <unordered_map>
 #include <boost/filesystem.hpp>
-#include "clang/Tooling/CommonOptionsParser.h"
+#include "clang/Tooling/Tooling.h"
+#include "clang/Basic/FileManager.h"
+#include "clang/Basic/Version.h"
+#include "ProjectDatabase.h"
+#include "StatsStore.h"
+#include "DepsIndex.h"
+#include "../File/PathFilter.h"
 #include "../Graph/TAGraph.h"
+#include "../Graph/LowMemoryTAGraph.h"
 
 using namespace boost::filesystem;
 
@@ -51,45 +66,102 @@ public:
     /** Counters */
     int getNumGraphs();
     int getNumFiles();
+    std::vector<path> getFiles();
+    std::vector<path> getDirectories();
 
     /** Enable/Disable Features */
     bool enableFeature(std::string feature);
     bool disableFeature(std::string feature);
 
     /** ClangEx Runner */
-    bool processAllFiles(bool blobMode, std::string mergeFile, bool lowMemory, int startNum = 0);
+    bool processAllFiles(bool blobMode, std::string mergeFile, bool lowMemory, int startNum = 0, int jobs = 1);
     bool recoverCompact(std::string startDir);
     bool recoverFull(std::string startDir);
+    bool hadCompileErrors();
+
+    /** Fragment System */
+    bool generateFragments(bool blobMode, std::string fragmentDir, int jobs = 1, int heavyLimit = 0);
+    bool linkFragments(std::vector<std::string> sources, int jobs);
+    bool readFragments(const std::vector<std::string>& fragments, int jobs,
+                       const std::function<void(int, TAGraph*)>& link);
+    void resolveGraph(TAGraph* graph);
+    std::string getFragmentName(std::string fragmentDir, path file);
 
     /** Output Helpers */
     bool outputIndividualModel(int modelNum, std::string fileName = std::string());
     bool outputAllModels(std::string baseFileName);
+    bool outputModelStream(int modelNum, int fd);
 
     /** Add/Remove By Path */
     int addByPath(path curPath);
     int removeByPath(path curPath);
     int removeByRegex(std::string regex);
+    int addByCompilationDatabase(std::string location, std::vector<std::string> includes,
+                                 std::vector<std::string> excludes);
+    bool isSourceFile(path file);
 
     /** Low Memory System */
     bool changeLowMemoryLoc(path curLoc);
+    void setLowMemoryConfig(LowMemoryTAGraph::LowMemoryConfig config);
+
+    /** ID System */
+    void setUSRMode(bool enabled);
+
+    /** Filter System */
+    void setPathFilter(PathFilter filter);
+    void setDeclsOnly(bool enabled);
+
+    /** Statistics System */
+    void setStatsLocation(std::string location);
+
+    /** File Cache System */
+    void setFileCache(bool enabled);
+    void invalidateFiles(const std::vector<std::string>& changed);
 
 private:
+    /** Cached File Contents */
+    typedef struct {
+        std::shared_ptr<const std::string> content;
+        std::time_t modified;
+        uintmax_t size;
+    } CachedFile;
+
     /** Default Arguments */
     const std::string INSTANCE_FLAG = "$INSTANCE";
     const std::string DEFAULT_EXT = ".ta";
     const std::string DEFAULT_FILENAME = "out";
-    const std::string DEFAULT_START = "./ClangEx";
     const std::string INCLUDE_DIR = "./include";
-    const std::string INCLUDE_DIR_LOC = "--extra-arg=-I" + INCLUDE_DIR;
-    const int BASE_LEN = 2;
+    const std::string INCLUDE_ARG = "-I" + INCLUDE_DIR;
     const int FILE_SPLIT = 1;
+    const int FRAGMENT_HASH_LEN = 8;
+    const size_t FILE_CACHE_LIMIT = (size_t) 256 << 20;
 
     /** Private Variables */
     std::vector<TAGraph*> graphs;
     std::vector<path> files;
+    std::vector<path> directories;
     std::vector<std::string> ext;
     path lowMemoryPath = "";
+    LowMemoryTAGraph::LowMemoryConfig lowMemoryConfig;
     bool recoveryMode = false;
+    LowMemoryTAGraph* recoveryGraph = nullptr;
+    bool usrMode = false;
+    PathFilter pathFilter;
+    bool declsOnly = false;
+    std::string statsLocation;
+    std::atomic<bool> compileErrors{false};
+
+    /** File Cache Variables */
+    bool fileCache = false;
+    size_t fileCacheSize = 0;
+    std::mutex fileCacheLock;
+    std::unordered_map<std::string, CachedFile> cachedFiles;
+
+    /** Compilation Databases */
+    ProjectDatabase* projectDB = nullptr;
+    std::string projectRoot;
+    clang::tooling::CompilationDatabase* detectedDB = nullptr;
+    std::string detectedRoot;
 
     /** Toggle System */
     std::string langString = "\tcSubSystem\n\tcFile\n\tcClass\n\tcFunction\n\tcVariable\n\tcEnum\n\tcStruct\n\tcUnion\n";
@@ -107,7 +179,19 @@ private:
     int removeDirectory(path directory);
 
     bool runAnalysis(bool blobMode, bool lowMemory, TAGraph* mergeGraph, int i, Printer* clangPrint,
-                     TAGraph::ClangExclude exclude, clang::tooling::CommonOptionsParser* OptionsParser);
+                     TAGraph::ClangExclude exclude, clang::tooling::CompilationDatabase* compilations,
+                     bool singleFile = false, size_t* astMemory = nullptr,
+                     std::map<std::string, std::set<std::string>>* includes = nullptr);
+    bool runAnalysisInProcess(bool blobMode, TAGraph* mergeGraph, int i, Printer* clangPrint,
+                              TAGraph::ClangExclude exclude, clang::tooling::CompilationDatabase* compilations,
+                              std::string workDir);
+    bool runInProcess(const std::function<bool(std::string*)>& task, std::string* result);
+    clang::tooling::CompilationDatabase* getCompilations();
+    clang::tooling::ClangTool* createTool(clang::tooling::CompilationDatabase* compilations,
+                                          const std::vector<std::string>& sources);
+    void mapCachedFiles(clang::tooling::ClangTool* tool, std::vector<std::shared_ptr<const std::string>>* held);
+    void cacheFiles(const std::map<std::string, std::set<std::string>>& includes);
+    void revalidateFileCache();
 
     /** Enabled Strings */
     std::vector<std::string> getEnabled();
@@ -116,16 +200,27 @@ private:
     /** Output Helper Method */
     bool outputTAString(int modelNum, std::string fileName);
     void deleteTAGraph(int modelNum);
+    void resolveGraph(TAGraph* graph, Printer* clangPrint, TAGraph::ClangExclude exclude);
+
+    /** Fragment Helpers */
+    bool processFragment(bool blobMode, std::string fragmentDir, int i, Printer* clangPrint,
+                         TAGraph::ClangExclude exclude, clang::tooling::CompilationDatabase* compilations,
+                         StatsStore::TUStats* stats, std::map<std::string, std::set<std::string>>* includes);
+    bool processFragmentInProcess(bool blobMode, std::string fragmentDir, int i, Printer* clangPrint,
+                                  TAGraph::ClangExclude exclude, clang::tooling::CompilationDatabase* compilations,
+                                  StatsStore::TUStats* stats, std::map<std::string, std::set<std::string>>* includes);
+    std::vector<std::string> findFragments(path source);
+    std::string getStatsFile(std::string fragmentDir);
+    bool isFragmentCurrent(std::string fragmentFile, path file, DepsIndex* deps);
 
     /** Recovery Helper */
     std::vector<int> getLMGraphs(std::string startDir);
     bool readSettings(std::string file, std::vector<std::string>* files, bool* blobMode,
-                      TAGraph::ClangExclude* exclude);
+                      TAGraph::ClangExclude* exclude, bool* usrMode);
     int readStartNum(std::string file);
 
     /** Argument Helpers */
     int extractIntegerWords(std::string str);
-    char** prepareArgs(int *argc, int start, int final);
 
     /** Low Memory System */
     std::vector<std::string> splitList(std::string list);
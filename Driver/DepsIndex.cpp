@@ -0,0 +1,201 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// DepsIndex.cpp
+//
+// Created By: Bryan J Muscedere
+// Date: 19/10/26.
+//
+// Small on-disk index of the headers each translation unit includes.
+// It's stored by header so incremental runs can quickly find the
+// translation units that have to be extracted again after a change.
+//
+// Copyright (C) 2017, Bryan J. Muscedere
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#include "DepsIndex.h"
+
+using namespace std;
+
+/** Deps File Name */
+const string DepsIndex::DEPS_FILE = ".clangex-deps";
+
+/**
+ * Constructor. Doesn't read the index until load is called.
+ * @param fileName The file that holds the index.
+ */
+DepsIndex::DepsIndex(string fileName) {
+    this->fileName = fileName;
+}
+
+/**
+ * Destructor.
+ */
+DepsIndex::~DepsIndex() { }
+
+/**
+ * Reads the index from disk. The file starts with a table of every
+ * file followed by one line per header listing the numbers of the
+ * translation units that include it. Anything already in the index
+ * is replaced.
+ * @return Whether the index could be read.
+ */
+bool DepsIndex::load(){
+    includes.clear();
+    includers.clear();
+    std::ifstream depsFile(fileName);
+    if (!depsFile.is_open()) return false;
+
+    vector<string> table;
+    string line;
+    while (getline(depsFile, line)){
+        if (line.size() < 2) continue;
+
+        //Adds the file to the table.
+        if (line[0] == FILE_MARKER){
+            table.push_back(line.substr(2));
+            continue;
+        }
+        if (line[0] != DEPS_MARKER) continue;
+
+        //Adds the translation units of a header.
+        stringstream ss(line.substr(2));
+        size_t header, tu;
+        if (!(ss >> header) || header >= table.size()) continue;
+        while (ss >> tu){
+            if (tu >= table.size()) continue;
+            includers[table.at(header)].insert(table.at(tu));
+            includes[table.at(tu)].insert(table.at(header));
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Writes the index to disk. The file is replaced in one step so an
+ * interrupted run doesn't leave a partial index.
+ * @return Whether the index was written.
+ */
+bool DepsIndex::save(){
+    string tempName = fileName + ".tmp";
+    std::ofstream depsFile(tempName);
+    if (!depsFile.is_open()) return false;
+
+    //Numbers every file once.
+    unordered_map<string, size_t> numbers;
+    auto number = [&](const string& file) {
+        auto it = numbers.find(file);
+        if (it != numbers.end()) return it->second;
+
+        size_t num = numbers.size();
+        numbers[file] = num;
+        depsFile << FILE_MARKER << "\t" << file << "\n";
+        return num;
+    };
+    for (auto const& entry : includers){
+        if (entry.second.size() == 0) continue;
+        number(entry.first);
+        for (string tu : entry.second) number(tu);
+    }
+
+    //Writes the translation units of each header.
+    for (auto const& entry : includers){
+        if (entry.second.size() == 0) continue;
+        depsFile << DEPS_MARKER << "\t" << numbers[entry.first];
+        for (string tu : entry.second) depsFile << " " << numbers[tu];
+        depsFile << "\n";
+    }
+    depsFile.close();
+    if (depsFile.fail()) return false;
+
+    return rename(tempName.c_str(), fileName.c_str()) == 0;
+}
+
+/**
+ * Replaces the headers a translation unit includes.
+ * @param tu The translation unit.
+ * @param headers The headers it includes, directly or not.
+ */
+void DepsIndex::setIncludes(string tu, const set<string>& headers){
+    removeTU(tu);
+    if (headers.size() == 0) return;
+
+    includes[tu] = headers;
+    for (string header : headers) includers[header].insert(tu);
+}
+
+/**
+ * Gets the headers a translation unit includes.
+ * @param tu The translation unit.
+ * @param headers Where the headers are stored.
+ * @return Whether the translation unit is in the index.
+ */
+bool DepsIndex::getIncludes(string tu, set<string>* headers){
+    auto it = includes.find(tu);
+    if (it == includes.end()) return false;
+
+    *headers = it->second;
+    return true;
+}
+
+/**
+ * Forgets the headers a translation unit includes.
+ * @param tu The translation unit.
+ */
+void DepsIndex::removeTU(string tu){
+    auto it = includes.find(tu);
+    if (it == includes.end()) return;
+
+    for (string header : it->second){
+        auto users = includers.find(header);
+        if (users == includers.end()) continue;
+        users->second.erase(tu);
+        if (users->second.size() == 0) includers.erase(users);
+    }
+    includes.erase(it);
+}
+
+/**
+ * Gets the smallest set of translation units that have to be extracted
+ * again after files changed. Changed files that aren't included by
+ * anything are returned as they are.
+ * @param changed The files that changed.
+ * @return The dirty translation units.
+ */
+set<string> DepsIndex::getDirtyTUs(const vector<string>& changed){
+    set<string> dirty;
+    for (string file : changed){
+        //Files that are never included are translation units.
+        auto it = includers.find(file);
+        if (it == includers.end() || includes.find(file) != includes.end()) dirty.insert(file);
+        if (it != includers.end()) dirty.insert(it->second.begin(), it->second.end());
+    }
+
+    return dirty;
+}
+
+/**
+ * Gets every header in the index.
+ * @return The headers.
+ */
+vector<string> DepsIndex::getHeaders(){
+    vector<string> headers;
+    for (auto const& entry : includers) headers.push_back(entry.first);
+    return headers;
+}
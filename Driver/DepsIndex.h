@@ -0,0 +1,66 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// DepsIndex.h
+//
+// Created By: Bryan J Muscedere
+// Date: 19/10/26.
+//
+// Small on-disk index of the headers each translation unit includes.
+// It's stored by header so incremental runs can quickly find the
+// translation units that have to be extracted again after a change.
+//
+// Copyright (C) 2017, Bryan J. Muscedere
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CLANGEX_DEPSINDEX_H
+#define CLANGEX_DEPSINDEX_H
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+class DepsIndex {
+public:
+    /** Constructor/Destructor */
+    DepsIndex(std::string fileName);
+    ~DepsIndex();
+
+    /** Index Operations */
+    bool load();
+    bool save();
+
+    /** Dependency Operations */
+    void setIncludes(std::string tu, const std::set<std::string>& headers);
+    bool getIncludes(std::string tu, std::set<std::string>* headers);
+    void removeTU(std::string tu);
+    std::set<std::string> getDirtyTUs(const std::vector<std::string>& changed);
+    std::vector<std::string> getHeaders();
+
+    const static std::string DEPS_FILE;
+
+private:
+    /** Line Markers */
+    const static char FILE_MARKER = 'F';
+    const static char DEPS_MARKER = 'D';
+
+    /** Member Variables */
+    std::string fileName;
+    std::map<std::string, std::set<std::string>> includes;
+    std::map<std::string, std::set<std::string>> includers;
+};
+
+
+#endif //CLANGEX_DEPSINDEX_H
@@ -0,0 +1,742 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// ExtractServer.cpp
+//
+// Created By: Bryan J Muscedere
+// Date: 19/10/26.
+//
+// Extraction server that keeps a model resident and answers requests
+// over a Unix domain socket. Every file is extracted into its own
+// fragment so changed files can be re-extracted on their own. The
+// compilation database and the linked model stay loaded between requests.
+// In watch mode, saved files and the files that include them are
+// re-extracted as soon as they change.
+//
+// Copyright (C) 2017, Bryan J. Muscedere
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "ExtractServer.h"
+#include "../Walker/ASTWalker.h"
+
+using namespace std;
+using namespace boost::filesystem;
+
+/** Set when the server is asked to stop by a signal */
+static volatile sig_atomic_t stopRequested = 0;
+
+/**
+ * Stops the server after the current request.
+ * @param signal The signal received.
+ */
+static void handleStopSignal(int signal){
+    stopRequested = 1;
+}
+
+/**
+ * Creates a server. Nothing is opened until start is called.
+ * @param driver The driver that extracts files.
+ * @param socketPath The path of the Unix domain socket.
+ * @param blobMode Whether files are extracted in blob mode.
+ * @param jobs The number of files extracted at once.
+ */
+ExtractServer::ExtractServer(ClangDriver* driver, string socketPath, bool blobMode, int jobs) {
+    this->driver = driver;
+    this->socketPath = socketPath;
+    this->blobMode = blobMode;
+    this->jobs = jobs;
+    serverFd = -1;
+    running = false;
+    deps = nullptr;
+    model = nullptr;
+    dirty = false;
+    watcher = nullptr;
+
+    //Headers are only read again when files change.
+    driver->setFileCache(true);
+}
+
+/**
+ * Closes the socket and removes the fragment cache.
+ */
+ExtractServer::~ExtractServer() {
+    if (serverFd >= 0) {
+        close(serverFd);
+        unlink(socketPath.c_str());
+    }
+    if (running) {
+        sigaction(SIGINT, &oldInt, nullptr);
+        sigaction(SIGTERM, &oldTerm, nullptr);
+    }
+    if (cacheDir.compare("") != 0) {
+        boost::system::error_code error;
+        remove_all(cacheDir, error);
+    }
+    delete deps;
+    delete model;
+    delete watcher;
+    driver->setFileCache(false);
+}
+
+/**
+ * Opens the socket and the fragment cache. Without a socket path,
+ * the server only answers to file changes.
+ * @return Whether the server can accept requests.
+ */
+bool ExtractServer::start(){
+    if (socketPath.compare("") == 0) return startCache();
+
+    //Checks the socket path.
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        cerr << "Error: The socket path " << socketPath << " is too long." << endl;
+        return false;
+    }
+    strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+    //Opens the socket.
+    unlink(socketPath.c_str());
+    serverFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (serverFd < 0 || bind(serverFd, (struct sockaddr*) &address, sizeof(address)) != 0 || listen(serverFd, SOMAXCONN) != 0) {
+        cerr << "Error: Could not listen on " << socketPath << ": " << strerror(errno) << endl;
+        if (serverFd >= 0) close(serverFd);
+        serverFd = -1;
+        return false;
+    }
+
+    return startCache();
+}
+
+/**
+ * Sets up the fragment cache and the signal handlers.
+ * @return Whether the cache was created.
+ */
+bool ExtractServer::startCache(){
+    //Sets up the fragment cache.
+    cacheDir = (temp_directory_path() / unique_path("clangex-server-%%%%-%%%%-%%%%")).string();
+    boost::system::error_code error;
+    create_directories(cacheDir, error);
+    if (error) {
+        cerr << "Error: Could not create " << cacheDir << ": " << error.message() << endl;
+        return false;
+    }
+    deps = new DepsIndex(cacheDir + "/" + DepsIndex::DEPS_FILE);
+
+    //The model is changed in place as files change.
+    model = new TAGraph();
+    model->setProvenance(true);
+    model->setKeepUnresolved(true);
+
+    //Signals stop the server instead of killing it.
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = handleStopSignal;
+    stopRequested = 0;
+    sigaction(SIGINT, &action, &oldInt);
+    sigaction(SIGTERM, &action, &oldTerm);
+    signal(SIGPIPE, SIG_IGN);
+
+    running = true;
+    return true;
+}
+
+/**
+ * Accepts connections until the server is stopped. Every open
+ * connection is watched along with the socket, so a client that stays
+ * connected doesn't keep others out. Each connection can send any
+ * number of newline terminated requests. Requests are handled one at
+ * a time.
+ */
+void ExtractServer::run(){
+    if (serverFd >= 0) cout << "Listening on " << socketPath << "." << endl;
+    if (watcher != nullptr) cout << "Watching for changes. Press Ctrl-C to stop." << endl;
+
+    map<int, string> clients;
+    while (running && !stopRequested) {
+        vector<int> fds;
+        if (serverFd >= 0) fds.push_back(serverFd);
+        for (auto const& client : clients) fds.push_back(client.first);
+
+        vector<int> ready;
+        if (!waitForInput(fds, &ready)) continue;
+        for (int fd : ready) {
+            if (!running || stopRequested) break;
+            if (fd == serverFd) {
+                int clientFd = accept(serverFd, nullptr, nullptr);
+                if (clientFd >= 0) clients[clientFd] = "";
+            } else if (!readRequests(fd, &clients.at(fd))) {
+                close(fd);
+                clients.erase(fd);
+            }
+        }
+    }
+
+    for (auto const& client : clients) close(client.first);
+    cout << "Server stopped." << endl;
+}
+
+/**
+ * Reads from a connection and handles every complete request.
+ * @param clientFd The client connection.
+ * @param buffer The data read from the connection that isn't handled yet.
+ * @return Whether the connection stays open.
+ */
+bool ExtractServer::readRequests(int clientFd, string* buffer){
+    char data[4096];
+    ssize_t amt = read(clientFd, data, sizeof(data));
+    if (amt < 0 && errno == EINTR) return true;
+    if (amt <= 0) return false;
+    buffer->append(data, (size_t) amt);
+
+    //Handles the requests line by line.
+    for (size_t end = buffer->find('\n'); end != string::npos; end = buffer->find('\n')) {
+        string line = buffer->substr(0, end);
+        buffer->erase(0, end + 1);
+        if (line.size() > 0 && line.back() == '\r') line.pop_back();
+        if (!handleRequest(clientFd, line) || !running) return false;
+    }
+
+    return true;
+}
+
+/**
+ * Handles a single request.
+ * @param clientFd The client connection.
+ * @param line The request.
+ * @return Whether the connection stays open.
+ */
+bool ExtractServer::handleRequest(int clientFd, string line){
+    vector<string> args;
+    istringstream iss(line);
+    for (string token; iss >> token;) args.push_back(token);
+    if (args.size() == 0) return true;
+
+    string command = args.at(0);
+    args.erase(args.begin());
+    if (command.compare("add") == 0) return handleAdd(clientFd, args);
+    if (command.compare("compdb") == 0) return handleCompdb(clientFd, args);
+    if (command.compare("update") == 0) return handleUpdate(clientFd, args);
+    if (command.compare("remove") == 0) return handleRemove(clientFd, args);
+    if (command.compare("query") == 0) return handleQuery(clientFd, args);
+    if (command.compare("dump") == 0) return handleDump(clientFd, args);
+    if (command.compare("status") == 0) return handleStatus(clientFd);
+    if (command.compare("shutdown") == 0) {
+        running = false;
+        reply(clientFd, "OK Shutting down.");
+        return false;
+    }
+
+    return replyError(clientFd, "Unknown request " + command + ".");
+}
+
+/**
+ * Adds files or directories and extracts them.
+ * @param clientFd The client connection.
+ * @param args The paths to add.
+ * @return Whether the connection stays open.
+ */
+bool ExtractServer::handleAdd(int clientFd, vector<string> args){
+    if (args.size() == 0) return replyError(clientFd, "No paths were given.");
+
+    for (string arg : args) driver->addByPath(absolute(path(arg)));
+    int num = extractQueued();
+    if (num < 0) return replyError(clientFd, "The files could not be extracted.");
+    return reply(clientFd, "OK " + to_string(num) + " file(s) extracted.");
+}
+
+/**
+ * Adds the files in a compilation database and extracts them.
+ * @param clientFd The client connection.
+ * @param args The compilation database.
+ * @return Whether the connection stays open.
+ */
+bool ExtractServer::handleCompdb(int clientFd, vector<string> args){
+    if (args.size() != 1) return replyError(clientFd, "A single compilation database must be given.");
+
+    if (driver->addByCompilationDatabase(args.at(0), vector<string>(), vector<string>()) < 0)
+        return replyError(clientFd, "The compilation database could not be loaded.");
+    int num = extractQueued();
+    if (num < 0) return replyError(clientFd, "The files could not be extracted.");
+    return reply(clientFd, "OK " + to_string(num) + " file(s) extracted.");
+}
+
+/**
+ * Re-extracts tracked files whose contents changed. Files that were
+ * deleted are removed along with their facts.
+ * @param clientFd The client connection.
+ * @param args The files to check or none for every tracked file.
+ * @return Whether the connection stays open.
+ */
+bool ExtractServer::handleUpdate(int clientFd, vector<string> args){
+    vector<string> candidates;
+    if (args.size() == 0) {
+        for (auto entry : tracked) candidates.push_back(entry.first);
+    } else {
+        for (string arg : args) {
+            string file = getTrackedName(path(arg));
+            if (tracked.find(file) == tracked.end()) return replyError(clientFd, arg + " is not tracked.");
+            candidates.push_back(file);
+        }
+    }
+
+    //Queues the files that changed and removes the ones that were deleted.
+    int numChanged = 0;
+    int numRemoved = 0;
+    for (string file : candidates) {
+        boost::system::error_code error;
+        if (!exists(path(file), error) && !error) {
+            removeTracked(file);
+            numRemoved++;
+            continue;
+        }
+        if (!hasChanged(file)) continue;
+        driver->addByPath(path(file));
+        numChanged++;
+    }
+
+    string removed = " and " + to_string(numRemoved) + " file(s) removed.";
+    if (numChanged == 0) return reply(clientFd, "OK 0 file(s) extracted" + removed);
+    int num = extractQueued();
+    if (num < 0) return replyError(clientFd, "The files could not be extracted.");
+    return reply(clientFd, "OK " + to_string(num) + " file(s) extracted" + removed);
+}
+
+/**
+ * Removes files and their facts from the model.
+ * @param clientFd The client connection.
+ * @param args The files to remove.
+ * @return Whether the connection stays open.
+ */
+bool ExtractServer::handleRemove(int clientFd, vector<string> args){
+    if (args.size() == 0) return replyError(clientFd, "No files were given.");
+
+    int num = 0;
+    for (string arg : args) {
+        string file = getTrackedName(path(arg));
+        if (tracked.find(file) == tracked.end()) continue;
+
+        removeTracked(file);
+        num++;
+    }
+
+    return reply(clientFd, "OK " + to_string(num) + " file(s) removed.");
+}
+
+/**
+ * Lists the entities with a name and their relations.
+ * @param clientFd The client connection.
+ * @param args The name to look for.
+ * @return Whether the connection stays open.
+ */
+bool ExtractServer::handleQuery(int clientFd, vector<string> args){
+    if (args.size() != 1) return replyError(clientFd, "A single name must be given.");
+    if (!resolveModel()) return replyError(clientFd, "There is no model.");
+
+    string result;
+    vector<ClangNode*> nodes = model->findNodeByName(args.at(0));
+    for (ClangNode* node : nodes) {
+        result += "node " + node->getID() + " " + ClangNode::getTypeString(node->getType()) + " " + node->getName() + "\n";
+        vector<ClangEdge*> edges = model->findEdgesBySrcID(node);
+        vector<ClangEdge*> incoming = model->findEdgesByDstID(node);
+        edges.insert(edges.end(), incoming.begin(), incoming.end());
+        for (ClangEdge* edge : edges) {
+            if (!edge->isResolved()) continue;
+            result += "edge " + ClangEdge::getTypeString(edge->getType()) + " " + edge->getSrcID() + " " +
+                      edge->getDstID() + "\n";
+        }
+    }
+
+    return reply(clientFd, result + "OK " + to_string(nodes.size()) + " entity(s) found.");
+}
+
+/**
+ * Writes the model to a file or streams it over the connection. A
+ * streamed model ends the connection.
+ * @param clientFd The client connection.
+ * @param args The file to write or none to stream.
+ * @return Whether the connection stays open.
+ */
+bool ExtractServer::handleDump(int clientFd, vector<string> args){
+    if (args.size() > 1) return replyError(clientFd, "At most one file can be given.");
+    if (!resolveModel()) return replyError(clientFd, "There is no model.");
+
+    if (args.size() == 0) {
+        model->writeTAStream(clientFd);
+        return false;
+    }
+
+    if (!model->writeTAFile(args.at(0))) return replyError(clientFd, "The model could not be written to " + args.at(0) + ".");
+    return reply(clientFd, "OK The model was written to " + args.at(0) + ".");
+}
+
+/**
+ * Prints the size of the resident model.
+ * @param clientFd The client connection.
+ * @return Whether the connection stays open.
+ */
+bool ExtractServer::handleStatus(int clientFd){
+    string result = "files " + to_string(tracked.size()) + "\n";
+    if (resolveModel()) {
+        vector<ClangNode*> nodes = model->getNodes();
+        vector<ClangEdge*> edges = model->getEdges();
+        long numNodes = count_if(nodes.begin(), nodes.end(), [](ClangNode* node) { return node != nullptr; });
+        long numEdges = count_if(edges.begin(), edges.end(), [](ClangEdge* edge) { return edge->isResolved(); });
+        result += "entities " + to_string(numNodes) + "\n";
+        result += "relations " + to_string(numEdges) + "\n";
+    }
+
+    return reply(clientFd, result + "OK");
+}
+
+/**
+ * Extracts the files in the driver queue and replaces their facts in
+ * the model. The facts each file had before are retracted first, so
+ * only the files that were extracted are merged again. Each file's
+ * state is read before it's extracted, so a file saved during the
+ * extraction is still seen as changed.
+ * @return The number of files extracted or -1 on failure.
+ */
+int ExtractServer::extractQueued(){
+    vector<path> queued = driver->getFiles();
+    if (queued.size() == 0) return 0;
+
+    vector<string> names;
+    vector<string> files;
+    map<string, FileState> states;
+    for (path file : queued) {
+        names.push_back(getTrackedName(file));
+        files.push_back(driver->getFragmentName(cacheDir, file));
+
+        FileState state;
+        if (readState(names.back(), &state, true)) states[names.back()] = state;
+    }
+
+    if (!driver->generateFragments(blobMode, cacheDir, jobs)) return -1;
+    deps->load();
+
+    //Swaps in each file's new facts.
+    bool success = driver->readFragments(files, jobs, [&](int i, TAGraph* fragment) {
+        string name = names.at(i);
+        model->retractTU(name);
+        paths[name] = fragment->getPaths();
+        model->setCurrentTU(name);
+        model->linkGraph(fragment);
+        model->setCurrentTU("");
+
+        auto state = states.find(name);
+        if (state != states.end()) tracked[name] = state->second;
+    });
+
+    //The fragments aren't needed once they're merged.
+    for (string file : files) {
+        boost::system::error_code error;
+        remove(path(file), error);
+        remove(path(file + TAGraph::PATHS_EXT), error);
+    }
+    watchTracked();
+
+    dirty = true;
+    return (success) ? (int) queued.size() : -1;
+}
+
+/**
+ * Starts watching the added directories and the directories of every
+ * tracked file and header. The model is written to the output file
+ * each time it changes.
+ * @param outputFile The TA file to keep up to date or empty for none.
+ * @return Whether the watcher could be started.
+ */
+bool ExtractServer::enableWatch(string outputFile){
+    watcher = new FileWatcher();
+    if (!watcher->isOpen()) {
+        cerr << "Error: Could not start watching for changes: " << strerror(errno) << endl;
+        delete watcher;
+        watcher = nullptr;
+        return false;
+    }
+
+    watchOutput = outputFile;
+    for (path dir : driver->getDirectories()) watcher->watchDirectory(dir.string());
+    watchTracked();
+
+    if (watchOutput.compare("") != 0) return writeWatchOutput();
+    return true;
+}
+
+/**
+ * Waits until any of the descriptors is readable. File changes that
+ * arrive in the meantime are handled right away.
+ * @param fds The descriptors to wait on. May be empty to only wait for changes.
+ * @param ready The descriptors that are readable.
+ * @return Whether any descriptor is readable.
+ */
+bool ExtractServer::waitForInput(const vector<int>& fds, vector<int>* ready){
+    vector<struct pollfd> polled;
+    for (int fd : fds) polled.push_back({fd, POLLIN, 0});
+    if (watcher != nullptr) polled.push_back({watcher->getDescriptor(), POLLIN, 0});
+    if (polled.size() == 0) {
+        running = false;
+        return false;
+    }
+    if (poll(polled.data(), (nfds_t) polled.size(), -1) <= 0) return false;
+
+    //Lets editors finish saving before the files are extracted.
+    if (watcher != nullptr && (polled.back().revents & POLLIN)) {
+        set<string> changed;
+        watcher->readChanges(changed);
+        while (watcher->waitForChanges(WATCH_DELAY)) watcher->readChanges(changed);
+        handleChanges(changed);
+    }
+
+    for (size_t i = 0; i < fds.size(); i++) {
+        if (polled.at(i).revents & (POLLIN | POLLHUP | POLLERR)) ready->push_back(fds.at(i));
+    }
+    return ready->size() > 0;
+}
+
+/**
+ * Re-extracts the files that changed and the tracked files that
+ * include them. New source files are added and deleted ones removed.
+ * @param changed The paths reported by the watcher.
+ */
+void ExtractServer::handleChanges(set<string> changed){
+    set<string> affected;
+    vector<string> modified;
+    int numRemoved = 0;
+    for (string file : changed) {
+        boost::system::error_code error;
+        bool found = exists(path(file), error);
+
+        //Adds the files in new directories.
+        if (found && is_directory(path(file), error)) {
+            for (recursive_directory_iterator iter(file, error), end; !error && iter != end; iter.increment(error)) {
+                string cur = iter->path().string();
+                if (is_regular_file(iter->path()) && driver->isSourceFile(iter->path()) &&
+                        tracked.find(cur) == tracked.end()) affected.insert(cur);
+            }
+            continue;
+        }
+
+        //Checks the file itself.
+        if (tracked.find(file) != tracked.end()) {
+            if (!found) {
+                removeTracked(file);
+                numRemoved++;
+                continue;
+            }
+            if (!hasChanged(file)) continue;
+            affected.insert(file);
+            modified.push_back(file);
+        } else {
+            modified.push_back(file);
+        }
+    }
+
+    //Finds the translation units that use the modified files.
+    driver->invalidateFiles(modified);
+    for (string file : deps->getDirtyTUs(modified)) {
+        boost::system::error_code error;
+        if (tracked.find(file) != tracked.end() ||
+                (exists(path(file), error) && driver->isSourceFile(path(file)))) affected.insert(file);
+    }
+    if (affected.size() == 0 && numRemoved == 0) return;
+
+    //Extracts the affected files.
+    for (string file : affected) driver->addByPath(path(file));
+    int num = extractQueued();
+    if (num < 0) {
+        cerr << "Error: The changed files could not be extracted." << endl;
+        return;
+    }
+    cout << num << " file(s) re-extracted and " << numRemoved << " file(s) removed." << endl;
+
+    if (watchOutput.compare("") != 0) writeWatchOutput();
+}
+
+/**
+ * Watches the directories of every tracked file and header.
+ */
+void ExtractServer::watchTracked(){
+    if (watcher == nullptr) return;
+
+    for (auto entry : tracked) watcher->watchDirectory(path(entry.first).parent_path().string());
+    if (deps == nullptr) return;
+    for (string header : deps->getHeaders()) watcher->watchDirectory(path(header).parent_path().string());
+}
+
+/**
+ * Writes the model to the watch output. The file is replaced in one
+ * step so readers never see a partial model.
+ * @return Whether the model was written.
+ */
+bool ExtractServer::writeWatchOutput(){
+    if (!resolveModel()) return false;
+
+    if (!model->writeTAFile(watchOutput)) {
+        cerr << "Error: The model could not be written to " << watchOutput << "." << endl;
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Reads the state of a file on disk.
+ * @param file The file.
+ * @param state The state of the file.
+ * @param hash Whether the contents are hashed.
+ * @return Whether the file could be read.
+ */
+bool ExtractServer::readState(string file, FileState* state, bool hash){
+    boost::system::error_code error;
+    state->modified = last_write_time(path(file), error);
+    if (error) return false;
+    state->size = file_size(path(file), error);
+    if (error) return false;
+
+    state->hash = "";
+    if (hash) {
+        std::ifstream input(file, ios::binary);
+        if (!input.is_open()) return false;
+        stringstream contents;
+        contents << input.rdbuf();
+        state->hash = ASTWalker::generateMD5(contents.str());
+    }
+
+    return true;
+}
+
+/**
+ * Checks whether the contents of a tracked file changed. Files that
+ * were only touched get their timestamp updated.
+ * @param file The tracked file.
+ * @return Whether the contents changed.
+ */
+bool ExtractServer::hasChanged(string file){
+    FileState state;
+    FileState& old = tracked.at(file);
+    if (!readState(file, &state, false)) return false;
+    if (state.modified == old.modified && state.size == old.size) return false;
+
+    //Only the timestamp changed.
+    readState(file, &state, true);
+    if (state.hash.compare(old.hash) == 0) {
+        old = state;
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Stops tracking a file and retracts its facts from the model.
+ * @param file The tracked file.
+ */
+void ExtractServer::removeTracked(string file){
+    tracked.erase(file);
+    paths.erase(file);
+    deps->removeTU(file);
+    deps->save();
+
+    model->retractTU(file);
+    dirty = true;
+}
+
+/**
+ * Gets the name a file is tracked by. Names are canonical so paths
+ * given by clients and by the watcher refer to the same file.
+ * @param file The file.
+ * @return The tracked name.
+ */
+string ExtractServer::getTrackedName(path file){
+    boost::system::error_code error;
+    path name = canonical(file, error);
+    if (error) return absolute(file).string();
+    return name.string();
+}
+
+/**
+ * Resolves the references in the model after files changed. The file
+ * nodes are tracked like a translation unit of their own. They're only
+ * built again from scratch when a path is no longer used.
+ * @return Whether there is a model.
+ */
+bool ExtractServer::resolveModel(){
+    if (model == nullptr || tracked.size() == 0) return false;
+    if (!dirty) return true;
+
+    //Checks whether any path went away.
+    set<string> current;
+    for (auto const& entry : paths) current.insert(entry.second.begin(), entry.second.end());
+    bool removed = false;
+    for (string cur : resolvedPaths) {
+        if (current.find(cur) == current.end()) removed = true;
+    }
+    if (removed) {
+        model->retractTU(FILES_TU);
+        model->clearPaths();
+        for (string cur : current) model->addPath(cur);
+    }
+
+    model->setCurrentTU(FILES_TU);
+    driver->resolveGraph(model);
+    model->setCurrentTU("");
+    resolvedPaths = current;
+    dirty = false;
+
+    return true;
+}
+
+/**
+ * Sends a reply to the client.
+ * @param clientFd The client connection.
+ * @param message The reply.
+ * @return Whether the connection stays open.
+ */
+bool ExtractServer::reply(int clientFd, string message){
+    message += "\n";
+    size_t written = 0;
+    while (written < message.size()) {
+        ssize_t amt = send(clientFd, message.data() + written, message.size() - written, MSG_NOSIGNAL);
+        if (amt < 0 && errno == EINTR) continue;
+        if (amt <= 0) return false;
+        written += amt;
+    }
+
+    return true;
+}
+
+/**
+ * Sends an error to the client.
+ * @param clientFd The client connection.
+ * @param message The error.
+ * @return Whether the connection stays open.
+ */
+bool ExtractServer::replyError(int clientFd, string message){
+    return reply(clientFd, "ERROR " + message);
+}
@@ -0,0 +1,124 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// ExtractServer.h
+//
+// Created By: Bryan J Muscedere
+// Date: 19/10/26.
+//
+// Extraction server that keeps a model resident and answers requests
+// over a Unix domain socket. Every file is extracted into its own
+// fragment so changed files can be re-extracted on their own. The
+// compilation database and the linked model stay loaded between requests.
+// In watch mode, saved files and the files that include them are
+// re-extracted as soon as they change.
+//
+// Copyright (C) 2017, Bryan J. Muscedere
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef CLANGEX_EXTRACTSERVER_H
+#define CLANGEX_EXTRACTSERVER_H
+
+#include <csignal>
+#include <ctime>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include "ClangDriver.h"
+#include "DepsIndex.h"
+#include "FileWatcher.h"
+
+class ExtractServer {
+public:
+    /** Constructor/Destructor */
+    ExtractServer(ClangDriver* driver, std::string socketPath, bool blobMode, int jobs);
+    ~ExtractServer();
+
+    /** Server Operations */
+    bool start();
+    void run();
+    int extractQueued();
+    bool enableWatch(std::string outputFile = std::string());
+
+private:
+    /** State of a Tracked File */
+    typedef struct {
+        time_t modified;
+        uintmax_t size;
+        std::string hash;
+    } FileState;
+
+    /** Watch Settings */
+    const static int WATCH_DELAY = 100;
+
+    /** Model Settings */
+    const std::string FILES_TU = "$FILES";
+
+    /** Server Settings */
+    ClangDriver* driver;
+    std::string socketPath;
+    std::string cacheDir;
+    bool blobMode;
+    int jobs;
+    int serverFd;
+    bool running;
+    struct sigaction oldInt;
+    struct sigaction oldTerm;
+
+    /** Resident State */
+    std::map<std::string, FileState> tracked;
+    std::map<std::string, std::vector<std::string>> paths;
+    std::set<std::string> resolvedPaths;
+    DepsIndex* deps;
+    TAGraph* model;
+    bool dirty;
+
+    /** Watch State */
+    FileWatcher* watcher;
+    std::string watchOutput;
+
+    /** Request Handlers */
+    bool readRequests(int clientFd, std::string* buffer);
+    bool handleRequest(int clientFd, std::string line);
+    bool handleAdd(int clientFd, std::vector<std::string> args);
+    bool handleCompdb(int clientFd, std::vector<std::string> args);
+    bool handleUpdate(int clientFd, std::vector<std::string> args);
+    bool handleRemove(int clientFd, std::vector<std::string> args);
+    bool handleQuery(int clientFd, std::vector<std::string> args);
+    bool handleDump(int clientFd, std::vector<std::string> args);
+    bool handleStatus(int clientFd);
+
+    /** Startup Helpers */
+    bool startCache();
+
+    /** Watch Helpers */
+    bool waitForInput(const std::vector<int>& fds, std::vector<int>* ready);
+    void handleChanges(std::set<std::string> changed);
+    void watchTracked();
+    bool writeWatchOutput();
+
+    /** Helper Methods */
+    bool readState(std::string file, FileState* state, bool hash);
+    bool hasChanged(std::string file);
+    void removeTracked(std::string file);
+    std::string getTrackedName(path file);
+    bool resolveModel();
+    bool reply(int clientFd, std::string message);
+    bool replyError(int clientFd, std::string message);
+};
+
+
+#endif //CLANGEX_EXTRACTSERVER_H
@@ -0,0 +1,158 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// FileWatcher.cpp
+//
+// Created By: Bryan J Muscedere
+// Date: 19/10/26.
+//
+// Watches directories with inotify and reports the files that were
+// written, created, moved or deleted in them. Directories created
+// inside a watched directory are watched as well.
+//
+// Copyright (C) 2017, Bryan J. Muscedere
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+#include "FileWatcher.h"
+
+using namespace std;
+
+/** The events that mean a file's contents may have changed */
+const static uint32_t WATCH_EVENTS = IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO |
+                                     IN_DELETE_SELF;
+
+/**
+ * Opens an inotify instance.
+ */
+FileWatcher::FileWatcher() {
+    watchFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+}
+
+/**
+ * Closes the inotify instance and all of its watches.
+ */
+FileWatcher::~FileWatcher() {
+    if (watchFd >= 0) close(watchFd);
+}
+
+/**
+ * Checks whether inotify could be opened.
+ * @return Whether the watcher is open.
+ */
+bool FileWatcher::isOpen(){
+    return watchFd >= 0;
+}
+
+/**
+ * Gets the descriptor that becomes readable when there are changes.
+ * @return The inotify descriptor.
+ */
+int FileWatcher::getDescriptor(){
+    return watchFd;
+}
+
+/**
+ * Starts watching a directory. Subdirectories are not watched
+ * unless they're created after this call. Changes are reported
+ * under the directory's canonical path.
+ * @param directory The directory to watch.
+ * @return Whether the directory is watched.
+ */
+bool FileWatcher::watchDirectory(string directory){
+    if (watchFd < 0) return false;
+
+    char resolved[PATH_MAX];
+    if (realpath(directory.c_str(), resolved) == nullptr) return false;
+    directory = resolved;
+    if (isWatched(directory)) return true;
+
+    int wd = inotify_add_watch(watchFd, directory.c_str(), WATCH_EVENTS);
+    if (wd < 0) return false;
+
+    watches[wd] = directory;
+    directories.insert(directory);
+    return true;
+}
+
+/**
+ * Checks whether a directory is being watched.
+ * @param directory The directory.
+ * @return Whether it's watched.
+ */
+bool FileWatcher::isWatched(string directory){
+    return directories.find(directory) != directories.end();
+}
+
+/**
+ * Reads all pending events. New directories are watched and reported
+ * so their files can be added.
+ * @param changed The paths that changed.
+ * @return Whether any events were read.
+ */
+bool FileWatcher::readChanges(set<string>& changed){
+    if (watchFd < 0) return false;
+
+    alignas(struct inotify_event) char buffer[4096];
+    bool found = false;
+    while (true) {
+        ssize_t amt = read(watchFd, buffer, sizeof(buffer));
+        if (amt < 0 && errno == EINTR) continue;
+        if (amt <= 0) break;
+
+        //Goes through each event in the buffer.
+        for (char* cur = buffer; cur < buffer + amt;) {
+            struct inotify_event* event = (struct inotify_event*) cur;
+            cur += sizeof(struct inotify_event) + event->len;
+
+            auto watch = watches.find(event->wd);
+            if (watch == watches.end()) continue;
+
+            //Forgets directories that are gone.
+            if (event->mask & (IN_DELETE_SELF | IN_IGNORED)) {
+                directories.erase(watch->second);
+                watches.erase(watch);
+                continue;
+            }
+            if (event->len == 0) continue;
+
+            string file = watch->second + "/" + string(event->name);
+            if ((event->mask & IN_ISDIR) && (event->mask & (IN_CREATE | IN_MOVED_TO))) watchDirectory(file);
+            changed.insert(file);
+            found = true;
+        }
+    }
+
+    return found;
+}
+
+/**
+ * Waits until there are changes to read.
+ * @param timeout The most milliseconds to wait.
+ * @return Whether there are changes.
+ */
+bool FileWatcher::waitForChanges(int timeout){
+    if (watchFd < 0) return false;
+
+    struct pollfd pfd;
+    pfd.fd = watchFd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    return poll(&pfd, 1, timeout) > 0 && (pfd.revents & POLLIN);
+}
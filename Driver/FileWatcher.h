@@ -0,0 +1,58 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// FileWatcher.h
+//
+// Created By: Bryan J Muscedere
+// Date: 19/10/26.
+//
+// Watches directories with inotify and reports the files that were
+// written, created, moved or deleted in them. Directories created
+// inside a watched directory are watched as well.
+//
+// Copyright (C) 2017, Bryan J. Muscedere
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CLANGEX_FILEWATCHER_H
+#define CLANGEX_FILEWATCHER_H
+
+#include <map>
+#include <set>
+#include <string>
+
+class FileWatcher {
+public:
+    /** Constructor/Destructor */
+    FileWatcher();
+    ~FileWatcher();
+
+    /** Watch Operations */
+    bool isOpen();
+    int getDescriptor();
+    bool watchDirectory(std::string directory);
+    bool isWatched(std::string directory);
+
+    /** Change Reporting */
+    bool readChanges(std::set<std::string>& changed);
+    bool waitForChanges(int timeout);
+
+private:
+    /** Inotify Variables */
+    int watchFd;
+    std::map<int, std::string> watches;
+    std::set<std::string> directories;
+};
+
+
+#endif //CLANGEX_FILEWATCHER_H
@@ -0,0 +1,162 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// ProjectDatabase.cpp
+//
+// Created By: Bryan J Muscedere
+// Date: 19/10/26.
+//
+// Compilation database that wraps a project's compile_commands.json.
+// Keeps one compile command per file, caches lookups and filters and
+// orders the files so ClangEx can be run with each file's real flags.
+//
+// Copyright (C) 2017, Bryan J. Muscedere
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <unordered_set>
+#include <boost/filesystem.hpp>
+#include "clang/Tooling/JSONCompilationDatabase.h"
+#include "ProjectDatabase.h"
+
+using namespace std;
+using namespace clang::tooling;
+
+/** Database File Name */
+const string ProjectDatabase::DATABASE_FILE = "compile_commands.json";
+
+/**
+ * Constructor. Takes ownership of the base database.
+ * @param base The database to wrap.
+ */
+ProjectDatabase::ProjectDatabase(CompilationDatabase* base) {
+    this->base = base;
+}
+
+/**
+ * Destructor. Deletes the base database.
+ */
+ProjectDatabase::~ProjectDatabase() {
+    delete base;
+}
+
+/**
+ * Loads a compile_commands.json file or the one in a directory.
+ * @param location The file or directory to load.
+ * @param error The error message if the load fails.
+ * @return The database or nullptr if it couldn't be loaded.
+ */
+ProjectDatabase* ProjectDatabase::loadFromPath(string location, string* error){
+    boost::filesystem::path dbPath = location;
+    if (boost::filesystem::is_directory(dbPath)) dbPath /= DATABASE_FILE;
+
+    unique_ptr<JSONCompilationDatabase> db = JSONCompilationDatabase::loadFromFile(dbPath.string(), *error,
+                                                                                  JSONCommandLineSyntax::AutoDetect);
+    if (!db) return nullptr;
+
+    return new ProjectDatabase(db.release());
+}
+
+/**
+ * Adds a regular expression that filters the files.
+ * @param regex The expression to match against the full path.
+ * @param include Whether matching files are kept or dropped.
+ */
+void ProjectDatabase::addFilter(string regex, bool include){
+    if (include) includes.push_back(std::regex(regex));
+    else excludes.push_back(std::regex(regex));
+}
+
+/**
+ * Gets the files to process. Duplicate entries are removed and files
+ * are ordered by directory so files sharing headers are parsed together.
+ * @return The list of files.
+ */
+vector<string> ProjectDatabase::getFiles(){
+    vector<string> files;
+    unordered_set<string> seen;
+
+    for (string file : base->getAllFiles()){
+        //Files are kept as the database names them so lookups match.
+        boost::system::error_code code;
+        boost::filesystem::path filePath = boost::filesystem::canonical(file, code);
+        if (code) filePath = boost::filesystem::absolute(file);
+
+        if (isFiltered(file) || !seen.insert(filePath.string()).second) continue;
+        files.push_back(file);
+    }
+
+    //Orders by directory then by name.
+    sort(files.begin(), files.end(), [](const string& one, const string& two){
+        boost::filesystem::path pathOne = one;
+        boost::filesystem::path pathTwo = two;
+        if (pathOne.parent_path() != pathTwo.parent_path()) return pathOne.parent_path() < pathTwo.parent_path();
+        return pathOne.filename() < pathTwo.filename();
+    });
+
+    return files;
+}
+
+/**
+ * Gets the compile command for a file. Only the first command is kept
+ * so a file listed more than once is only parsed once.
+ * @param filePath The file to look up.
+ * @return The compile command for the file.
+ */
+vector<CompileCommand> ProjectDatabase::getCompileCommands(llvm::StringRef filePath) const {
+    string file = filePath.str();
+
+    lock_guard<mutex> guard(cacheLock);
+    auto it = commandCache.find(file);
+    if (it != commandCache.end()) return it->second;
+
+    vector<CompileCommand> commands = base->getCompileCommands(filePath);
+    if (commands.size() > 1) commands.resize(1);
+
+    commandCache[file] = commands;
+    return commands;
+}
+
+/**
+ * Gets all the files in the database.
+ * @return The list of files.
+ */
+vector<string> ProjectDatabase::getAllFiles() const {
+    return base->getAllFiles();
+}
+
+/**
+ * Gets all the compile commands in the database.
+ * @return The list of compile commands.
+ */
+vector<CompileCommand> ProjectDatabase::getAllCompileCommands() const {
+    return base->getAllCompileCommands();
+}
+
+/**
+ * Checks whether a file is removed by the filters.
+ * @param file The file to check.
+ * @return Whether the file is filtered out.
+ */
+bool ProjectDatabase::isFiltered(const string& file){
+    for (const std::regex& exclude : excludes){
+        if (regex_match(file, exclude)) return true;
+    }
+    if (includes.size() == 0) return false;
+
+    for (const std::regex& include : includes){
+        if (regex_match(file, include)) return false;
+    }
+    return true;
+}
@@ -0,0 +1,72 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// ProjectDatabase.h
+//
+// Created By: Bryan J Muscedere
+// Date: 19/10/26.
+//
+// Compilation database that wraps a project's compile_commands.json.
+// Keeps one compile command per file, caches lookups and filters and
+// orders the files so ClangEx can be run with each file's real flags.
+//
+// Copyright (C) 2017, Bryan J. Muscedere
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CLANGEX_PROJECTDATABASE_H
+#define CLANGEX_PROJECTDATABASE_H
+
+#include <mutex>
+#include <regex>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "clang/Tooling/CompilationDatabase.h"
+
+class ProjectDatabase : public clang::tooling::CompilationDatabase {
+public:
+    /** Constructor/Destructor */
+    ProjectDatabase(clang::tooling::CompilationDatabase* base);
+    ~ProjectDatabase() override;
+
+    /** Loader */
+    static ProjectDatabase* loadFromPath(std::string location, std::string* error);
+
+    /** Filters */
+    void addFilter(std::string regex, bool include);
+    std::vector<std::string> getFiles();
+
+    /** Compilation Database Operations */
+    std::vector<clang::tooling::CompileCommand> getCompileCommands(llvm::StringRef filePath) const override;
+    std::vector<std::string> getAllFiles() const override;
+    std::vector<clang::tooling::CompileCommand> getAllCompileCommands() const override;
+
+    const static std::string DATABASE_FILE;
+
+private:
+    /** Member Variables */
+    clang::tooling::CompilationDatabase* base;
+    std::vector<std::regex> includes;
+    std::vector<std::regex> excludes;
+
+    /** Command Cache */
+    mutable std::unordered_map<std::string, std::vector<clang::tooling::CompileCommand>> commandCache;
+    mutable std::mutex cacheLock;
+
+    /** Helper Methods */
+    bool isFiltered(const std::string& file);
+};
+
+
+#endif //CLANGEX_PROJECTDATABASE_H
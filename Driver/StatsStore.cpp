@@ -0,0 +1,177 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// StatsStore.cpp
+//
+// Created By: Bryan J Muscedere
+// Date: 19/10/26.
+//
+// Small on-disk store of how long each translation unit took, how much
+// AST memory it used and how many facts it produced. Later runs use it
+// to start the most expensive files first.
+//
+// Copyright (C) 2017, Bryan J. Muscedere
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include "StatsStore.h"
+
+using namespace std;
+
+/** Stats File Name */
+const string StatsStore::STATS_FILE = ".clangex-stats";
+
+/**
+ * Constructor. Doesn't read the store until load is called.
+ * @param fileName The file that holds the statistics.
+ */
+StatsStore::StatsStore(string fileName) {
+    this->fileName = fileName;
+}
+
+/**
+ * Destructor.
+ */
+StatsStore::~StatsStore() { }
+
+/**
+ * Reads the statistics from disk. Each line holds the seconds, the
+ * memory, the number of facts and the file.
+ * @return Whether the store could be read.
+ */
+bool StatsStore::load(){
+    std::ifstream statsFile(fileName);
+    if (!statsFile.is_open()) return false;
+
+    string line;
+    while (getline(statsFile, line)){
+        stringstream ss(line);
+        TUStats cur;
+        string file;
+        if (!(ss >> cur.seconds >> cur.memory >> cur.facts)) continue;
+
+        ss.get();
+        getline(ss, file);
+        if (file.compare("") != 0) stats[file] = cur;
+    }
+
+    return true;
+}
+
+/**
+ * Writes the statistics to disk. The file is replaced in one step so
+ * an interrupted run doesn't leave a partial store.
+ * @return Whether the store was written.
+ */
+bool StatsStore::save(){
+    string tempName = fileName + ".tmp";
+    std::ofstream statsFile(tempName);
+    if (!statsFile.is_open()) return false;
+
+    for (auto const& entry : stats){
+        statsFile << entry.second.seconds << "\t" << entry.second.memory << "\t" << entry.second.facts << "\t"
+                  << entry.first << "\n";
+    }
+    statsFile.close();
+    if (statsFile.fail()) return false;
+
+    return rename(tempName.c_str(), fileName.c_str()) == 0;
+}
+
+/**
+ * Gets the statistics of a file from an earlier run.
+ * @param file The file to look up.
+ * @param stats The statistics of the file.
+ * @return Whether the file has statistics.
+ */
+bool StatsStore::getStats(string file, TUStats* stats){
+    auto it = this->stats.find(file);
+    if (it == this->stats.end()) return false;
+
+    *stats = it->second;
+    return true;
+}
+
+/**
+ * Records the statistics of a file.
+ * @param file The file.
+ * @param stats The statistics of the file.
+ */
+void StatsStore::setStats(string file, TUStats stats){
+    this->stats[file] = stats;
+}
+
+/**
+ * Orders files so the ones expected to take longest come first. Files
+ * without statistics are expected to take the average time and files
+ * with the same cost keep their order.
+ * @param files The files to order.
+ * @return The indices of the files in the order to run them.
+ */
+vector<int> StatsStore::orderByCost(const vector<string>& files){
+    double mean = getMeanSeconds();
+
+    vector<pair<double, int>> costs;
+    for (size_t i = 0; i < files.size(); i++){
+        auto it = stats.find(files.at(i));
+        costs.push_back(make_pair((it == stats.end()) ? mean : it->second.seconds, (int) i));
+    }
+    stable_sort(costs.begin(), costs.end(), [](const pair<double, int>& one, const pair<double, int>& two){
+        return one.first > two.first;
+    });
+
+    vector<int> order;
+    for (auto const& cost : costs) order.push_back(cost.second);
+    return order;
+}
+
+/**
+ * Checks whether a file used a lot more memory than the average file
+ * the last time it was run.
+ * @param file The file to check.
+ * @return Whether the file is memory heavy.
+ */
+bool StatsStore::isHeavy(string file){
+    auto it = stats.find(file);
+    if (it == stats.end()) return false;
+
+    return it->second.memory > getMeanMemory() * HEAVY_FACTOR;
+}
+
+/**
+ * Gets the average time of the files in the store.
+ * @return The average number of seconds.
+ */
+double StatsStore::getMeanSeconds(){
+    if (stats.size() == 0) return 0;
+
+    double total = 0;
+    for (auto const& entry : stats) total += entry.second.seconds;
+    return total / stats.size();
+}
+
+/**
+ * Gets the average memory of the files in the store.
+ * @return The average number of bytes.
+ */
+double StatsStore::getMeanMemory(){
+    if (stats.size() == 0) return 0;
+
+    double total = 0;
+    for (auto const& entry : stats) total += entry.second.memory;
+    return total / stats.size();
+}
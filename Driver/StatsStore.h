@@ -0,0 +1,75 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// StatsStore.h
+//
+// Created By: Bryan J Muscedere
+// Date: 19/10/26.
+//
+// Small on-disk store of how long each translation unit took, how much
+// AST memory it used and how many facts it produced. Later runs use it
+// to start the most expensive files first.
+//
+// Copyright (C) 2017, Bryan J. Muscedere
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CLANGEX_STATSSTORE_H
+#define CLANGEX_STATSSTORE_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+class StatsStore {
+public:
+    /** Per File Statistics */
+    typedef struct {
+        double seconds = 0;
+        size_t memory = 0;
+        size_t facts = 0;
+    } TUStats;
+
+    /** Constructor/Destructor */
+    StatsStore(std::string fileName);
+    ~StatsStore();
+
+    /** Store Operations */
+    bool load();
+    bool save();
+
+    /** Statistic Operations */
+    bool getStats(std::string file, TUStats* stats);
+    void setStats(std::string file, TUStats stats);
+
+    /** Scheduling Operations */
+    std::vector<int> orderByCost(const std::vector<std::string>& files);
+    bool isHeavy(std::string file);
+
+    const static std::string STATS_FILE;
+
+private:
+    /** Scheduling Settings */
+    const double HEAVY_FACTOR = 2.0;
+
+    /** Member Variables */
+    std::string fileName;
+    std::unordered_map<std::string, TUStats> stats;
+
+    /** Helper Methods */
+    double getMeanSeconds();
+    double getMeanMemory();
+};
+
+
+#endif //CLANGEX_STATSSTORE_H
@@ -25,11 +25,13 @@
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 /////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+#include <fcntl.h>
 #include <fstream>
 #include <iostream>
 #include <pwd.h>
 #include <zconf.h>
 #include <vector>
+#include <thread>
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/algorithm/string/regex.hpp>
 #include <boost/filesystem.hpp>
@@ -37,6 +39,8 @@
 #include <boost/make_shared.hpp>
 #include <boost/algorithm/string.hpp>
 #include "ClangDriver.h"
+#include "ExtractServer.h"
+#include "../Metrics/Metrics.h"
 
 using namespace std;
 using namespace boost::filesystem;
@@ -59,18 +63,60 @@ const static string DISABLE_ARG = "disable";
 const static string SCRIPT_ARG = "script";
 const static string RECOVER_ARG = "recover";
 const static string OLOC_ARG = "outLoc";
+const static string LINK_ARG = "link";
+const static string WATCH_ARG = "watch";
+const static string COMPDB_ARG = "compdb";
+
+/** Batch Exit Codes */
+const static int EXIT_OK = 0;
+const static int EXIT_USAGE = 1;
+const static int EXIT_EXTRACT = 2;
+const static int EXIT_OUTPUT = 3;
+const static int EXIT_COMPILE = 4;
 
 /** Const Strings */
+const string BATCH_STRING = "Usage: ClangEx [options] [source...]\n"
+        "Runs ClangEx once on a compilation database or a set of files and\n"
+        "streams the resolved TA model to a file or to standard output.\n"
+        "Run with no arguments for the interactive shell.\n\n"
+        "Only the output is streamed. The model is built in memory before\n"
+        "it's written, including with --jobs above 1, where the files are\n"
+        "extracted in parallel straight into one graph. Use --low to keep\n"
+        "the model on disk instead; it runs a single job.\n\n"
+        "With --serve, ClangEx keeps the model loaded and answers requests\n"
+        "on a Unix domain socket, one per line:\n"
+        "  add <path>...      : Adds and extracts files or directories.\n"
+        "  compdb <database>  : Adds and extracts a compilation database.\n"
+        "  update [file...]   : Re-extracts tracked files that changed and\n"
+        "                       removes the ones that were deleted.\n"
+        "  remove <file>...   : Removes files and their facts.\n"
+        "  query <name>       : Lists entities with a name and their relations.\n"
+        "  dump [file]        : Writes the model to a file or streams it back.\n"
+        "  status             : Prints the size of the model.\n"
+        "  shutdown           : Stops the server.\n"
+        "Replies end with a line starting with OK or ERROR.\n\n"
+        "With --watch, ClangEx stays running and re-extracts files and the\n"
+        "files that include them when they're saved. The model in --out is\n"
+        "replaced after every change. It can be combined with --serve.\n\n"
+        "Exit codes:\n"
+        "  0 : The model was written.\n"
+        "  1 : The arguments or inputs were invalid.\n"
+        "  2 : The model could not be generated.\n"
+        "  3 : The model could not be written.\n"
+        "  4 : The model was written but some files had compilation errors.\n";
 const string HELP_STRING = "Commands that can be used:\n"
         "help           : Prints help information.\n"
         "about          : Prints about information.\n"
         "quit(!)        : Quits the program.\n"
         "add            : Adds files to be processed.\n"
         "remove         : Removes files from queue.\n"
+        "compdb         : Adds files from a compilation database.\n"
         "list           : Lists the current tool state.\n"
         "enable         : Enables a collection of language features.\n"
         "disable        : Disables a collection of language features.\n"
         "generate       : Runs ClangEx on loaded files.\n"
+        "link           : Links fragments into a single graph.\n"
+        "watch          : Re-extracts loaded files whenever they change.\n"
         "output         : Outputs generated TA graphs to disk.\n"
         "recover        : Recovers a previous low-memory run.\n"
         "script         : Runs a script that handles program commands.\n"
@@ -206,6 +252,19 @@ void generateCommandSystem(map<string, ClangExHandler>* helpMap, map<string, str
             " that can be removed. Individual files can also be removed\ntoo. Only files that are in the queue to"
             " begin with can be removed.\n\n" + ss.str());
 
+    //Generate the help for compdb.
+    (*helpMap)[COMPDB_ARG] = ClangExHandler(COMPDB_ARG, po::options_description("Options"));
+    helpMap->at(COMPDB_ARG).desc->add_options()
+            ("help,h", "Print help message for compdb.")
+            ("include,i", po::value<std::vector<std::string>>(), "Only adds files matching this regular expression.")
+            ("exclude,e", po::value<std::vector<std::string>>(), "Skips files matching this regular expression.")
+            ("database,d", po::value<std::string>(), "The compile_commands.json file or its directory.");
+    ss.str(string());
+    ss << *helpMap->at(COMPDB_ARG).desc;
+    (*helpString)[COMPDB_ARG] = string("Compdb Help\nUsage: " + COMPDB_ARG + " [options] database\nAdds the files in a"
+            " compilation database to the queue. Each file is compiled\nwith the flags from the database. Duplicate"
+            " entries are skipped and files\nare ordered by directory.\n\n" + ss.str());
+
     //Generates the help for script.
     (*helpMap)[SCRIPT_ARG] = ClangExHandler(SCRIPT_ARG, po::options_description("Options"));
     helpMap->at(SCRIPT_ARG).desc->add_options()
@@ -246,13 +305,51 @@ void generateCommandSystem(map<string, ClangExHandler>* helpMap, map<string, str
             ("help,h", "Print help message for generate.")
             ("blob,b", "Runs ClangEx in blob mode.")
             ("low,l", "Enables low-memory mode.")
-            ("initial,i", po::value<std::string>(), "An initial TA file to load in to merge.");
+            ("approx,a", "Drops spilled duplicates with an approximate filter instead of an exact index.")
+            ("no-compress", "Writes low-memory spill files without compression.")
+            ("block-size", po::value<int>(), "The size of each compressed spill block in KiB.")
+            ("initial,i", po::value<std::string>(), "An initial TA file to load in to merge.")
+            ("fragments,f", po::value<std::string>(), "Writes a fragment for each file to this directory instead.")
+            ("usr,u", "Identifies entities by their Clang USR.")
+            ("skip-path", po::value<std::vector<std::string>>(), "Skips files matching this glob or \"regex:\" expression.")
+            ("only-path", po::value<std::vector<std::string>>(), "Only extracts files matching this glob or \"regex:\" expression.")
+            ("decls-only", "Skips function bodies so only declarations are extracted.")
+            ("jobs,j", po::value<int>(), "The number of files processed at once or threads reading --initial.")
+            ("heavy", po::value<int>(), "The number of memory heavy files processed at once with --fragments.")
+            ("stats", po::value<std::string>(), "Where the file timings used to order --fragments runs are kept.")
+            ("metrics,m", po::value<std::string>()->implicit_value("-"), "Writes timings and counters as JSON to this file.");
     ss.str(string());
     ss << *helpMap->at(GEN_ARG).desc;
     (*helpString)[GEN_ARG] = string("Generate Help\nUsage: " + GEN_ARG + " [options]\nGenerates a graph based on the supplied"
             " C/C++ source files.\nYou must have at least 1 source file in the queue for the graph to be generated.\n"
             "Additionally, in the root directory, there must a \"compile_commands.json\" file.\n\n" + ss.str());
 
+    //Generate the help for link.
+    (*helpMap)[LINK_ARG] = ClangExHandler(LINK_ARG, po::options_description("Options"));
+    helpMap->at(LINK_ARG).desc->add_options()
+            ("help,h", "Print help message for link.")
+            ("jobs,j", po::value<int>(), "The number of fragments to read at once.")
+            ("source,s", po::value<std::vector<std::string>>(), "A fragment or directory of fragments to link.");
+    ss.str(string());
+    ss << *helpMap->at(LINK_ARG).desc;
+    (*helpString)[LINK_ARG] = string("Link Help\nUsage: " + LINK_ARG + " [options] source...\nLinks fragments written by"
+            " \"generate --fragments\" into a single graph.\nFragments are read in parallel and duplicate entities are"
+            " merged before\nreferences and files are resolved.\n\n" + ss.str());
+
+    //Generate the help for watch.
+    (*helpMap)[WATCH_ARG] = ClangExHandler(WATCH_ARG, po::options_description("Options"));
+    helpMap->at(WATCH_ARG).desc->add_options()
+            ("help,h", "Print help message for watch.")
+            ("blob,b", "Runs ClangEx in blob mode.")
+            ("jobs,j", po::value<int>(), "The number of files processed at once.")
+            ("serve", po::value<std::string>(), "Also answers requests on this Unix domain socket.")
+            ("outputFile", po::value<std::string>(), "The TA file that is kept up to date.");
+    ss.str(string());
+    ss << *helpMap->at(WATCH_ARG).desc;
+    (*helpString)[WATCH_ARG] = string("Watch Help\nUsage: " + WATCH_ARG + " [options] outputFile\nExtracts the loaded"
+            " files and keeps watching their directories.\nWhen a file is saved, it and the files that include it are"
+            " re-extracted\nand the output file is replaced. Press Ctrl-C to stop watching.\n\n" + ss.str());
+
     //Generate the help for recover.
     (*helpMap)[RECOVER_ARG] = ClangExHandler(RECOVER_ARG, po::options_description("Options"));
     helpMap->at(RECOVER_ARG).desc->add_options()
@@ -460,6 +557,60 @@ void processRemove(string line, po::options_description desc){
     for (int i = 0; i < argc; i++) delete[] argv[i];
 }
 
+/**
+ * Processes the compdb option. Adds files from a compilation database.
+ * @param line The line entered.
+ * @param desc The options configured.
+ */
+void processCompdb(string line, po::options_description desc){
+    //Generates the arguments.
+    vector<string> tokens = tokenizeBySpace(line);
+    char** argv = createArgv(tokens);
+    int argc = (int) tokens.size();
+
+    //Processes the command line args.
+    po::positional_options_description positionalOptions;
+    positionalOptions.add("database", 1);
+
+    po::variables_map vm;
+    string database = "";
+    vector<string> includes;
+    vector<string> excludes;
+    try {
+        po::store(po::command_line_parser(argc, (const char* const*) argv).options(desc)
+                          .positional(positionalOptions).run(), vm);
+        po::notify(vm);
+
+        if (vm.count("help")) {
+            cout << "Usage: compdb [options] database" << endl << desc;
+            for (int i = 0; i < argc; i++) delete[] argv[i];
+            delete[] argv;
+            return;
+        }
+
+        if (!vm.count("database")) throw po::error("You must include a compilation database to add from.");
+        database = vm["database"].as<std::string>();
+        if (vm.count("include")) includes = vm["include"].as<vector<string>>();
+        if (vm.count("exclude")) excludes = vm["exclude"].as<vector<string>>();
+    } catch(po::error& e) {
+        cerr << "Error: " << e.what() << endl;
+        cerr << desc;
+        for (int i = 0; i < argc; i++) delete[] argv[i];
+        delete[] argv;
+        return;
+    }
+
+    //Adds the files.
+    int numAdded = driver.addByCompilationDatabase(database, includes, excludes);
+    if (numAdded >= 0) {
+        cout << numAdded << " source files were added from the compilation database " << database << "!" << endl;
+        changed = true;
+    }
+
+    for (int i = 0; i < argc; i++) delete[] argv[i];
+    delete[] argv;
+}
+
 /**
  * Processes the list option. Shows the status of the program.
  * @param line The line entered.
@@ -570,6 +721,17 @@ void processDisable(string line){
     }
 }
 
+/**
+ * Writes the metrics of the last run and turns them off.
+ * @param fileName The file to write to, - for the console or empty for none.
+ */
+void writeMetrics(string fileName){
+    if (fileName.compare("") == 0) return;
+
+    if (!Metrics::writeJSON(fileName)) cerr << "Error: The metrics could not be written to " << fileName << "." << endl;
+    Metrics::setEnabled(false);
+}
+
 /**
  * Processes the generate option. Generates a TA file for the user.
  * @param line The line entered.
@@ -583,7 +745,16 @@ void processGenerate(string line, po::options_description desc){
 
     bool blobMode = false;
     string mergeFile = "";
+    string fragmentDir = "";
     bool lowMemory = false;
+    bool usrMode = false;
+    PathFilter pathFilter;
+    bool declsOnly = false;
+    int jobs = 1;
+    int heavyLimit = 0;
+    string statsLocation = "";
+    string metricsFile = "";
+    LowMemoryTAGraph::LowMemoryConfig lowMemoryConfig;
     po::variables_map vm;
     try {
         po::store(po::parse_command_line(argc, (const char *const *) argv, desc), vm);
@@ -605,6 +776,52 @@ void processGenerate(string line, po::options_description desc){
         if (vm.count("low")){
             lowMemory = true;
         }
+        if (vm.count("approx")){
+            lowMemoryConfig.exactDedup = false;
+        }
+        if (vm.count("no-compress")){
+            lowMemoryConfig.compress = false;
+        }
+        if (vm.count("block-size")){
+            int blockSize = vm["block-size"].as<int>();
+            if (blockSize <= 0) throw po::error("The block size must be a positive number of KiB!");
+            if (blockSize > SpillFormat::MAX_BLOCK_SIZE / 1024)
+                throw po::error("The block size can be at most " + to_string(SpillFormat::MAX_BLOCK_SIZE / 1024) + " KiB!");
+            lowMemoryConfig.blockSize = blockSize * 1024;
+        }
+        if (vm.count("usr")){
+            usrMode = true;
+        }
+        if (vm.count("decls-only")){
+            declsOnly = true;
+        }
+        if (vm.count("skip-path")){
+            for (string pattern : vm["skip-path"].as<std::vector<std::string>>())
+                if (!pathFilter.addExclude(pattern)) throw po::error("The path pattern " + pattern + " is not valid!");
+        }
+        if (vm.count("only-path")){
+            for (string pattern : vm["only-path"].as<std::vector<std::string>>())
+                if (!pathFilter.addInclude(pattern)) throw po::error("The path pattern " + pattern + " is not valid!");
+        }
+        if (vm.count("fragments")){
+            fragmentDir = vm["fragments"].as<std::string>();
+            if (lowMemory || mergeFile.compare("") != 0)
+                throw po::error("The --fragments option cannot be used with --low or --initial!");
+        }
+        if (vm.count("jobs") || vm.count("heavy")){
+            if (vm.count("heavy") && !vm.count("fragments")) throw po::error("The --heavy option requires --fragments!");
+            if (vm.count("jobs") && vm.count("low")) throw po::error("The --jobs option cannot be used with --low!");
+            if (vm.count("jobs")) jobs = vm["jobs"].as<int>();
+            if (vm.count("heavy")) heavyLimit = vm["heavy"].as<int>();
+            if (jobs <= 0 || heavyLimit < 0) throw po::error("The number of jobs must be positive!");
+        }
+        if (vm.count("stats")){
+            if (!vm.count("fragments")) throw po::error("The --stats option requires --fragments!");
+            statsLocation = vm["stats"].as<std::string>();
+        }
+        if (vm.count("metrics")){
+            metricsFile = vm["metrics"].as<std::string>();
+        }
     } catch(po::error& e) {
         cerr << "Error: " << e.what() << endl;
         cerr << desc;
@@ -622,7 +839,25 @@ void processGenerate(string line, po::options_description desc){
 
     //Next, tells ClangEx to generate them.
     cout << "Processing " << numFiles << " file(s)..." << endl << "This may take some time!" << endl << endl;
-    bool success = driver.processAllFiles(blobMode, mergeFile, lowMemory);
+    driver.setUSRMode(usrMode);
+    driver.setPathFilter(pathFilter);
+    driver.setDeclsOnly(declsOnly);
+    driver.setStatsLocation(statsLocation);
+    Metrics::setEnabled(metricsFile.compare("") != 0);
+    Metrics::reset();
+    if (fragmentDir.compare("") != 0) {
+        if (driver.generateFragments(blobMode, fragmentDir, jobs, heavyLimit)) {
+            cout << numFiles << " fragment(s) were written to " << fragmentDir << "!" << endl
+                 << "Use the " << LINK_ARG << " command to combine them." << endl;
+        }
+        writeMetrics(metricsFile);
+        for (int i = 0; i < argc; i++) delete[] argv[i];
+        delete[] argv;
+        return;
+    }
+
+    driver.setLowMemoryConfig(lowMemoryConfig);
+    bool success = driver.processAllFiles(blobMode, mergeFile, lowMemory, 0, jobs);
 
     //Checks the success of the operation.
     if (success) {
@@ -630,6 +865,138 @@ void processGenerate(string line, po::options_description desc){
              << "Graph number is #" << driver.getNumGraphs() - 1 << "." << endl;
         changed = true;
     }
+    writeMetrics(metricsFile);
+
+    for (int i = 0; i < argc; i++) delete[] argv[i];
+    delete[] argv;
+}
+
+/**
+ * Processes the link option. Links fragments into a graph.
+ * @param line The line entered.
+ * @param desc The options configured.
+ */
+void processLink(string line, po::options_description desc){
+    //Generates the arguments.
+    vector<string> tokens = tokenizeBySpace(line);
+    char** argv = createArgv(tokens);
+    int argc = (int) tokens.size();
+
+    //Processes the command line args.
+    po::positional_options_description positionalOptions;
+    positionalOptions.add("source", -1);
+
+    po::variables_map vm;
+    vector<string> sources;
+    int jobs = (int) thread::hardware_concurrency();
+    try {
+        po::store(po::command_line_parser(argc, (const char* const*) argv).options(desc)
+                          .positional(positionalOptions).run(), vm);
+        po::notify(vm);
+
+        if (vm.count("help")) {
+            cout << "Usage: link [options] source..." << endl << desc;
+            for (int i = 0; i < argc; i++) delete[] argv[i];
+            delete[] argv;
+            return;
+        }
+
+        if (vm.count("jobs")){
+            jobs = vm["jobs"].as<int>();
+            if (jobs <= 0) throw po::error("The number of jobs must be positive!");
+        }
+        if (!vm.count("source")) throw po::error("You must include at least one fragment or directory to link.");
+        sources = vm["source"].as<vector<string>>();
+    } catch(po::error& e) {
+        cerr << "Error: " << e.what() << endl;
+        cerr << desc;
+        for (int i = 0; i < argc; i++) delete[] argv[i];
+        delete[] argv;
+        return;
+    }
+
+    //Links the fragments.
+    bool success = driver.linkFragments(sources, jobs);
+    if (success) {
+        cout << "ClangEx contribution graph was linked successfully!" << endl
+             << "Graph number is #" << driver.getNumGraphs() - 1 << "." << endl;
+        changed = true;
+    }
+
+    for (int i = 0; i < argc; i++) delete[] argv[i];
+    delete[] argv;
+}
+
+/**
+ * Processes the watch option. Extracts the queued files and updates
+ * the model as they change until interrupted.
+ * @param line The line entered.
+ * @param desc The options configured.
+ */
+void processWatch(string line, po::options_description desc){
+    //Generates the arguments.
+    vector<string> tokens = tokenizeBySpace(line);
+    char** argv = createArgv(tokens);
+    int argc = (int) tokens.size();
+
+    //Processes the command line args.
+    po::positional_options_description positionalOptions;
+    positionalOptions.add("outputFile", 1);
+
+    po::variables_map vm;
+    bool blobMode = false;
+    int jobs = 1;
+    string socketPath = "";
+    string outputFile = "";
+    try {
+        po::store(po::command_line_parser(argc, (const char* const*) argv).options(desc)
+                          .positional(positionalOptions).run(), vm);
+        po::notify(vm);
+
+        if (vm.count("help")) {
+            cout << "Usage: watch [options] outputFile" << endl << desc;
+            for (int i = 0; i < argc; i++) delete[] argv[i];
+            delete[] argv;
+            return;
+        }
+
+        if (vm.count("blob")){
+            blobMode = true;
+        }
+        if (vm.count("jobs")){
+            jobs = vm["jobs"].as<int>();
+            if (jobs <= 0) throw po::error("The number of jobs must be positive!");
+        }
+        if (vm.count("serve")){
+            socketPath = vm["serve"].as<std::string>();
+        }
+        if (vm.count("outputFile")){
+            outputFile = vm["outputFile"].as<std::string>();
+        }
+        if (outputFile.compare("") == 0 && socketPath.compare("") == 0)
+            throw po::error("You must give an output file or a socket to serve on.");
+    } catch(po::error& e) {
+        cerr << "Error: " << e.what() << endl;
+        cerr << desc;
+        for (int i = 0; i < argc; i++) delete[] argv[i];
+        delete[] argv;
+        return;
+    }
+
+    //Checks whether we can watch.
+    if (driver.getNumFiles() == 0) {
+        cerr << "No files are in the queue to be processed. Add some before you continue." << endl;
+        for (int i = 0; i < argc; i++) delete[] argv[i];
+        delete[] argv;
+        return;
+    }
+
+    //Runs until the user interrupts.
+    ExtractServer* server = new ExtractServer(&driver, socketPath, blobMode, jobs);
+    if (server->start() && server->extractQueued() >= 0 && server->enableWatch(outputFile)) {
+        server->run();
+    }
+    delete server;
 
     for (int i = 0; i < argc; i++) delete[] argv[i];
     delete[] argv;
@@ -841,6 +1208,9 @@ bool processCommand(string line) {
     } else if (!line.compare(0, REMOVE_ARG.size(), REMOVE_ARG) &&
                (line[REMOVE_ARG.size()] == ' ' || line.size() == REMOVE_ARG.size())) {
         processRemove(line, *(helpInfo.at(REMOVE_ARG).desc.get()));
+    } else if (!line.compare(0, COMPDB_ARG.size(), COMPDB_ARG) &&
+               (line[COMPDB_ARG.size()] == ' ' || line.size() == COMPDB_ARG.size())) {
+        processCompdb(line, *(helpInfo.at(COMPDB_ARG).desc.get()));
     } else if (!line.compare(0, LIST_ARG.size(), LIST_ARG) &&
                (line[LIST_ARG.size()] == ' ' || line.size() == LIST_ARG.size())) {
         processList(line, *(helpInfo.at(LIST_ARG).desc.get()));
@@ -853,6 +1223,12 @@ bool processCommand(string line) {
     } else if (!line.compare(0, GEN_ARG.size(), GEN_ARG) &&
                (line[GEN_ARG.size()] == ' ' || line.size() == GEN_ARG.size())) {
         processGenerate(line, *(helpInfo.at(GEN_ARG).desc.get()));
+    } else if (!line.compare(0, LINK_ARG.size(), LINK_ARG) &&
+               (line[LINK_ARG.size()] == ' ' || line.size() == LINK_ARG.size())) {
+        processLink(line, *(helpInfo.at(LINK_ARG).desc.get()));
+    } else if (!line.compare(0, WATCH_ARG.size(), WATCH_ARG) &&
+               (line[WATCH_ARG.size()] == ' ' || line.size() == WATCH_ARG.size())) {
+        processWatch(line, *(helpInfo.at(WATCH_ARG).desc.get()));
     } else if (!line.compare(0, OUT_ARG.size(), OUT_ARG) &&
                (line[OUT_ARG.size()] == ' ' || line.size() == OUT_ARG.size())) {
         processOutput(line, *(helpInfo.at(OUT_ARG).desc.get()));
@@ -872,6 +1248,138 @@ bool processCommand(string line) {
     return true;
 }
 
+/**
+ * Runs ClangEx once from the command line without the shell. Progress
+ * goes to standard error when the model is written to standard output.
+ * @param argc The number of arguments.
+ * @param argv The arguments.
+ * @return The batch exit code.
+ */
+int processBatch(int argc, const char **argv){
+    po::options_description desc("Options");
+    desc.add_options()
+            ("help,h", "Print help message.")
+            ("build-path,p", po::value<std::string>(), "The compile_commands.json file or its directory.")
+            ("include,i", po::value<std::vector<std::string>>(), "Only adds database files matching this regular expression.")
+            ("exclude,e", po::value<std::vector<std::string>>(), "Skips database files matching this regular expression.")
+            ("source,s", po::value<std::vector<std::string>>(), "A file or directory to process.")
+            ("out,o", po::value<std::string>()->default_value("-"), "The TA file to write or - for standard output.")
+            ("jobs,j", po::value<int>()->default_value(1), "The number of files processed at once. The model is kept in memory.")
+            ("blob,b", "Runs ClangEx in blob mode.")
+            ("low,l", "Enables low-memory mode.")
+            ("usr,u", "Identifies entities by their Clang USR.")
+            ("metrics,m", po::value<std::string>(), "Writes timings and counters as JSON to this file.")
+            ("stats", po::value<std::string>(), "Where the file timings used to order --serve extractions are kept.")
+            ("serve", po::value<std::string>(), "Runs as a server on this Unix domain socket.")
+            ("watch,w", "Re-extracts files when they change until stopped.");
+    po::positional_options_description positionalOptions;
+    positionalOptions.add("source", -1);
+
+    //Parses the arguments.
+    po::variables_map vm;
+    try {
+        po::store(po::command_line_parser(argc, argv).options(desc).positional(positionalOptions).run(), vm);
+        po::notify(vm);
+    } catch(po::error& e) {
+        cerr << "Error: " << e.what() << endl << BATCH_STRING << endl << desc;
+        return EXIT_USAGE;
+    }
+    if (vm.count("help")) {
+        cout << BATCH_STRING << endl << desc;
+        return EXIT_OK;
+    }
+
+    string out = vm["out"].as<std::string>();
+    int jobs = vm["jobs"].as<int>();
+    bool blobMode = vm.count("blob") > 0;
+    bool lowMemory = vm.count("low") > 0;
+    string metricsFile = (vm.count("metrics")) ? vm["metrics"].as<std::string>() : "";
+    bool watch = vm.count("watch") > 0;
+    bool serve = vm.count("serve") > 0 || watch;
+    if (jobs <= 0 || (jobs > 1 && lowMemory) || (serve && lowMemory)) {
+        cerr << "Error: The number of jobs must be positive and --low only supports a single job without --serve." << endl;
+        return EXIT_USAGE;
+    }
+    if (watch && !vm.count("serve") && out.compare("-") == 0) {
+        cerr << "Error: --watch needs an output file or --serve." << endl;
+        return EXIT_USAGE;
+    }
+
+    //Keeps standard output for the model.
+    bool toStdout = !serve && out.compare("-") == 0;
+    streambuf* coutBuf = cout.rdbuf();
+    if (toStdout) cout.rdbuf(cerr.rdbuf());
+
+    //Adds the files.
+    if (vm.count("build-path")) {
+        vector<string> includes, excludes;
+        if (vm.count("include")) includes = vm["include"].as<std::vector<std::string>>();
+        if (vm.count("exclude")) excludes = vm["exclude"].as<std::vector<std::string>>();
+        if (driver.addByCompilationDatabase(vm["build-path"].as<std::string>(), includes, excludes) < 0) {
+            cout.rdbuf(coutBuf);
+            return EXIT_USAGE;
+        }
+    }
+    if (vm.count("source")) {
+        for (string source : vm["source"].as<std::vector<std::string>>()) driver.addByPath(path(source));
+    }
+
+    //Serves requests with the files as the starting model.
+    if (serve) {
+        driver.setUSRMode(vm.count("usr") > 0);
+        if (vm.count("stats")) driver.setStatsLocation(vm["stats"].as<std::string>());
+        string socketPath = (vm.count("serve")) ? vm["serve"].as<std::string>() : "";
+        ExtractServer* server = new ExtractServer(&driver, socketPath, blobMode, jobs);
+        int code = EXIT_OK;
+        if (!server->start()) {
+            code = EXIT_USAGE;
+        } else if (server->extractQueued() < 0) {
+            code = EXIT_EXTRACT;
+        } else if (watch && !server->enableWatch((out.compare("-") == 0) ? "" : out)) {
+            code = EXIT_OUTPUT;
+        } else {
+            server->run();
+        }
+
+        delete server;
+        driver.cleanup();
+        return code;
+    }
+    if (driver.getNumFiles() == 0) {
+        cerr << "Error: No files were found to process." << endl;
+        cout.rdbuf(coutBuf);
+        return EXIT_USAGE;
+    }
+
+    //Generates the model.
+    driver.setUSRMode(vm.count("usr") > 0);
+    Metrics::setEnabled(metricsFile.compare("") != 0);
+    Metrics::reset();
+    bool success = driver.processAllFiles(blobMode, "", lowMemory, 0, jobs);
+    if (!success || driver.getNumGraphs() == 0) {
+        cerr << "Error: The model could not be generated." << endl;
+        driver.cleanup();
+        cout.rdbuf(coutBuf);
+        return EXIT_EXTRACT;
+    }
+
+    //Streams the model.
+    int fd = (toStdout) ? STDOUT_FILENO : open(out.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    bool written = fd >= 0 && driver.outputModelStream(driver.getNumGraphs() - 1, fd);
+    if (!toStdout && fd >= 0 && close(fd) != 0) written = false;
+    writeMetrics(metricsFile);
+
+    int code = (driver.hadCompileErrors()) ? EXIT_COMPILE : EXIT_OK;
+    if (!written) {
+        cerr << "Error: The model could not be written to " << out << "." << endl;
+        code = EXIT_OUTPUT;
+    }
+
+    driver.cleanup();
+    cout.rdbuf(coutBuf);
+    return code;
+}
+
 /**
  * The main method. Drives the entire program.
  * @param argc The number of arguments.
@@ -879,15 +1387,12 @@ bool processCommand(string line) {
  * @return Status code.
  */
 int main(int argc, const char **argv){
+    //Runs once when we have arguments.
+    if (argc > 1) return processBatch(argc, argv);
+
     //Starts by printing the header.
     printHeader();
 
-    //Checks if we have arguments.
-    if (argc > 1){
-        cerr << "Run " << argv[0] << " with no arguments!" << endl;
-        return 1;
-    }
-
     //Gets the username.
     string username;
     try {
@@ -54,6 +54,14 @@ void FileParse::addPath(string path) {
     paths.push_back(path);
 }
 
+/**
+ * Gets the paths that were added.
+ * @return The list of paths.
+ */
+vector<string> FileParse::getPaths() {
+    return paths;
+}
+
 /**
  * Creates nodes and edges for every single path that was added to the list.
  * @param nodes The created nodes. (Should be empty on invocation).
@@ -41,6 +41,7 @@ public:
     /** Path Creation Operations */
     void addPath(std::string path);
     void processPaths(std::vector<ClangNode*>& nodes, std::vector<ClangEdge*>& edges);
+    std::vector<std::string> getPaths();
 
 private:
     /** Member Variables */
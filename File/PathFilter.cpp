@@ -0,0 +1,180 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// PathFilter.cpp
+//
+// Created By: Bryan J Muscedere
+// Date: 19/10/26.
+//
+// Filter that decides which files facts are extracted from. Paths are
+// matched against globs such as "third_party/**" or "*/generated/*"
+// and against regular expressions. Patterns that match a directory
+// also match everything inside of it.
+//
+// Copyright (C) 2017, Bryan J. Muscedere
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <boost/filesystem.hpp>
+#include "PathFilter.h"
+
+using namespace std;
+
+/** Pattern Prefixes */
+const string PathFilter::REGEX_PREFIX = "regex:";
+
+/**
+ * Creates a filter that lets every path through.
+ */
+PathFilter::PathFilter() { }
+
+/**
+ * Destructor.
+ */
+PathFilter::~PathFilter() { }
+
+/**
+ * Adds a pattern for the files that are extracted. Once there is at
+ * least one, files that match none of them are skipped.
+ * @param pattern The glob or "regex:" expression.
+ * @return Whether the pattern is valid.
+ */
+bool PathFilter::addInclude(string pattern){
+    return compilePattern(pattern, includes);
+}
+
+/**
+ * Adds a pattern for the files that are skipped.
+ * @param pattern The glob or "regex:" expression.
+ * @return Whether the pattern is valid.
+ */
+bool PathFilter::addExclude(string pattern){
+    return compilePattern(pattern, excludes);
+}
+
+/**
+ * Removes every pattern.
+ */
+void PathFilter::clear(){
+    includes.clear();
+    excludes.clear();
+}
+
+/**
+ * Checks whether the filter has any patterns.
+ * @return Whether every path gets through.
+ */
+bool PathFilter::isEmpty(){
+    return includes.size() == 0 && excludes.size() == 0;
+}
+
+/**
+ * Checks whether a file is skipped.
+ * @param path The canonical path of the file.
+ * @return Whether the file is skipped.
+ */
+bool PathFilter::isExcluded(const string& path) const {
+    if (includes.size() > 0 && !matchesAny(path, includes)) return true;
+    return matchesAny(path, excludes);
+}
+
+/**
+ * Checks whether a file of a translation unit is skipped. The path of
+ * each file is only made canonical and matched once.
+ * @param srcMgr The source manager of the translation unit.
+ * @param fileID The file.
+ * @param cache The results for files already checked.
+ * @return Whether the file is skipped.
+ */
+bool PathFilter::isExcluded(const clang::SourceManager& srcMgr, clang::FileID fileID, ResultCache* cache) const {
+    auto cached = cache->find(fileID.getHashValue());
+    if (cached != cache->end()) return cached->second;
+
+    //Matches the canonical path of the file.
+    bool excluded = false;
+    const clang::FileEntry* entry = srcMgr.getFileEntryForID(fileID);
+    if (entry != nullptr) {
+        string fileName(entry->getName());
+        boost::system::error_code error;
+        boost::filesystem::path filePath = canonical(boost::filesystem::path(fileName), error);
+        excluded = isExcluded((error) ? fileName : filePath.string());
+    }
+
+    (*cache)[fileID.getHashValue()] = excluded;
+    return excluded;
+}
+
+/**
+ * Converts a glob into a regular expression. A "**" matches any
+ * number of directories while "*" and "?" stay within one. Globs that
+ * don't start with a slash can match at any directory.
+ * @param glob The glob to convert.
+ * @return The regular expression.
+ */
+string PathFilter::globToRegex(string glob){
+    string regex = (glob.size() > 0 && glob.at(0) == '/') ? "" : "(.*/)?";
+    const string special = ".^$|()[]{}+\\";
+
+    for (int i = 0; i < glob.size(); i++){
+        char cur = glob.at(i);
+        if (cur == '*' && i + 1 < glob.size() && glob.at(i + 1) == '*'){
+            regex += ".*";
+            i++;
+        } else if (cur == '*'){
+            regex += "[^/]*";
+        } else if (cur == '?'){
+            regex += "[^/]";
+        } else {
+            if (special.find(cur) != string::npos) regex += '\\';
+            regex += cur;
+        }
+    }
+
+    //Directories match everything inside of them.
+    if (regex.size() > 0 && regex.back() == '/') regex.pop_back();
+    return regex + "(/.*)?";
+}
+
+/**
+ * Compiles a pattern and adds it to a list.
+ * @param pattern The glob or "regex:" expression.
+ * @param patterns The list to add to.
+ * @return Whether the pattern is valid.
+ */
+bool PathFilter::compilePattern(string pattern, vector<regex>& patterns){
+    if (pattern.compare("") == 0) return false;
+
+    string expr = (pattern.compare(0, REGEX_PREFIX.size(), REGEX_PREFIX) == 0) ?
+                  pattern.substr(REGEX_PREFIX.size()) : globToRegex(pattern);
+    try {
+        patterns.push_back(regex(expr, regex::optimize));
+    } catch (regex_error& e) {
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Checks whether a path matches any pattern in a list.
+ * @param path The path to check.
+ * @param patterns The patterns.
+ * @return Whether one of them matched.
+ */
+bool PathFilter::matchesAny(const string& path, const vector<regex>& patterns){
+    for (const regex& cur : patterns){
+        if (regex_match(path, cur)) return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,72 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// PathFilter.h
+//
+// Created By: Bryan J Muscedere
+// Date: 19/10/26.
+//
+// Filter that decides which files facts are extracted from. Paths are
+// matched against globs such as "third_party/**" or "*/generated/*"
+// and against regular expressions. Patterns that match a directory
+// also match everything inside of it.
+//
+// Copyright (C) 2017, Bryan J. Muscedere
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CLANGEX_PATHFILTER_H
+#define CLANGEX_PATHFILTER_H
+
+#include <regex>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "clang/Basic/SourceManager.h"
+
+class PathFilter {
+public:
+    /** Results by File */
+    typedef std::unordered_map<unsigned, bool> ResultCache;
+
+    /** Constructor/Destructor */
+    PathFilter();
+    ~PathFilter();
+
+    /** Pattern Operations */
+    bool addInclude(std::string pattern);
+    bool addExclude(std::string pattern);
+    void clear();
+    bool isEmpty();
+
+    /** Matching Operations */
+    bool isExcluded(const std::string& path) const;
+    bool isExcluded(const clang::SourceManager& srcMgr, clang::FileID fileID, ResultCache* cache) const;
+
+    /** Pattern Conversion */
+    static std::string globToRegex(std::string glob);
+
+    const static std::string REGEX_PREFIX;
+
+private:
+    /** Pattern Variables */
+    std::vector<std::regex> includes;
+    std::vector<std::regex> excludes;
+
+    /** Helper Methods */
+    static bool compilePattern(std::string pattern, std::vector<std::regex>& patterns);
+    static bool matchesAny(const std::string& path, const std::vector<std::regex>& patterns);
+};
+
+
+#endif //CLANGEX_PATHFILTER_H
@@ -24,6 +24,7 @@
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 /////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
 #include "ClangEdge.h"
 
 using namespace std;
@@ -48,6 +49,8 @@ string ClangEdge::getTypeString(EdgeType type) {
         return "inherit";
     } else if (type == FILE_CONTAIN){
         return "fContain";
+    } else if (type == INCLUDES){
+        return "include";
     }
 
     //Default if the type isn't defined.
@@ -61,7 +64,7 @@ string ClangEdge::getTypeString(EdgeType type) {
  */
 ClangEdge::EdgeType ClangEdge::getTypeEdge(string name){
     //Goes through and checks for type.
-    if (name.compare("contains") == 0){
+    if (name.compare("contain") == 0){
         return CONTAINS;
     } else if (name.compare("call") == 0){
         return CALLS;
@@ -71,6 +74,8 @@ ClangEdge::EdgeType ClangEdge::getTypeEdge(string name){
         return INHERITS;
     } else if (name.compare("fContain") == 0){
         return FILE_CONTAIN;
+    } else if (name.compare("include") == 0){
+        return INCLUDES;
     }
 
     //Default if the type isn't defined.
@@ -232,6 +237,17 @@ void ClangEdge::setDst(ClangNode* newDst){
     if (src && dst) unresolved = false;
 }
 
+/**
+ * Detaches the edge from a node that is being removed. The IDs are
+ * kept so the edge can be resolved again later.
+ * @param node The node being removed.
+ */
+void ClangEdge::unresolve(ClangNode* node){
+    if (src == node) src = nullptr;
+    if (dst == node) dst = nullptr;
+    if (!src || !dst) unresolved = true;
+}
+
 /**
  * Adds an attribute.
  * @param key The key to add.
@@ -261,6 +277,25 @@ bool ClangEdge::clearAttribute(string key){
     return true;
 }
 
+/**
+ * Removes a single value of an attribute.
+ * @param key The key of the attribute.
+ * @param value The value to remove.
+ * @return Whether the value was removed.
+ */
+bool ClangEdge::removeAttribute(string key, string value){
+    auto it = edgeAttributes.find(key);
+    if (it == edgeAttributes.end()) return false;
+
+    vector<string>& values = it->second;
+    auto pos = find(values.begin(), values.end(), value);
+    if (pos == values.end()) return false;
+
+    values.erase(pos);
+    if (values.size() == 0) edgeAttributes.erase(it);
+    return true;
+}
+
 /**
  * Gets an attribute based on a key.
  * @param key The key to add.
@@ -128,7 +128,7 @@ private:
 
 public:
     /** Edge Type Members */
-    enum EdgeType {CALLS, REFERENCES, CONTAINS, INHERITS, FILE_CONTAIN};
+    enum EdgeType {CALLS, REFERENCES, CONTAINS, INHERITS, FILE_CONTAIN, INCLUDES};
     static std::string getTypeString(EdgeType type);
     static ClangEdge::EdgeType getTypeEdge(std::string name);
 
@@ -152,10 +152,12 @@ public:
     /** Setters */
     void setSrc(ClangNode* newSrc);
     void setDst(ClangNode* newDst);
+    void unresolve(ClangNode* node);
 
     /** Attribute Getters/Setters */
     bool addAttribute(std::string key, std::string value);
     bool clearAttribute(std::string key);
+    bool removeAttribute(std::string key, std::string value);
     std::vector<std::string> getAttribute(std::string key);
     bool doesAttributeExist(std::string key, std::string value);
     std::map<std::string, std::vector<std::string>> getAttributes();
@@ -24,6 +24,7 @@
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 /////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
 #include "ClangNode.h"
 
 using namespace std;
@@ -170,6 +171,15 @@ ClangNode::NodeType ClangNode::getType(){
     return type;
 }
 
+/**
+ * Sets the name of the node.
+ * @param name The new name of the node.
+ */
+void ClangNode::setName(string name){
+    nodeAttributes[NAME_FLAG] = vector<string>();
+    nodeAttributes[NAME_FLAG].push_back(name);
+}
+
 /**
  * Adds an attribute to the node.
  * @param key The key of the attribute.
@@ -200,6 +210,25 @@ bool ClangNode::clearAttributes(string key){
     return true;
 }
 
+/**
+ * Removes a single value of an attribute.
+ * @param key The key of the attribute.
+ * @param value The value to remove.
+ * @return Whether the value was removed.
+ */
+bool ClangNode::removeAttribute(string key, string value){
+    auto it = nodeAttributes.find(key);
+    if (it == nodeAttributes.end()) return false;
+
+    vector<string>& values = it->second;
+    auto pos = find(values.begin(), values.end(), value);
+    if (pos == values.end()) return false;
+
+    values.erase(pos);
+    if (values.size() == 0) nodeAttributes.erase(it);
+    return true;
+}
+
 /**
  * Gets an attribute for a given key.
  * @param key The key to look up.
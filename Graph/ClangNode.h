@@ -178,10 +178,12 @@ public:
     std::string getID();
     std::string getName();
     ClangNode::NodeType getType();
+    void setName(std::string name);
 
     /** Attribute Getters/Setters */
     bool addAttribute(std::string key, std::string value);
     bool clearAttributes(std::string key);
+    bool removeAttribute(std::string key, std::string value);
     std::vector<std::string> getAttribute(std::string key);
     bool doesAttributeExist(std::string key, std::string value);
     std::map<std::string, std::vector<std::string>> getAttributes();
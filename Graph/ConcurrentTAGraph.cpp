@@ -0,0 +1,278 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// ConcurrentTAGraph.cpp
+//
+// Created By: Bryan J Muscedere
+// Date: 19/10/26.
+//
+// Graph that several walker threads can add facts to at once. Nodes and
+// edges are split into shards by the hash of their ID and each shard
+// has its own lock. Once every thread is done, the facts are collected
+// into the regular graph so it can be resolved and written.
+//
+// Copyright (C) 2017, Bryan J. Muscedere
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <functional>
+#include <algorithm>
+#include "ConcurrentTAGraph.h"
+#include "../Metrics/Metrics.h"
+
+using namespace std;
+
+/** Serial Order of the Next Fact on This Thread */
+static thread_local uint64_t nextOrder = 0;
+
+/**
+ * Creates an empty graph.
+ * @param numShards The number of shards the facts are split into.
+ */
+ConcurrentTAGraph::ConcurrentTAGraph(int numShards) : TAGraph() {
+    collected = false;
+    if (numShards < 1) numShards = 1;
+    for (int i = 0; i < numShards; i++) shards.push_back(new Shard());
+}
+
+/**
+ * Deletes any facts that weren't collected.
+ */
+ConcurrentTAGraph::~ConcurrentTAGraph() {
+    for (Shard* shard : shards){
+        for (auto entry : shard->nodes) delete entry.second.node;
+        for (auto entry : shard->edges) delete entry.second.edge;
+        for (auto entry : shard->parents) delete entry.second.edge;
+        delete shard;
+    }
+}
+
+/**
+ * Adds a node. If the node already exists, the one a serial run
+ * would have added first is kept. Once the shards are collected,
+ * nodes are added to the graph directly.
+ * @param node The node to add.
+ * @param assumeValid Whether the node is assumed valid once collected.
+ * @return Whether the node was new.
+ */
+bool ConcurrentTAGraph::addNode(ClangNode* node, bool assumeValid){
+    if (collected) return TAGraph::addNode(node, assumeValid);
+
+    uint64_t order = nextOrder++;
+    Shard* shard = shards.at(getShard(node->getID()));
+    lock_guard<mutex> guard(shard->lock);
+    return upsertNode(shard, node, order);
+}
+
+/**
+ * Adds an edge. Edges are stored by ID and resolved when they're
+ * collected. Like nodes, duplicate edges keep the one a serial run
+ * would have added first, while an entity keeps the contains parent
+ * a serial run would have added last.
+ * @param edge The edge to add.
+ * @param assumeValid Whether the edge is assumed valid once collected.
+ * @return Whether the edge was new.
+ */
+bool ConcurrentTAGraph::addEdge(ClangEdge* edge, bool assumeValid){
+    if (collected) return TAGraph::addEdge(edge, assumeValid);
+
+    edge->unresolve(edge->getSrc());
+    edge->unresolve(edge->getDst());
+
+    uint64_t order = nextOrder++;
+    Shard* shard = shards.at(getEdgeShard(edge));
+    lock_guard<mutex> guard(shard->lock);
+    return upsertEdge(shard, edge, order);
+}
+
+/**
+ * Adds a file path.
+ * @param path The path to add.
+ */
+void ConcurrentTAGraph::addPath(string path){
+    if (collected) return TAGraph::addPath(path);
+
+    lock_guard<mutex> guard(pathLock);
+    paths.insert(path);
+}
+
+/**
+ * Moves the facts of one translation unit into the shards. The facts
+ * are grouped first so each shard is only locked once and are ordered
+ * the way a serial run would add them.
+ * @param buffer The graph holding the facts of the translation unit.
+ */
+void ConcurrentTAGraph::mergeGraph(TAGraph* buffer){
+    if (collected) return TAGraph::mergeGraph(buffer);
+
+    vector<vector<NodeEntry>> nodeGroups(shards.size());
+    vector<vector<EdgeEntry>> edgeGroups(shards.size());
+
+    //Groups the nodes and edges by shard.
+    for (auto entry : buffer->nodeList){
+        if (entry.second != nullptr) nodeGroups.at(getShard(entry.first)).push_back({entry.second, nextOrder++});
+    }
+    for (auto entry : buffer->edgeSrcList){
+        for (ClangEdge* edge : entry.second){
+            edge->unresolve(edge->getSrc());
+            edge->unresolve(edge->getDst());
+            edgeGroups.at(getEdgeShard(edge)).push_back({edge, nextOrder++});
+        }
+    }
+    buffer->nodeList.clear();
+    buffer->nodeNameList.clear();
+    buffer->edgeSrcList.clear();
+    buffer->edgeDstList.clear();
+
+    //Adds each group to its shard.
+    for (size_t i = 0; i < shards.size(); i++){
+        if (nodeGroups.at(i).size() == 0 && edgeGroups.at(i).size() == 0) continue;
+
+        Shard* shard = shards.at(i);
+        lock_guard<mutex> guard(shard->lock);
+        for (NodeEntry entry : nodeGroups.at(i)) upsertNode(shard, entry.node, entry.order);
+        for (EdgeEntry entry : edgeGroups.at(i)) upsertEdge(shard, entry.edge, entry.order);
+    }
+
+    //Moves the paths.
+    vector<string> bufferPaths = buffer->fileParser.getPaths();
+    buffer->fileParser = FileParse();
+    lock_guard<mutex> guard(pathLock);
+    paths.insert(bufferPaths.begin(), bufferPaths.end());
+}
+
+/**
+ * Starts the facts of a translation unit on this thread. Facts are
+ * ordered by the number of their translation unit first, so the
+ * result doesn't depend on the order the threads ran in.
+ * @param num The number of the translation unit.
+ */
+void ConcurrentTAGraph::startTU(int num){
+    nextOrder = (uint64_t) num << ORDER_BITS;
+}
+
+/**
+ * Moves the facts from the shards into the graph and resolves the
+ * edges. Must only be called once no other thread adds facts.
+ * Afterwards, the graph behaves like a regular graph.
+ */
+void ConcurrentTAGraph::collect(){
+    collected = true;
+
+    //Moves the nodes first so the edges can be resolved.
+    for (Shard* shard : shards){
+        for (auto entry : shard->nodes) TAGraph::addNode(entry.second.node);
+        shard->nodes.clear();
+    }
+
+    //Moves the edges.
+    for (Shard* shard : shards){
+        for (auto* edges : {&shard->edges, &shard->parents}){
+            for (auto entry : *edges){
+                ClangEdge* edge = entry.second.edge;
+                ClangNode* src = findNodeByID(edge->getSrcID());
+                ClangNode* dst = findNodeByID(edge->getDstID());
+                if (src) edge->setSrc(src);
+                if (dst) edge->setDst(dst);
+                TAGraph::addEdge(edge);
+            }
+            edges->clear();
+        }
+    }
+
+    //Moves the paths.
+    for (string path : paths) TAGraph::addPath(path);
+    paths.clear();
+}
+
+/**
+ * Gets the shard an ID belongs to.
+ * @param ID The ID.
+ * @return The shard number.
+ */
+size_t ConcurrentTAGraph::getShard(const string& ID){
+    return hash<string>()(ID) % shards.size();
+}
+
+/**
+ * Gets the shard an edge belongs to. Contains edges are kept with
+ * their destination so each entity's parent is in one place.
+ * @param edge The edge.
+ * @return The shard number.
+ */
+size_t ConcurrentTAGraph::getEdgeShard(ClangEdge* edge){
+    if (edge->getType() == ClangEdge::CONTAINS) return getShard(edge->getDstID());
+    return getShard(edge->getSrcID());
+}
+
+/**
+ * Adds a node to a locked shard. If the node already exists, the one
+ * with the smallest order is kept.
+ * @param shard The shard.
+ * @param node The node to add.
+ * @param order The serial order of the node.
+ * @return Whether the node was new.
+ */
+bool ConcurrentTAGraph::upsertNode(Shard* shard, ClangNode* node, uint64_t order){
+    auto it = shard->nodes.find(node->getID());
+    if (it == shard->nodes.end()){
+        shard->nodes[node->getID()] = {node, order};
+        return true;
+    }
+
+    //Keeps the node that was added first.
+    Metrics::increment(Metrics::DUPLICATE_NODES);
+    if (order < it->second.order) swap(it->second.node, node);
+    it->second.order = min(it->second.order, order);
+    delete node;
+    return false;
+}
+
+/**
+ * Adds an edge to a locked shard. If the edge already exists, the one
+ * with the smallest order is kept. For contains edges, the parent with
+ * the largest order is kept instead.
+ * @param shard The shard.
+ * @param edge The edge to add.
+ * @param order The serial order of the edge.
+ * @return Whether the edge was new.
+ */
+bool ConcurrentTAGraph::upsertEdge(Shard* shard, ClangEdge* edge, uint64_t order){
+    //Entities don't contain themselves.
+    bool contains = edge->getType() == ClangEdge::CONTAINS;
+    if (contains && edge->getSrcID().compare(edge->getDstID()) == 0){
+        delete edge;
+        return false;
+    }
+
+    //Looks up the edge or the current parent.
+    string key = (contains) ? edge->getDstID() :
+                 edge->getSrcID() + '\0' + edge->getDstID() + '\0' + to_string(edge->getType());
+    auto& edges = (contains) ? shard->parents : shard->edges;
+    auto it = edges.find(key);
+    if (it == edges.end()){
+        edges[key] = {edge, order};
+        return true;
+    }
+
+    //Keeps the edge that was added first or the parent that was added last.
+    bool replace = (contains) ? order > it->second.order : order < it->second.order;
+    if (!contains || edge->getSrcID().compare(it->second.edge->getSrcID()) == 0)
+        Metrics::increment(Metrics::DUPLICATE_EDGES);
+    if (replace){
+        swap(it->second.edge, edge);
+        it->second.order = order;
+    }
+    delete edge;
+    return false;
+}
@@ -0,0 +1,92 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// ConcurrentTAGraph.h
+//
+// Created By: Bryan J Muscedere
+// Date: 19/10/26.
+//
+// Graph that several walker threads can add facts to at once. Nodes and
+// edges are split into shards by the hash of their ID and each shard
+// has its own lock. Once every thread is done, the facts are collected
+// into the regular graph so it can be resolved and written.
+//
+// Copyright (C) 2017, Bryan J. Muscedere
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CLANGEX_CONCURRENTTAGRAPH_H
+#define CLANGEX_CONCURRENTTAGRAPH_H
+
+#include <mutex>
+#include <set>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "TAGraph.h"
+
+class ConcurrentTAGraph : public TAGraph {
+public:
+    /** Constructor/Destructor */
+    ConcurrentTAGraph(int numShards = DEFAULT_SHARDS);
+    ~ConcurrentTAGraph() override;
+
+    /** Concurrent Adders */
+    bool addNode(ClangNode* node, bool assumeValid = false) override;
+    bool addEdge(ClangEdge* edge, bool assumeValid = false) override;
+    void addPath(std::string path) override;
+    void mergeGraph(TAGraph* buffer) override;
+
+    /** Collection */
+    void startTU(int num);
+    void collect();
+
+    const static int DEFAULT_SHARDS = 64;
+
+private:
+    /** Facts and Their Serial Order */
+    typedef struct {
+        ClangNode* node;
+        uint64_t order;
+    } NodeEntry;
+    typedef struct {
+        ClangEdge* edge;
+        uint64_t order;
+    } EdgeEntry;
+
+    /** Shard of the Graph */
+    typedef struct {
+        std::mutex lock;
+        std::unordered_map<std::string, NodeEntry> nodes;
+        std::unordered_map<std::string, EdgeEntry> edges;
+        std::unordered_map<std::string, EdgeEntry> parents;
+    } Shard;
+
+    const static int ORDER_BITS = 32;
+
+    /** Shard Variables */
+    std::vector<Shard*> shards;
+    std::mutex pathLock;
+    std::set<std::string> paths;
+    bool collected;
+
+    /** Helper Methods */
+    size_t getShard(const std::string& ID);
+    size_t getEdgeShard(ClangEdge* edge);
+    bool upsertNode(Shard* shard, ClangNode* node, uint64_t order);
+    bool upsertEdge(Shard* shard, ClangEdge* edge, uint64_t order);
+};
+
+
+#endif //CLANGEX_CONCURRENTTAGRAPH_H
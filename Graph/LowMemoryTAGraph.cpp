@@ -24,13 +24,23 @@
 /////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include <fstream>
+#include <iostream>
+#include <sstream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
 #include <sys/stat.h>
+#include <sys/sendfile.h>
+#include <sys/syscall.h>
 #include <boost/algorithm/string.hpp>
 #include <cstdio>
 #include <boost/filesystem/operations.hpp>
 #include <boost/algorithm/string/split.hpp>
 #include <boost/algorithm/string/classification.hpp>
 #include "LowMemoryTAGraph.h"
+#include "../TupleAttribute/TAScanner.h"
+#include "../Metrics/Metrics.h"
 
 using namespace std;
 namespace bs = boost::filesystem;
@@ -38,20 +48,24 @@ namespace bs = boost::filesystem;
 /** Const Methods */
 int LowMemoryTAGraph::currentNumber = 0;
 const string LowMemoryTAGraph::CUR_FILE_LOC = "curFile.txt";
+const string LowMemoryTAGraph::CUR_JOURNAL_LOC = "journal.txt";
 const string LowMemoryTAGraph::CUR_SETTING_LOC = "curSetting.txt";
 const string LowMemoryTAGraph::BASE_INSTANCE_FN = "instances.ta";
 const string LowMemoryTAGraph::BASE_RELATION_FN = "relations.ta";
 const string LowMemoryTAGraph::BASE_MV_RELATION_FN = "old.relations.ta";
 const string LowMemoryTAGraph::BASE_ATTRIBUTE_FN = "attributes.ta";
+const string LowMemoryTAGraph::BASE_INDEX_FN = "spilled.idx";
 
 /**
  * Creates a graph with a base and a specific number.
  * @param basePath The base path to dump to.
  * @param curNum The graph number.
+ * @param config The low memory settings.
  */
-LowMemoryTAGraph::LowMemoryTAGraph(string basePath, int curNum) : TAGraph() {
+LowMemoryTAGraph::LowMemoryTAGraph(string basePath, int curNum, LowMemoryConfig config) : TAGraph() {
     purge = true;
     fileNumber = curNum;
+    this->config = config;
 
     instanceFN = bs::weakly_canonical(bs::path(basePath + "/" + to_string(fileNumber) + "-" + BASE_INSTANCE_FN)).string();
     relationFN = bs::weakly_canonical(bs::path(basePath + "/" + to_string(fileNumber) + "-" + BASE_RELATION_FN)).string();
@@ -59,14 +73,19 @@ LowMemoryTAGraph::LowMemoryTAGraph(string basePath, int curNum) : TAGraph() {
     attributeFN = bs::weakly_canonical(bs::path(basePath + "/" + to_string(fileNumber) + "-" + BASE_ATTRIBUTE_FN)).string();
     settingFN = bs::weakly_canonical(bs::path(basePath + "/" + to_string(fileNumber) + "-" + CUR_SETTING_LOC)).string();
     curFileFN = bs::weakly_canonical(bs::path(basePath + "/" + to_string(fileNumber) + "-" + CUR_FILE_LOC)).string();
+    journalFN = bs::weakly_canonical(bs::path(basePath + "/" + to_string(fileNumber) + "-" + CUR_JOURNAL_LOC)).string();
+    indexFN = bs::weakly_canonical(bs::path(basePath + "/" + to_string(fileNumber) + "-" + BASE_INDEX_FN)).string();
+    setupFilter(true);
 }
 
 /**
  * Creates a graph with a base.
  * @param basePath The base path to dump to.
+ * @param config The low memory settings.
  */
-LowMemoryTAGraph::LowMemoryTAGraph(string basePath) : TAGraph() {
+LowMemoryTAGraph::LowMemoryTAGraph(string basePath, LowMemoryConfig config) : TAGraph() {
     purge = true;
+    this->config = config;
     fileNumber = LowMemoryTAGraph::currentNumber;
     LowMemoryTAGraph::currentNumber++;
 
@@ -76,6 +95,8 @@ LowMemoryTAGraph::LowMemoryTAGraph(string basePath) : TAGraph() {
     attributeFN = bs::weakly_canonical(bs::path(basePath + "/" + to_string(fileNumber) + "-" + BASE_ATTRIBUTE_FN)).string();
     settingFN = bs::weakly_canonical(bs::path(basePath + "/" + to_string(fileNumber) + "-" + CUR_SETTING_LOC)).string();
     curFileFN = bs::weakly_canonical(bs::path(basePath + "/" + to_string(fileNumber) + "-" + CUR_FILE_LOC)).string();
+    journalFN = bs::weakly_canonical(bs::path(basePath + "/" + to_string(fileNumber) + "-" + CUR_JOURNAL_LOC)).string();
+    indexFN = bs::weakly_canonical(bs::path(basePath + "/" + to_string(fileNumber) + "-" + BASE_INDEX_FN)).string();
 
     if (doesFileExist(instanceFN)) deleteFile(instanceFN);
     if (doesFileExist(relationFN)) deleteFile(relationFN);
@@ -90,13 +111,19 @@ LowMemoryTAGraph::LowMemoryTAGraph(string basePath) : TAGraph() {
     f.close();
     f = ofstream{ curFileFN };
     f.close();
+    f = ofstream{ journalFN };
+    f.close();
+
+    setupFilter(false);
 }
 
 /**
  * Generates a default LowMemoryTAGraph.
+ * @param config The low memory settings.
  */
-LowMemoryTAGraph::LowMemoryTAGraph() : TAGraph() {
+LowMemoryTAGraph::LowMemoryTAGraph(LowMemoryConfig config) : TAGraph() {
     purge = true;
+    this->config = config;
     fileNumber = LowMemoryTAGraph::currentNumber;
     LowMemoryTAGraph::currentNumber++;
 
@@ -106,6 +133,8 @@ LowMemoryTAGraph::LowMemoryTAGraph() : TAGraph() {
     attributeFN = bs::weakly_canonical(bs::path(to_string(fileNumber) + "-" + BASE_ATTRIBUTE_FN)).string();
     settingFN = bs::weakly_canonical(bs::path(to_string(fileNumber) + "-" + CUR_SETTING_LOC)).string();
     curFileFN = bs::weakly_canonical(bs::path(to_string(fileNumber) + "-" + CUR_FILE_LOC)).string();
+    journalFN = bs::weakly_canonical(bs::path(to_string(fileNumber) + "-" + CUR_JOURNAL_LOC)).string();
+    indexFN = bs::weakly_canonical(bs::path(to_string(fileNumber) + "-" + BASE_INDEX_FN)).string();
 
     if (doesFileExist(instanceFN)) deleteFile(instanceFN);
     if (doesFileExist(relationFN)) deleteFile(relationFN);
@@ -120,7 +149,10 @@ LowMemoryTAGraph::LowMemoryTAGraph() : TAGraph() {
     f.close();
     f = ofstream{ curFileFN };
     f.close();
+    f = ofstream{ journalFN };
+    f.close();
 
+    setupFilter(false);
 }
 
 /**
@@ -132,6 +164,9 @@ LowMemoryTAGraph::~LowMemoryTAGraph() {
     if (doesFileExist(attributeFN)) deleteFile(attributeFN);
     if (doesFileExist(settingFN)) deleteFile(settingFN);
     if (doesFileExist(curFileFN)) deleteFile(curFileFN);
+    if (doesFileExist(journalFN)) deleteFile(journalFN);
+    spilledNodes->disableIndex(true);
+    delete spilledNodes;
 }
 
 /**
@@ -145,6 +180,9 @@ void LowMemoryTAGraph::changeRoot(std::string basePath){
     attributeFN = bs::weakly_canonical(bs::path(basePath + "/" + to_string(fileNumber) + "-" + BASE_ATTRIBUTE_FN)).string();
     settingFN = bs::weakly_canonical(bs::path(basePath + "/" + to_string(fileNumber) + "-" + CUR_SETTING_LOC)).string();
     curFileFN = bs::weakly_canonical(bs::path(basePath + "/" + to_string(fileNumber) + "-" + CUR_FILE_LOC)).string();
+    journalFN = bs::weakly_canonical(bs::path(basePath + "/" + to_string(fileNumber) + "-" + CUR_JOURNAL_LOC)).string();
+    indexFN = bs::weakly_canonical(bs::path(basePath + "/" + to_string(fileNumber) + "-" + BASE_INDEX_FN)).string();
+    spilledNodes->changeIndexLocation(indexFN);
 }
 
 /**
@@ -154,6 +192,13 @@ void LowMemoryTAGraph::changeRoot(std::string basePath){
  * @return Whether it was added.
  */
 bool LowMemoryTAGraph::addNode(ClangNode* node, bool assumeValid){
+    //Check if the node was already written to disk.
+    if (!assumeValid && isSpilled(node->getID())){
+        Metrics::increment(Metrics::DUPLICATE_NODES);
+        delete node;
+        return false;
+    }
+
     //Check the number of entities.
     int amt = getNumberEntities();
     if (amt > PURGE_AMOUNT){
@@ -191,25 +236,133 @@ string LowMemoryTAGraph::generateTAFormat() {
 
     //Generate the instances.
     format += "FACT TUPLE :\n";
-    ifstream instances(instanceFN);
-    if (instances.is_open()) while(getline(instances, curLine)) format += curLine + "\n";
+    SpillReader instances(instanceFN);
+    while(instances.getline(curLine)) format += curLine + "\n";
     instances.close();
 
     //Generate the relations.
-    ifstream relations(relationFN);
-    if (relations.is_open()) while(getline(relations, curLine)) format += curLine + "\n";
+    SpillReader relations(relationFN);
+    while(relations.getline(curLine)) format += curLine + "\n";
     relations.close();
     format += "\n";
 
     //Generate the attributes.
     format += "FACT ATTRIBUTE :\n";
-    ifstream attributes(attributeFN);
-    if (attributes.is_open()) while(getline(attributes, curLine)) format += curLine + "\n";
+    SpillReader attributes(attributeFN);
+    while(attributes.getline(curLine)) format += curLine + "\n";
     attributes.close();
 
     return format;
 }
 
+/**
+ * Streams the TA for this graph to a descriptor. The spill files are
+ * copied directly so the model is never held in memory.
+ * @param fd The descriptor to write to.
+ * @return Whether the TA was written.
+ */
+bool LowMemoryTAGraph::writeTAStream(int fd) {
+    Metrics::Timer timer(Metrics::OUTPUT);
+
+    //Generate the instances.
+    bool succ = writeData(fd, generateTAHeader() + "FACT TUPLE :\n");
+    succ = succ && copySpillFile(instanceFN, fd);
+
+    //Generate the relations.
+    succ = succ && copySpillFile(relationFN, fd);
+    succ = succ && writeData(fd, "\n");
+
+    //Generate the attributes.
+    succ = succ && writeData(fd, "FACT ATTRIBUTE :\n");
+    succ = succ && copySpillFile(attributeFN, fd);
+
+    return succ;
+}
+
+/**
+ * Loads an existing TA file by copying its facts straight into the
+ * spill files. Instances are added to the spilled node filter so
+ * extraction doesn't write them again.
+ * @param fileName The TA file to load.
+ * @param print The printer that prints messages.
+ * @return Whether the file was loaded.
+ */
+bool LowMemoryTAGraph::loadTAFile(string fileName, Printer* print) {
+    TAScanner scanner(fileName);
+    if (!scanner.isOpen()){
+        print->printErrorTAProcessRead(fileName);
+        return false;
+    }
+
+    //Opens the spill files.
+    purgeCurrentGraph();
+    SpillWriter instances(instanceFN, true, config.compress, config.blockSize, config.compressionLevel);
+    SpillWriter relations(relationFN, true, config.compress, config.blockSize, config.compressionLevel);
+    SpillWriter attributes(attributeFN, true, config.compress, config.blockSize, config.compressionLevel);
+    if (!instances.isOpen() || !relations.isOpen() || !attributes.isOpen()) return false;
+
+    //Goes through each line.
+    boost::string_ref line;
+    vector<boost::string_ref> tokens;
+    bool blockComment = false;
+    bool inTuple = false;
+    bool inAttribute = false;
+    bool tupleEncountered = false;
+    bool succ = true;
+    while (succ && scanner.nextLine(line)){
+        //Checks for a new section.
+        if (line.starts_with(TAScanner::SCHEME_FLAG)){
+            inTuple = inAttribute = false;
+            continue;
+        } else if (line.starts_with(TAScanner::RELATION_FLAG)){
+            inTuple = tupleEncountered = true;
+            inAttribute = false;
+            continue;
+        } else if (line.starts_with(TAScanner::ATTRIBUTE_FLAG)){
+            inTuple = false;
+            inAttribute = true;
+            continue;
+        }
+        if (!inTuple && !inAttribute) continue;
+
+        TAScanner::tokenize(line, blockComment, tokens);
+        if (tokens.size() == 0) continue;
+
+        //Rebuilds the line.
+        string entry = tokens.at(0).to_string();
+        for (int i = 1; i < tokens.size(); i++) entry += " " + tokens.at(i).to_string();
+        entry += "\n";
+
+        //Attributes are copied as is.
+        if (inAttribute){
+            succ = attributes.write(entry);
+            continue;
+        }
+
+        //Checks the tuple.
+        if (tokens.size() != 3){
+            print->printErrorTAProcess(scanner.getLineNumber(), RSF_INVALID);
+            return false;
+        }
+
+        //Writes the fact.
+        if (tokens.at(0) == INSTANCE_FLAG){
+            string ID = tokens.at(1).to_string();
+            if (isSpilled(ID)) continue;
+
+            spilledNodes->insert(ID);
+            succ = instances.write(entry);
+        } else {
+            succ = relations.write(entry);
+        }
+    }
+
+    succ = instances.close() && succ;
+    succ = relations.close() && succ;
+    succ = attributes.close() && succ;
+    return succ && tupleEncountered;
+}
+
 /**
  * Resolves files on disk.
  * @param exclusions The exclusions to process.
@@ -237,11 +390,11 @@ void LowMemoryTAGraph::resolveExternalReferences(Printer* print, bool silent) {
 
     //Generate a map of the instances.
     unordered_map<string, string> instanceMap;
-    ifstream instances(instanceFN);
-    if (!instances.is_open()) return;
+    SpillReader instances(instanceFN);
+    if (!instances.isOpen()) return;
 
     string curLine;
-    while (getline(instances, curLine)){
+    while (instances.getline(curLine)){
         vector<string> lineSplit = tokenize(curLine);
         if (lineSplit.size() != 3) continue;
 
@@ -260,10 +413,10 @@ void LowMemoryTAGraph::resolveExternalReferences(Printer* print, bool silent) {
 
     vector<string> removedRels;
 
-    ifstream original(mvRelationFN);
-    ofstream destination(relationFN, std::ios_base::out);
-    if (!original.is_open() || !destination.is_open()) return;
-    while(getline(original, curLine)){
+    SpillReader original(mvRelationFN);
+    SpillWriter destination(relationFN, false, config.compress, config.blockSize, config.compressionLevel);
+    if (!original.isOpen() || !destination.isOpen()) return;
+    while(original.getline(curLine)){
         vector<string> lineSplit = tokenize(curLine);
         if (lineSplit.size() != 3) continue;
 
@@ -274,18 +427,19 @@ void LowMemoryTAGraph::resolveExternalReferences(Printer* print, bool silent) {
             continue;
         }
 
-        destination << curLine << "\n";
+        destination.write(curLine + "\n");
     }
     original.close();
     destination.close();
     deleteFile(mvRelationFN);
+    Metrics::increment(Metrics::UNRESOLVED_EDGES, removedRels.size());
 
     //Compress attributes.
     unordered_map<string, vector<pair<string, vector<string>>>> attrMap;
-    ifstream attributes(attributeFN);
-    if (!attributes.is_open()) return;
+    SpillReader attributes(attributeFN);
+    if (!attributes.isOpen()) return;
 
-    while(getline(attributes, curLine)) {
+    while(attributes.getline(curLine)) {
         //Prepare the line.
         vector<string> entry = tokenize(curLine);
 
@@ -382,8 +536,8 @@ void LowMemoryTAGraph::resolveExternalReferences(Printer* print, bool silent) {
     attributes.close();
 
     //Write the attributes.
-    ofstream destAttr(attributeFN, std::ios_base::out);
-    if (!destAttr.is_open()) return;
+    SpillWriter destAttr(attributeFN, false, config.compress, config.blockSize, config.compressionLevel);
+    if (!destAttr.isOpen()) return;
     for (auto entry : attrMap){
         string attrLine = entry.first + " { ";
 
@@ -396,17 +550,17 @@ void LowMemoryTAGraph::resolveExternalReferences(Printer* print, bool silent) {
                 attrLine += ") ";
             }
         }
-        destAttr << attrLine + " }\n";
+        destAttr.write(attrLine + " }\n");
     }
     attrMap.clear();
     destAttr.close();
 
     //Write the instances.
-    ofstream outI(instanceFN);
-    if (!outI.is_open()) return;
+    SpillWriter outI(instanceFN, false, config.compress, config.blockSize, config.compressionLevel);
+    if (!outI.isOpen()) return;
 
     for (auto it : instanceMap) {
-        outI << INSTANCE_FLAG << " " << it.first << " " << it.second << "\n";
+        outI.write(INSTANCE_FLAG + " " + it.first + " " + it.second + "\n");
     }
     outI.close();
 }
@@ -417,11 +571,11 @@ void LowMemoryTAGraph::resolveExternalReferences(Printer* print, bool silent) {
  */
 void LowMemoryTAGraph::addNodesToFile(std::map<std::string, ClangNode*> fileSkip){
     //Load in each attribute.
-    ifstream attributes(attributeFN);
-    if (!attributes.is_open()) return;
+    SpillReader attributes(attributeFN);
+    if (!attributes.isOpen()) return;
 
     string current;
-    while (getline(attributes, current)){
+    while (attributes.getline(current)){
         boost::algorithm::trim(current);
 
         //Check for a relation attribute.
@@ -510,8 +664,10 @@ void LowMemoryTAGraph::dumpCurrentFile(int fileNum, string file){
  * @param files The files being processed.
  * @param exclude The exclusions.
  * @param blobMode Blob mode toggle.
+ * @param usrMode USR ID toggle.
  */
-void LowMemoryTAGraph::dumpSettings(vector<bs::path> files, TAGraph::ClangExclude exclude, bool blobMode){
+void LowMemoryTAGraph::dumpSettings(vector<bs::path> files, TAGraph::ClangExclude exclude, bool blobMode,
+                                    bool usrMode){
     //Opens the file.
     std::ofstream curSettings(settingFN);
     if (!curSettings.is_open()) return;
@@ -526,10 +682,111 @@ void LowMemoryTAGraph::dumpSettings(vector<bs::path> files, TAGraph::ClangExclud
     //Next, dump the excludes.
     curSettings << exclude.cClass << exclude.cEnum << exclude.cFile << exclude.cFunction << exclude.cStruct <<
                 exclude.cSubSystem << exclude.cUnion << exclude.cVariable;
-    curSettings << blobMode;
+    curSettings << blobMode << usrMode;
     curSettings.close();
 }
 
+/**
+ * Commits a finished file to the journal. Everything in memory is purged
+ * and synced to disk before the entry is written, so the spill files can
+ * be rolled back to this point if the run dies.
+ * @param fileNum The number of the file that finished.
+ * @param file The file that finished.
+ * @return Whether the entry was committed.
+ */
+bool LowMemoryTAGraph::commitFile(int fileNum, string file){
+    purgeCurrentGraph();
+
+    //Syncs the spill files.
+    long long instanceSize, relationSize, attributeSize;
+    if (!syncFile(instanceFN, &instanceSize) || !syncFile(relationFN, &relationSize) ||
+            !syncFile(attributeFN, &attributeSize)) return false;
+
+    //Writes the entry in a single write.
+    string entry = JOURNAL_COMMIT + " " + to_string(fileNum) + " " + to_string(instanceSize) + " " +
+            to_string(relationSize) + " " + to_string(attributeSize) + " " + file + "\n";
+    int fd = open(journalFN.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0644);
+    if (fd == -1) return false;
+
+    bool succ = write(fd, entry.c_str(), entry.size()) == (ssize_t) entry.size();
+    succ = (fsync(fd) == 0) && succ;
+    close(fd);
+
+    return succ;
+}
+
+/**
+ * Rolls the spill files back to the last committed file in the journal.
+ * A journal without a committed file rolls everything back to the start.
+ * @return The next file to process, JOURNAL_MISSING if the run predates the
+ * journal or JOURNAL_FAILED if the spill files can't be rolled back.
+ */
+int LowMemoryTAGraph::recoverJournal(){
+    ifstream journal(journalFN);
+    if (!journal.is_open()) return JOURNAL_MISSING;
+
+    //Finds the last complete entry.
+    string curLine;
+    int lastNum = -1;
+    long long sizes[3] = {0, 0, 0};
+    while (getline(journal, curLine)){
+        //A line without a newline was cut off mid-write.
+        if (journal.eof()) break;
+
+        stringstream entry(curLine);
+        string type;
+        int num;
+        long long cur[3];
+        if (!(entry >> type >> num >> cur[0] >> cur[1] >> cur[2]) || type != JOURNAL_COMMIT) continue;
+
+        lastNum = num;
+        for (int i = 0; i < 3; i++) sizes[i] = cur[i];
+    }
+    journal.close();
+
+    //Truncates everything written after the entry.
+    string spillFiles[3] = {instanceFN, relationFN, attributeFN};
+    for (int i = 0; i < 3; i++){
+        if (!rollbackFile(spillFiles[i], sizes[i])) return JOURNAL_FAILED;
+    }
+
+    //Rebuilds the spilled node filter from what's left.
+    spilledNodes->clear();
+    SpillReader instances(instanceFN);
+    while (instances.getline(curLine)){
+        vector<string> lineSplit = tokenize(curLine);
+        if (lineSplit.size() != 3) continue;
+        spilledNodes->insert(lineSplit.at(1));
+    }
+    instances.close();
+
+    return lastNum + 1;
+}
+
+/**
+ * Truncates a spill file back to the size the journal recorded.
+ * @param fN The spill file.
+ * @param size The committed size.
+ * @return Whether the file was rolled back.
+ */
+bool LowMemoryTAGraph::rollbackFile(string fN, long long size){
+    struct stat buffer;
+    if (stat(fN.c_str(), &buffer) != 0) {
+        if (size == 0) return true;
+        cerr << "Recovery Error: " << fN << " is missing but the journal expects " << size << " bytes." << endl;
+        return false;
+    }
+    if (buffer.st_size < size){
+        cerr << "Recovery Error: " << fN << " is shorter than the journal expects." << endl;
+        return false;
+    }
+    if (truncate(fN.c_str(), (off_t) size) != 0){
+        cerr << "Recovery Error: " << fN << " could not be truncated: " << strerror(errno) << endl;
+        return false;
+    }
+    return true;
+}
+
 /**
  * Checks whether a file exists.
  * @param fN The file to check.
@@ -548,6 +805,155 @@ void LowMemoryTAGraph::deleteFile(string fN) {
     remove(fN.c_str());
 }
 
+/**
+ * Copies the contents of a spill file to a descriptor. Compressed
+ * files are expanded one block at a time.
+ * @param fN The spill file to copy.
+ * @param fd The descriptor to write to.
+ * @return Whether the copy was successful.
+ */
+bool LowMemoryTAGraph::copySpillFile(string fN, int fd){
+    SpillReader reader(fN);
+    if (!reader.isOpen()) return true;
+
+    //Copies the data.
+    char last = '\n';
+    if (reader.isCompressed()){
+        string data;
+        while (reader.readBlock(data) > 0){
+            if (!writeData(fd, data)) return false;
+            last = data.back();
+        }
+        if (reader.hasFailed()) return false;
+    } else {
+        reader.close();
+        if (!copyPlainFile(fN, fd, &last)) return false;
+    }
+
+    //Terminates the last line.
+    if (last != '\n') return writeData(fd, "\n");
+    return true;
+}
+
+/**
+ * Copies a plain spill file to a descriptor. Tries copy_file_range,
+ * then sendfile, then falls back on read and write.
+ * @param fN The spill file to copy.
+ * @param fd The descriptor to write to.
+ * @param last The last character of the file.
+ * @return Whether the copy was successful.
+ */
+bool LowMemoryTAGraph::copyPlainFile(string fN, int fd, char* last){
+    int inFD = open(fN.c_str(), O_RDONLY);
+    if (inFD < 0) return false;
+
+    //Gets the size of the file.
+    struct stat st;
+    if (fstat(inFD, &st) != 0){
+        close(inFD);
+        return false;
+    }
+    off_t size = st.st_size;
+    if (size == 0){
+        close(inFD);
+        return true;
+    }
+    if (pread(inFD, last, 1, size - 1) != 1){
+        close(inFD);
+        return false;
+    }
+
+    //Copies within the kernel.
+    off_t offset = 0;
+#ifdef SYS_copy_file_range
+    while (offset < size){
+        loff_t inOff = offset;
+        ssize_t amt = syscall(SYS_copy_file_range, inFD, &inOff, fd, NULL, (size_t) (size - offset), 0);
+        if (amt <= 0) break;
+        offset += amt;
+    }
+#endif
+    while (offset < size){
+        ssize_t amt = sendfile(fd, inFD, &offset, (size_t) (size - offset));
+        if (amt <= 0) break;
+    }
+
+    //Copies whatever is left through user space.
+    if (offset < size && lseek(inFD, offset, SEEK_SET) == offset){
+        vector<char> buffer(SpillFormat::READ_SIZE);
+        ssize_t amt;
+        while (offset < size && (amt = read(inFD, buffer.data(), buffer.size())) != 0){
+            if (amt < 0){
+                if (errno == EINTR) continue;
+                break;
+            }
+            if (!writeData(fd, string(buffer.data(), amt))) break;
+            offset += amt;
+        }
+    }
+
+    close(inFD);
+    return offset >= size;
+}
+
+/**
+ * Sets up the spilled node filter.
+ * @param reuse Whether an existing index on disk is reused.
+ */
+void LowMemoryTAGraph::setupFilter(bool reuse){
+    //Without the index, the error rate is how often a new node is wrongly dropped.
+    spilledNodes = new SpillFilter(SpillFilter::DEFAULT_CAPACITY,
+                                   (config.exactDedup) ? SpillFilter::DEFAULT_FP_RATE : config.filterErrorRate);
+    spilledNodes->setFallbackRate(config.filterErrorRate);
+    if (!config.exactDedup) return;
+
+    //Falls back to the approximate filter at the configured rate if the index can't be made.
+    if (!spilledNodes->enableIndex(indexFN, reuse)){
+        cerr << "Warning: Could not create the spilled node index at " << indexFN << "." << endl;
+        delete spilledNodes;
+        spilledNodes = new SpillFilter(SpillFilter::DEFAULT_CAPACITY, config.filterErrorRate);
+    }
+}
+
+/**
+ * Checks whether a node was already written to disk.
+ * @param ID The ID of the node.
+ * @return Whether the node was spilled.
+ */
+bool LowMemoryTAGraph::isSpilled(string ID){
+    //Nodes in memory are handled by the graph itself.
+    auto it = nodeList.find(ID);
+    if (it != nodeList.end() && it->second != nullptr) return false;
+    return spilledNodes->contains(ID);
+}
+
+/**
+ * Checks whether a node is only stored on disk.
+ * @param ID The ID of the node.
+ * @return Whether the node was spilled.
+ */
+bool LowMemoryTAGraph::isNodeStored(string ID){
+    return isSpilled(ID);
+}
+
+/**
+ * Flushes a file to disk.
+ * @param fN The file to sync.
+ * @param size The size of the file.
+ * @return Whether the sync worked.
+ */
+bool LowMemoryTAGraph::syncFile(string fN, long long* size){
+    int fd = open(fN.c_str(), O_RDONLY);
+    if (fd == -1) return false;
+
+    struct stat buffer;
+    bool succ = fsync(fd) == 0 && fstat(fd, &buffer) == 0;
+    if (succ) *size = (long long) buffer.st_size;
+    close(fd);
+
+    return succ;
+}
+
 /**
  * Alters whether we purge.
  * @param purge The purge toggle.
@@ -561,23 +967,29 @@ void LowMemoryTAGraph::setPurgeStatus(bool purge){
  */
 void LowMemoryTAGraph::purgeCurrentGraph(){
     if (!purge) return;
+    Metrics::Timer timer(Metrics::PURGE);
 
     //Start by writing everything to disk.
-    ofstream instances(instanceFN, std::ios::out | std::ios::app);
-    if (!instances.is_open()) return;
-    instances << generateInstances();
+    SpillWriter instances(instanceFN, true, config.compress, config.blockSize, config.compressionLevel);
+    if (!instances.isOpen()) return;
+    instances.write(generateInstances());
     instances.close();
 
-    ofstream relations(relationFN, std::ios::out | std::ios::app);
-    if (!relations.is_open()) return;
-    relations << generateRelationships();
+    SpillWriter relations(relationFN, true, config.compress, config.blockSize, config.compressionLevel);
+    if (!relations.isOpen()) return;
+    relations.write(generateRelationships());
     relations.close();
 
-    ofstream attributes(attributeFN, std::ios::out | std::ios::app);
-    if (!attributes.is_open()) return;
-    attributes << generateAttributes();
+    SpillWriter attributes(attributeFN, true, config.compress, config.blockSize, config.compressionLevel);
+    if (!attributes.isOpen()) return;
+    attributes.write(generateAttributes());
     attributes.close();
 
+    //Remember the nodes that are now on disk.
+    for (auto entry : nodeList){
+        if (entry.second != nullptr) spilledNodes->insert(entry.first);
+    }
+
     //Clear the graph.
     clearGraph();
 }
@@ -593,14 +1005,17 @@ int LowMemoryTAGraph::getNumberEntities(){
 }
 
 /**
- * Tokenizes the string based on a space.
+ * Tokenizes the string based on whitespace. Quoted values are kept together.
  * @param curString The current string to split.
  * @return A vector of tokens.
  */
 vector<string> LowMemoryTAGraph::tokenize(string curString){
-    vector<string> tokens;
+    vector<boost::string_ref> refs;
+    bool blockComment = false;
+    TAScanner::tokenize(curString, blockComment, refs);
 
-    boost::split(tokens, curString, boost::is_any_of(" "), boost::token_compress_on);
+    vector<string> tokens;
+    for (auto ref : refs) tokens.push_back(ref.to_string());
     return tokens;
 }
 
@@ -30,13 +30,24 @@
 #include <boost/filesystem.hpp>
 #include "../Printer/Printer.h"
 #include "TAGraph.h"
+#include "SpillFilter.h"
+#include "SpillStream.h"
 
 class LowMemoryTAGraph : public TAGraph {
 public:
+    /** Low Memory Settings */
+    typedef struct {
+        bool exactDedup = true;
+        double filterErrorRate = 0.0001;
+        bool compress = true;
+        int blockSize = SpillFormat::DEFAULT_BLOCK_SIZE;
+        int compressionLevel = SpillFormat::DEFAULT_LEVEL;
+    } LowMemoryConfig;
+
     /** Constructors / Destructor */
-    LowMemoryTAGraph();
-    LowMemoryTAGraph(std::string basePath);
-    LowMemoryTAGraph(std::string basePath, int curNum);
+    LowMemoryTAGraph(LowMemoryConfig config);
+    LowMemoryTAGraph(std::string basePath, LowMemoryConfig config);
+    LowMemoryTAGraph(std::string basePath, int curNum, LowMemoryConfig config);
     ~LowMemoryTAGraph() override;
 
     /** Changes the Root */
@@ -48,6 +59,8 @@ public:
 
     /** TA Generation */
     std::string generateTAFormat() override;
+    bool writeTAStream(int fd) override;
+    bool loadTAFile(std::string fileName, Printer* print) override;
     void resolveFiles(ClangExclude exclusions) override;
     void resolveExternalReferences(Printer* print, bool silent = false) override;
 
@@ -57,17 +70,25 @@ public:
     /** Settings/File Dumpers */
     void dumpCurrentFile(int fileNum, std::string file);
     void dumpSettings(std::vector<boost::filesystem::path> files,
-                      TAGraph::ClangExclude exclude, bool blobMode);
+                      TAGraph::ClangExclude exclude, bool blobMode, bool usrMode = false);
 
     /** TA Dumper */
     void purgeCurrentGraph();
 
+    /** Journal System */
+    bool commitFile(int fileNum, std::string file);
+    int recoverJournal();
+
     static const std::string CUR_FILE_LOC;
+    static const std::string CUR_JOURNAL_LOC;
     static const std::string CUR_SETTING_LOC;
     static const std::string BASE_INSTANCE_FN;
     static const std::string BASE_RELATION_FN;
     static const std::string BASE_MV_RELATION_FN;
     static const std::string BASE_ATTRIBUTE_FN;
+    static const std::string BASE_INDEX_FN;
+    static const int JOURNAL_MISSING = -1;
+    static const int JOURNAL_FAILED = -2;
 
 private:
     const int PURGE_AMOUNT = 1000;
@@ -78,14 +99,35 @@ private:
     std::string attributeFN;
     std::string settingFN;
     std::string curFileFN;
+    std::string journalFN;
+    std::string indexFN;
 
     static int currentNumber;
     int fileNumber;
     bool purge;
 
+    /** Spilled Node Filter */
+    LowMemoryConfig config;
+    SpillFilter* spilledNodes;
+
+    /** Loader Const Variables */
+    const std::string RSF_INVALID = "Line should contain a single tuple in RSF format.";
+
+    /** Journal Const Variables */
+    const std::string JOURNAL_COMMIT = "commit";
+
     /** File Operations */
     bool doesFileExist(std::string fN);
     void deleteFile(std::string fN);
+    bool syncFile(std::string fN, long long* size);
+    bool copySpillFile(std::string fN, int fd);
+    bool copyPlainFile(std::string fN, int fd, char* last);
+    bool rollbackFile(std::string fN, long long size);
+
+    /** Spill Filter Helpers */
+    void setupFilter(bool reuse);
+    bool isSpilled(std::string ID);
+    bool isNodeStored(std::string ID) override;
 
     /** Helper Methods */
     void setPurgeStatus(bool purge);
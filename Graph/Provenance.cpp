@@ -0,0 +1,207 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Provenance.cpp
+//
+// Created By: Bryan J Muscedere
+// Date: 19/10/26.
+//
+// Table of the translation units that produced each fact. Every
+// distinct set of translation units is stored once and shared by all
+// the facts that have it, with a reference count so unused sets can
+// be reused. Facts only hold the small ID of their set.
+//
+// Copyright (C) 2017, Bryan J. Muscedere
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include "Provenance.h"
+
+using namespace std;
+
+/**
+ * Creates a table that only holds the empty set.
+ */
+ProvenanceTable::ProvenanceTable() {
+    sets.push_back(vector<uint32_t>());
+    refCounts.push_back(0);
+}
+
+/**
+ * Destructor.
+ */
+ProvenanceTable::~ProvenanceTable() { }
+
+/**
+ * Gets the ID of a translation unit, adding it if it's new.
+ * @param name The file of the translation unit.
+ * @return The ID of the translation unit.
+ */
+uint32_t ProvenanceTable::getTU(string name){
+    auto it = tuIDs.find(name);
+    if (it != tuIDs.end()) return it->second;
+
+    uint32_t tu = (uint32_t) tuNames.size();
+    tuNames.push_back(name);
+    tuIDs[name] = tu;
+    return tu;
+}
+
+/**
+ * Looks up the ID of a translation unit without adding it.
+ * @param name The file of the translation unit.
+ * @param tu The ID of the translation unit.
+ * @return Whether the translation unit is known.
+ */
+bool ProvenanceTable::findTU(string name, uint32_t* tu){
+    auto it = tuIDs.find(name);
+    if (it == tuIDs.end()) return false;
+
+    *tu = it->second;
+    return true;
+}
+
+/**
+ * Gets the file of a translation unit.
+ * @param tu The ID of the translation unit.
+ * @return The file of the translation unit.
+ */
+string ProvenanceTable::getTUName(uint32_t tu){
+    if (tu >= tuNames.size()) return string();
+    return tuNames.at(tu);
+}
+
+/**
+ * Adds a translation unit to a set. The caller gives up its reference
+ * to the old set and holds one to the returned set.
+ * @param set The set to add to.
+ * @param tu The translation unit.
+ * @return The set with the translation unit.
+ */
+ProvenanceTable::SetID ProvenanceTable::add(SetID set, uint32_t tu){
+    const vector<uint32_t>& cur = sets.at(set);
+    auto pos = lower_bound(cur.begin(), cur.end(), tu);
+    if (pos != cur.end() && *pos == tu) return set;
+
+    vector<uint32_t> next(cur.begin(), pos);
+    next.push_back(tu);
+    next.insert(next.end(), pos, cur.end());
+
+    SetID result = intern(next);
+    release(set);
+    return result;
+}
+
+/**
+ * Removes a translation unit from a set. The caller gives up its
+ * reference to the old set and holds one to the returned set.
+ * @param set The set to remove from.
+ * @param tu The translation unit.
+ * @return The set without the translation unit.
+ */
+ProvenanceTable::SetID ProvenanceTable::remove(SetID set, uint32_t tu){
+    const vector<uint32_t>& cur = sets.at(set);
+    auto pos = lower_bound(cur.begin(), cur.end(), tu);
+    if (pos == cur.end() || *pos != tu) return set;
+
+    vector<uint32_t> next(cur.begin(), pos);
+    next.insert(next.end(), pos + 1, cur.end());
+
+    SetID result = intern(next);
+    release(set);
+    return result;
+}
+
+/**
+ * Checks whether a set has a translation unit.
+ * @param set The set to check.
+ * @param tu The translation unit.
+ * @return Whether the translation unit is in the set.
+ */
+bool ProvenanceTable::contains(SetID set, uint32_t tu){
+    const vector<uint32_t>& cur = sets.at(set);
+    return binary_search(cur.begin(), cur.end(), tu);
+}
+
+/**
+ * Gets the translation units in a set.
+ * @param set The set.
+ * @return The sorted translation unit IDs.
+ */
+vector<uint32_t> ProvenanceTable::getTUs(SetID set){
+    return sets.at(set);
+}
+
+/**
+ * Drops a reference to a set. Sets nobody uses are freed for reuse.
+ * @param set The set.
+ */
+void ProvenanceTable::release(SetID set){
+    if (set == EMPTY_SET || refCounts.at(set) == 0) return;
+    if (--refCounts.at(set) > 0) return;
+
+    setIndex.erase(makeKey(sets.at(set)));
+    sets.at(set).clear();
+    sets.at(set).shrink_to_fit();
+    freeSets.push_back(set);
+}
+
+/**
+ * Gets the number of sets in use, including the empty set.
+ * @return The number of sets.
+ */
+size_t ProvenanceTable::getNumSets(){
+    return sets.size() - freeSets.size();
+}
+
+/**
+ * Finds or creates a set and adds a reference to it.
+ * @param tus The sorted translation units.
+ * @return The ID of the set.
+ */
+ProvenanceTable::SetID ProvenanceTable::intern(const vector<uint32_t>& tus){
+    if (tus.size() == 0) return EMPTY_SET;
+
+    string key = makeKey(tus);
+    auto it = setIndex.find(key);
+    if (it != setIndex.end()) {
+        refCounts.at(it->second)++;
+        return it->second;
+    }
+
+    //Reuses a freed slot if there is one.
+    SetID set;
+    if (freeSets.size() > 0) {
+        set = freeSets.back();
+        freeSets.pop_back();
+        sets.at(set) = tus;
+        refCounts.at(set) = 1;
+    } else {
+        set = (SetID) sets.size();
+        sets.push_back(tus);
+        refCounts.push_back(1);
+    }
+
+    setIndex[key] = set;
+    return set;
+}
+
+/**
+ * Builds the lookup key for a set.
+ * @param tus The sorted translation units.
+ * @return The key.
+ */
+string ProvenanceTable::makeKey(const vector<uint32_t>& tus){
+    return string((const char*) tus.data(), tus.size() * sizeof(uint32_t));
+}
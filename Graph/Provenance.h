@@ -0,0 +1,76 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Provenance.h
+//
+// Created By: Bryan J Muscedere
+// Date: 19/10/26.
+//
+// Table of the translation units that produced each fact. Every
+// distinct set of translation units is stored once and shared by all
+// the facts that have it, with a reference count so unused sets can
+// be reused. Facts only hold the small ID of their set.
+//
+// Copyright (C) 2017, Bryan J. Muscedere
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CLANGEX_PROVENANCE_H
+#define CLANGEX_PROVENANCE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+class ProvenanceTable {
+public:
+    /** Set Identifiers */
+    typedef uint32_t SetID;
+    const static SetID EMPTY_SET = 0;
+
+    /** Constructor/Destructor */
+    ProvenanceTable();
+    ~ProvenanceTable();
+
+    /** Translation Units */
+    uint32_t getTU(std::string name);
+    bool findTU(std::string name, uint32_t* tu);
+    std::string getTUName(uint32_t tu);
+
+    /** Set Operations */
+    SetID add(SetID set, uint32_t tu);
+    SetID remove(SetID set, uint32_t tu);
+    bool contains(SetID set, uint32_t tu);
+    std::vector<uint32_t> getTUs(SetID set);
+    void release(SetID set);
+    size_t getNumSets();
+
+private:
+    /** Translation Unit Names */
+    std::vector<std::string> tuNames;
+    std::unordered_map<std::string, uint32_t> tuIDs;
+
+    /** Set Storage */
+    std::vector<std::vector<uint32_t>> sets;
+    std::vector<uint32_t> refCounts;
+    std::vector<SetID> freeSets;
+    std::unordered_map<std::string, SetID> setIndex;
+
+    /** Helper Methods */
+    SetID intern(const std::vector<uint32_t>& tus);
+    std::string makeKey(const std::vector<uint32_t>& tus);
+};
+
+
+#endif //CLANGEX_PROVENANCE_H
@@ -0,0 +1,522 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// SpillFilter.cpp
+//
+// Created By: Bryan J Muscedere
+// Date: 19/10/26.
+//
+// Membership filter for node IDs that have already been spilled to
+// disk by the low-memory graph. Uses a scalable Bloom filter to rule
+// out new IDs cheaply and an optional on-disk hash index to confirm
+// positive results exactly.
+//
+// Copyright (C) 2017, Bryan J. Muscedere
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <openssl/md5.h>
+#include "SpillFilter.h"
+
+using namespace std;
+
+/** Default Settings */
+const uint64_t SpillFilter::DEFAULT_CAPACITY = 1 << 16;
+const double SpillFilter::DEFAULT_FP_RATE = 0.01;
+
+/**
+ * Creates an empty filter.
+ * @param initialCapacity The number of IDs the first layer holds.
+ * @param falsePositive The target false positive rate.
+ */
+SpillFilter::SpillFilter(uint64_t initialCapacity, double falsePositive) {
+    this->initialCapacity = (initialCapacity == 0) ? DEFAULT_CAPACITY : initialCapacity;
+    this->falsePositive = (falsePositive <= 0 || falsePositive >= 1) ? DEFAULT_FP_RATE : falsePositive;
+    fallbackRate = this->falsePositive;
+    numInserted = 0;
+    trusted = true;
+
+    indexFD = -1;
+    indexFN = "";
+    numSlots = 0;
+    usedSlots = 0;
+
+    addLayer();
+}
+
+/**
+ * Closes the exact index. The index file is kept on disk.
+ */
+SpillFilter::~SpillFilter() {
+    disableIndex(false);
+}
+
+/**
+ * Adds an ID to the filter.
+ * @param ID The ID to add.
+ */
+void SpillFilter::insert(const string& ID){
+    Fingerprint print = generateFingerprint(ID);
+
+    //Checks if the index already has it. If the index fails, the ID still goes in the Bloom filter.
+    if (indexFD != -1){
+        IndexResult result = indexInsert(print);
+        if (result == INDEX_PRESENT) return;
+        if (result == INDEX_FAILED) loseIndex();
+    }
+
+    //Grows the filter if the current layer is full.
+    if (layers.back().count >= layers.back().capacity) addLayer();
+    layerInsert(layers.back(), print);
+    numInserted++;
+}
+
+/**
+ * Checks whether an ID was added to the filter. Without the
+ * exact index, this may return true for an ID that was never added.
+ * If the index was lost and the filter couldn't be rebuilt, nothing
+ * is reported as added so no new ID is wrongly dropped.
+ * @param ID The ID to check.
+ * @return Whether the ID was (likely) added.
+ */
+bool SpillFilter::contains(const string& ID){
+    if (!trusted) return false;
+    Fingerprint print = generateFingerprint(ID);
+
+    //Checks the Bloom filter layers first.
+    bool found = false;
+    for (int i = (int) layers.size() - 1; i >= 0 && !found; i--){
+        found = layerContains(layers.at(i), print);
+    }
+    if (!found) return false;
+
+    //Confirms with the index.
+    if (indexFD != -1) return indexContains(print);
+    return true;
+}
+
+/**
+ * Clears the filter and the exact index.
+ */
+void SpillFilter::clear(){
+    layers.clear();
+    numInserted = 0;
+    trusted = true;
+    addLayer();
+
+    //Resets the index file.
+    if (indexFD != -1){
+        if (ftruncate(indexFD, 0) != 0 || ftruncate(indexFD, INITIAL_SLOTS * SLOT_SIZE) != 0){
+            loseIndex();
+            return;
+        }
+        numSlots = INITIAL_SLOTS;
+        usedSlots = 0;
+    }
+}
+
+/**
+ * Enables the exact on-disk index.
+ * @param indexFN The file to store the index in.
+ * @param reuse Whether an existing index file is kept.
+ * @return Whether the index was opened.
+ */
+bool SpillFilter::enableIndex(string indexFN, bool reuse){
+    disableIndex(false);
+
+    //Opens the file.
+    int flags = O_RDWR | O_CREAT;
+    if (!reuse) flags |= O_TRUNC;
+    int fd = open(indexFN.c_str(), flags, 0644);
+    if (fd == -1) return false;
+
+    //Gets the size of the index.
+    struct stat buffer;
+    if (fstat(fd, &buffer) != 0){
+        close(fd);
+        return false;
+    }
+
+    uint64_t slots = (uint64_t) buffer.st_size / SLOT_SIZE;
+    if (slots < INITIAL_SLOTS || (slots & (slots - 1)) != 0){
+        //The index is new or unusable.
+        if (ftruncate(fd, 0) != 0 || ftruncate(fd, INITIAL_SLOTS * SLOT_SIZE) != 0){
+            close(fd);
+            return false;
+        }
+        slots = INITIAL_SLOTS;
+    }
+
+    indexFD = fd;
+    this->indexFN = indexFN;
+    numSlots = slots;
+    usedSlots = 0;
+
+    //Loads the reused index back into the Bloom filter.
+    Fingerprint print;
+    for (uint64_t i = 0; i < numSlots; i++){
+        if (!readSlot(indexFD, i, &print)){
+            disableIndex(false);
+            return false;
+        }
+        if (isEmpty(print)) continue;
+
+        usedSlots++;
+        if (layers.back().count >= layers.back().capacity) addLayer();
+        layerInsert(layers.back(), print);
+        numInserted++;
+    }
+
+    return true;
+}
+
+/**
+ * Disables the exact on-disk index.
+ * @param remove Whether the index file is deleted.
+ */
+void SpillFilter::disableIndex(bool remove){
+    if (indexFD == -1) return;
+
+    close(indexFD);
+    if (remove) std::remove(indexFN.c_str());
+
+    indexFD = -1;
+    indexFN = "";
+    numSlots = 0;
+    usedSlots = 0;
+}
+
+/**
+ * Updates the location of the index after it has been moved.
+ * @param indexFN The new index location.
+ */
+void SpillFilter::changeIndexLocation(string indexFN){
+    if (indexFD == -1) return;
+    this->indexFN = indexFN;
+}
+
+/**
+ * Checks whether the exact index is being used.
+ * @return Whether the index is enabled.
+ */
+bool SpillFilter::isIndexEnabled(){
+    return indexFD != -1;
+}
+
+/**
+ * Sets the error rate the filter is rebuilt at if the exact index is
+ * lost. The Bloom filter can be looser while the index confirms hits.
+ * @param falsePositive The error rate without the index.
+ */
+void SpillFilter::setFallbackRate(double falsePositive){
+    fallbackRate = (falsePositive <= 0 || falsePositive >= 1) ? DEFAULT_FP_RATE : falsePositive;
+}
+
+/**
+ * Gets the number of IDs in the filter.
+ * @return The number of IDs added.
+ */
+uint64_t SpillFilter::getNumInserted(){
+    return numInserted;
+}
+
+/**
+ * Adds a new Bloom filter layer. Each layer doubles in capacity
+ * and halves its error rate so the total error stays bounded.
+ */
+void SpillFilter::addLayer(){
+    FilterLayer layer;
+    int depth = (int) layers.size();
+    double rate = falsePositive * pow(0.5, depth + 1);
+
+    //Computes the size of the layer.
+    layer.capacity = initialCapacity << depth;
+    layer.count = 0;
+    double bits = -((double) layer.capacity * log(rate)) / (log(2.0) * log(2.0));
+    layer.numBits = (uint64_t) ceil(bits);
+    layer.numBits = ((layer.numBits + 63) / 64) * 64;
+    layer.numHashes = (int) round(((double) layer.numBits / layer.capacity) * log(2.0));
+    if (layer.numHashes < 1) layer.numHashes = 1;
+    if (layer.numHashes > MAX_HASHES) layer.numHashes = MAX_HASHES;
+    layer.bits = vector<uint64_t>(layer.numBits / 64, 0);
+
+    layers.push_back(layer);
+}
+
+/**
+ * Checks whether a layer contains a fingerprint.
+ * @param layer The layer to check.
+ * @param print The fingerprint.
+ * @return Whether all bits are set.
+ */
+bool SpillFilter::layerContains(const FilterLayer& layer, const Fingerprint& print){
+    uint64_t step = print.low | 1;
+    for (int i = 0; i < layer.numHashes; i++){
+        uint64_t bit = (print.high + i * step) % layer.numBits;
+        if ((layer.bits[bit / 64] & ((uint64_t) 1 << (bit % 64))) == 0) return false;
+    }
+
+    return true;
+}
+
+/**
+ * Adds a fingerprint to a layer.
+ * @param layer The layer to add to.
+ * @param print The fingerprint.
+ */
+void SpillFilter::layerInsert(FilterLayer& layer, const Fingerprint& print){
+    uint64_t step = print.low | 1;
+    for (int i = 0; i < layer.numHashes; i++){
+        uint64_t bit = (print.high + i * step) % layer.numBits;
+        layer.bits[bit / 64] |= ((uint64_t) 1 << (bit % 64));
+    }
+    layer.count++;
+}
+
+/**
+ * Checks the exact index for a fingerprint.
+ * @param print The fingerprint to look up.
+ * @return Whether the fingerprint is in the index.
+ */
+bool SpillFilter::indexContains(const Fingerprint& print){
+    uint64_t slot = print.high & (numSlots - 1);
+
+    //Linear probe until we hit an empty slot.
+    Fingerprint cur;
+    for (uint64_t i = 0; i < numSlots; i++){
+        //A duplicate is safer than dropping a new node.
+        if (!readSlot(indexFD, slot, &cur)){
+            cerr << "Warning: Could not read the spilled node index at " << indexFN << "." << endl;
+            return false;
+        }
+        if (isEmpty(cur)) return false;
+        if (cur.high == print.high && cur.low == print.low) return true;
+
+        slot = (slot + 1) & (numSlots - 1);
+    }
+
+    return false;
+}
+
+/**
+ * Adds a fingerprint to the exact index.
+ * @param print The fingerprint to add.
+ * @return Whether the fingerprint was added, already present or couldn't be stored.
+ */
+SpillFilter::IndexResult SpillFilter::indexInsert(const Fingerprint& print){
+    //Keeps the load factor under half.
+    if ((usedSlots + 1) * 2 > numSlots && !growIndex()) return INDEX_FAILED;
+
+    IndexResult result = indexInsert(indexFD, numSlots, print);
+    if (result == INDEX_ADDED) usedSlots++;
+    return result;
+}
+
+/**
+ * Adds a fingerprint to an index file.
+ * @param fd The index file.
+ * @param slots The number of slots in the file.
+ * @param print The fingerprint to add.
+ * @return Whether the fingerprint was added, already present or couldn't be stored.
+ */
+SpillFilter::IndexResult SpillFilter::indexInsert(int fd, uint64_t slots, const Fingerprint& print){
+    uint64_t slot = print.high & (slots - 1);
+
+    //Linear probe for the first free slot.
+    Fingerprint cur;
+    for (uint64_t i = 0; i < slots; i++){
+        if (!readSlot(fd, slot, &cur)) return INDEX_FAILED;
+        if (isEmpty(cur)) return (writeSlot(fd, slot, print)) ? INDEX_ADDED : INDEX_FAILED;
+        if (cur.high == print.high && cur.low == print.low) return INDEX_PRESENT;
+
+        slot = (slot + 1) & (slots - 1);
+    }
+
+    return INDEX_FAILED;
+}
+
+/**
+ * Doubles the size of the exact index by rehashing into a new file.
+ * @return Whether the index was grown.
+ */
+bool SpillFilter::growIndex(){
+    string tempFN = indexFN + TEMP_EXT;
+    uint64_t newSlots = numSlots * 2;
+
+    //Creates the new index.
+    int fd = open(tempFN.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd == -1) return false;
+    if (ftruncate(fd, newSlots * SLOT_SIZE) != 0){
+        close(fd);
+        std::remove(tempFN.c_str());
+        return false;
+    }
+
+    //Moves every entry over.
+    Fingerprint cur;
+    for (uint64_t i = 0; i < numSlots; i++){
+        if (!readSlot(indexFD, i, &cur) || (!isEmpty(cur) && indexInsert(fd, newSlots, cur) == INDEX_FAILED)){
+            close(fd);
+            std::remove(tempFN.c_str());
+            return false;
+        }
+    }
+
+    //Swaps the files.
+    if (rename(tempFN.c_str(), indexFN.c_str()) != 0){
+        close(fd);
+        std::remove(tempFN.c_str());
+        return false;
+    }
+    close(indexFD);
+    indexFD = fd;
+    numSlots = newSlots;
+
+    return true;
+}
+
+/**
+ * Handles an index that can no longer be used. The Bloom filter is
+ * rebuilt from the index at the fallback error rate. If the index
+ * can't be read, the filter stops reporting hits instead.
+ */
+void SpillFilter::loseIndex(){
+    if (indexFD == -1) return;
+    cerr << "Warning: The spilled node index at " << indexFN << " was lost." << endl;
+
+    //Rebuilds the layers at the stricter error rate.
+    vector<FilterLayer> oldLayers = layers;
+    double oldRate = falsePositive;
+    uint64_t oldInserted = numInserted;
+    layers.clear();
+    falsePositive = fallbackRate;
+    numInserted = 0;
+    addLayer();
+
+    Fingerprint print;
+    for (uint64_t i = 0; i < numSlots && trusted; i++){
+        if (!readSlot(indexFD, i, &print)){
+            trusted = false;
+            break;
+        }
+        if (isEmpty(print)) continue;
+
+        if (layers.back().count >= layers.back().capacity) addLayer();
+        layerInsert(layers.back(), print);
+        numInserted++;
+    }
+
+    //Stops deduplicating if the index couldn't be read.
+    if (!trusted){
+        cerr << "Warning: Spilled nodes will no longer be deduplicated." << endl;
+        layers = oldLayers;
+        falsePositive = oldRate;
+        numInserted = oldInserted;
+    }
+
+    disableIndex(true);
+}
+
+/**
+ * Reads a slot from an index file.
+ * @param fd The index file.
+ * @param slot The slot number.
+ * @param print The fingerprint that was read.
+ * @return Whether the read worked.
+ */
+bool SpillFilter::readSlot(int fd, uint64_t slot, Fingerprint* print){
+    unsigned char buffer[SLOT_SIZE];
+    if (pread(fd, buffer, SLOT_SIZE, (off_t) (slot * SLOT_SIZE)) != SLOT_SIZE) return false;
+
+    memcpy(&print->high, buffer, sizeof(uint64_t));
+    memcpy(&print->low, buffer + sizeof(uint64_t), sizeof(uint64_t));
+    return true;
+}
+
+/**
+ * Writes a slot to an index file.
+ * @param fd The index file.
+ * @param slot The slot number.
+ * @param print The fingerprint to write.
+ * @return Whether the write worked.
+ */
+bool SpillFilter::writeSlot(int fd, uint64_t slot, const Fingerprint& print){
+    unsigned char buffer[SLOT_SIZE];
+    memcpy(buffer, &print.high, sizeof(uint64_t));
+    memcpy(buffer + sizeof(uint64_t), &print.low, sizeof(uint64_t));
+
+    return pwrite(fd, buffer, SLOT_SIZE, (off_t) (slot * SLOT_SIZE)) == SLOT_SIZE;
+}
+
+/**
+ * Generates a 128-bit fingerprint for an ID. IDs that are already
+ * MD5 strings are decoded directly, everything else is hashed.
+ * @param ID The ID to fingerprint.
+ * @return The fingerprint.
+ */
+SpillFilter::Fingerprint SpillFilter::generateFingerprint(const string& ID){
+    Fingerprint print;
+
+    if (ID.size() != MD5_DIGEST_LENGTH * 2 || !hexToInt(ID, 0, &print.high) ||
+            !hexToInt(ID, MD5_DIGEST_LENGTH, &print.low)){
+        unsigned char digest[MD5_DIGEST_LENGTH];
+        MD5((const unsigned char*) ID.c_str(), ID.size(), digest);
+
+        memcpy(&print.high, digest, sizeof(uint64_t));
+        memcpy(&print.low, digest + sizeof(uint64_t), sizeof(uint64_t));
+    }
+
+    //Zero is reserved for empty slots.
+    if (isEmpty(print)) print.high = 1;
+    return print;
+}
+
+/**
+ * Checks whether a fingerprint marks an empty slot.
+ * @param print The fingerprint.
+ * @return Whether it is empty.
+ */
+bool SpillFilter::isEmpty(const Fingerprint& print){
+    return print.high == 0 && print.low == 0;
+}
+
+/**
+ * Converts 16 hex characters into an integer.
+ * @param ID The ID string.
+ * @param start The first character.
+ * @param value The resulting value.
+ * @return Whether the characters were all hex digits.
+ */
+bool SpillFilter::hexToInt(const string& ID, int start, uint64_t* value){
+    uint64_t result = 0;
+
+    for (int i = start; i < start + 16; i++){
+        char cur = ID[i];
+        result <<= 4;
+
+        if (cur >= '0' && cur <= '9') result |= (uint64_t) (cur - '0');
+        else if (cur >= 'a' && cur <= 'f') result |= (uint64_t) (cur - 'a' + 10);
+        else if (cur >= 'A' && cur <= 'F') result |= (uint64_t) (cur - 'A' + 10);
+        else return false;
+    }
+
+    *value = result;
+    return true;
+}
@@ -0,0 +1,118 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// SpillFilter.h
+//
+// Created By: Bryan J Muscedere
+// Date: 19/10/26.
+//
+// Membership filter for node IDs that have already been spilled to
+// disk by the low-memory graph. Uses a scalable Bloom filter to rule
+// out new IDs cheaply and an optional on-disk hash index to confirm
+// positive results exactly.
+//
+// Copyright (C) 2017, Bryan J. Muscedere
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CLANGEX_SPILLFILTER_H
+#define CLANGEX_SPILLFILTER_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+class SpillFilter {
+public:
+    /** Constructor/Destructor */
+    SpillFilter(uint64_t initialCapacity = DEFAULT_CAPACITY, double falsePositive = DEFAULT_FP_RATE);
+    ~SpillFilter();
+
+    /** Filter Operations */
+    void insert(const std::string& ID);
+    bool contains(const std::string& ID);
+    void clear();
+
+    /** Exact Index Operations */
+    bool enableIndex(std::string indexFN, bool reuse = false);
+    void disableIndex(bool remove = true);
+    void changeIndexLocation(std::string indexFN);
+    bool isIndexEnabled();
+    void setFallbackRate(double falsePositive);
+
+    /** Getters */
+    uint64_t getNumInserted();
+
+    static const uint64_t DEFAULT_CAPACITY;
+    static const double DEFAULT_FP_RATE;
+
+private:
+    /** Fingerprint Type */
+    typedef struct {
+        uint64_t high;
+        uint64_t low;
+    } Fingerprint;
+
+    /** Bloom Filter Layer */
+    typedef struct {
+        std::vector<uint64_t> bits;
+        uint64_t numBits;
+        uint64_t capacity;
+        uint64_t count;
+        int numHashes;
+    } FilterLayer;
+
+    /** Index Insertion Results */
+    enum IndexResult {INDEX_ADDED, INDEX_PRESENT, INDEX_FAILED};
+
+    const static int SLOT_SIZE = 16;
+    const static uint64_t INITIAL_SLOTS = 1 << 16;
+    const static int MAX_HASHES = 16;
+    const std::string TEMP_EXT = ".tmp";
+
+    /** Bloom Filter Variables */
+    std::vector<FilterLayer> layers;
+    uint64_t initialCapacity;
+    double falsePositive;
+    double fallbackRate;
+    uint64_t numInserted;
+    bool trusted;
+
+    /** Exact Index Variables */
+    int indexFD;
+    std::string indexFN;
+    uint64_t numSlots;
+    uint64_t usedSlots;
+
+    /** Bloom Filter Helpers */
+    void addLayer();
+    bool layerContains(const FilterLayer& layer, const Fingerprint& print);
+    void layerInsert(FilterLayer& layer, const Fingerprint& print);
+
+    /** Exact Index Helpers */
+    bool indexContains(const Fingerprint& print);
+    IndexResult indexInsert(const Fingerprint& print);
+    IndexResult indexInsert(int fd, uint64_t slots, const Fingerprint& print);
+    bool growIndex();
+    void loseIndex();
+    bool readSlot(int fd, uint64_t slot, Fingerprint* print);
+    bool writeSlot(int fd, uint64_t slot, const Fingerprint& print);
+
+    /** Fingerprint Helpers */
+    Fingerprint generateFingerprint(const std::string& ID);
+    bool isEmpty(const Fingerprint& print);
+    bool hexToInt(const std::string& ID, int start, uint64_t* value);
+};
+
+
+#endif //CLANGEX_SPILLFILTER_H
@@ -0,0 +1,363 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// SpillStream.cpp
+//
+// Created By: Bryan J Muscedere
+// Date: 19/10/26.
+//
+// Reads and writes the spill files used by the low-memory graph.
+// Files can either be plain TA text or a series of independently
+// compressed blocks. Readers detect which format is used.
+//
+// Copyright (C) 2017, Bryan J. Muscedere
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include <zlib.h>
+#include "SpillStream.h"
+
+using namespace std;
+
+/** Block Format */
+const char SpillFormat::MAGIC[4] = {'C', 'X', 'S', 'P'};
+
+/**
+ * Opens a spill file for writing. When appending, the format
+ * of the existing file is kept.
+ * @param fileName The file to write to.
+ * @param append Whether we append to the file.
+ * @param compress Whether new files are compressed.
+ * @param blockSize The size of each uncompressed block, up to the maximum.
+ * @param level The compression level.
+ */
+SpillWriter::SpillWriter(string fileName, bool append, bool compress, int blockSize, int level) {
+    this->compress = compress;
+    this->blockSize = (blockSize > 0) ? (size_t) blockSize : SpillFormat::DEFAULT_BLOCK_SIZE;
+    if (this->blockSize > SpillFormat::MAX_BLOCK_SIZE) this->blockSize = SpillFormat::MAX_BLOCK_SIZE;
+    this->level = level;
+    failed = false;
+
+    //Checks the format of an existing file.
+    bool empty = true;
+    if (append){
+        FILE* existing = fopen(fileName.c_str(), "rb");
+        if (existing != nullptr){
+            char magic[SpillFormat::MAGIC_SIZE];
+            size_t amt = fread(magic, 1, SpillFormat::MAGIC_SIZE, existing);
+            if (amt > 0){
+                empty = false;
+                this->compress = (amt == SpillFormat::MAGIC_SIZE &&
+                        memcmp(magic, SpillFormat::MAGIC, SpillFormat::MAGIC_SIZE) == 0);
+            }
+            fclose(existing);
+        }
+    }
+
+    //Opens the file.
+    file = fopen(fileName.c_str(), (append) ? "ab" : "wb");
+    if (file == nullptr) return;
+
+    if (this->compress && empty){
+        if (fwrite(SpillFormat::MAGIC, 1, SpillFormat::MAGIC_SIZE, file) != SpillFormat::MAGIC_SIZE) failed = true;
+    }
+}
+
+/**
+ * Closes the file if it's still open.
+ */
+SpillWriter::~SpillWriter() {
+    close();
+}
+
+/**
+ * Checks whether the file was opened.
+ * @return Whether the file is open.
+ */
+bool SpillWriter::isOpen(){
+    return file != nullptr && !failed;
+}
+
+/**
+ * Writes data to the spill file.
+ * @param data The data to write.
+ * @return Whether the write was successful.
+ */
+bool SpillWriter::write(const string& data){
+    if (file == nullptr || failed) return false;
+
+    //Writes directly for plain files.
+    if (!compress){
+        if (fwrite(data.c_str(), 1, data.size(), file) != data.size()) failed = true;
+        return !failed;
+    }
+
+    //Fills up blocks.
+    buffer += data;
+    while (buffer.size() >= blockSize && !failed){
+        flushBlock();
+    }
+
+    return !failed;
+}
+
+/**
+ * Flushes any remaining data and closes the file.
+ * @return Whether everything was written.
+ */
+bool SpillWriter::close(){
+    if (file == nullptr) return !failed;
+
+    //Writes the last block.
+    while (compress && buffer.size() > 0 && !failed){
+        flushBlock();
+    }
+
+    if (fclose(file) != 0) failed = true;
+    file = nullptr;
+    buffer.clear();
+
+    return !failed;
+}
+
+/**
+ * Compresses and writes the next block in the buffer.
+ * @return Whether the block was written.
+ */
+bool SpillWriter::flushBlock(){
+    size_t rawLen = (buffer.size() < blockSize) ? buffer.size() : blockSize;
+
+    //Compresses the block.
+    uLongf compLen = compressBound((uLong) rawLen);
+    vector<unsigned char> compData(compLen);
+    int code = compress2(compData.data(), &compLen, (const Bytef*) buffer.data(), (uLong) rawLen, level);
+
+    //Stores the block as is if compression didn't help.
+    const unsigned char* out = compData.data();
+    if (code != Z_OK || compLen >= rawLen){
+        out = (const unsigned char*) buffer.data();
+        compLen = rawLen;
+    }
+
+    //Writes the block.
+    unsigned char header[SpillFormat::HEADER_SIZE];
+    SpillFormat::encodeHeader(header, (uint32_t) rawLen, (uint32_t) compLen);
+    if (fwrite(header, 1, SpillFormat::HEADER_SIZE, file) != SpillFormat::HEADER_SIZE ||
+            fwrite(out, 1, compLen, file) != compLen){
+        failed = true;
+        return false;
+    }
+
+    buffer.erase(0, rawLen);
+    return true;
+}
+
+/**
+ * Opens a spill file for reading.
+ * @param fileName The file to read.
+ */
+SpillReader::SpillReader(string fileName) {
+    this->fileName = fileName;
+    compressed = false;
+    failed = false;
+    bufferPos = 0;
+
+    file = fopen(fileName.c_str(), "rb");
+    if (file == nullptr) return;
+
+    //Checks for the block format.
+    char magic[SpillFormat::MAGIC_SIZE];
+    size_t amt = fread(magic, 1, SpillFormat::MAGIC_SIZE, file);
+    if (amt == SpillFormat::MAGIC_SIZE && memcmp(magic, SpillFormat::MAGIC, SpillFormat::MAGIC_SIZE) == 0){
+        compressed = true;
+    } else {
+        rewind(file);
+    }
+}
+
+/**
+ * Closes the file.
+ */
+SpillReader::~SpillReader() {
+    close();
+}
+
+/**
+ * Checks whether the file was opened.
+ * @return Whether the file is open.
+ */
+bool SpillReader::isOpen(){
+    return file != nullptr;
+}
+
+/**
+ * Checks whether the file uses compressed blocks.
+ * @return Whether the file is compressed.
+ */
+bool SpillReader::isCompressed(){
+    return compressed;
+}
+
+/**
+ * Checks whether a corrupt or unreadable block was found.
+ * @return Whether reading failed.
+ */
+bool SpillReader::hasFailed(){
+    return failed;
+}
+
+/**
+ * Gets the next line from the file.
+ * @param line The line without the trailing newline.
+ * @return Whether a line was read.
+ */
+bool SpillReader::getline(string& line){
+    if (file == nullptr) return false;
+
+    //Looks for the end of the line.
+    size_t end;
+    while ((end = buffer.find('\n', bufferPos)) == string::npos){
+        if (!fillBuffer()){
+            //Returns the last unterminated line.
+            if (bufferPos >= buffer.size()) return false;
+            line = buffer.substr(bufferPos);
+            bufferPos = buffer.size();
+            return true;
+        }
+    }
+
+    line.assign(buffer, bufferPos, end - bufferPos);
+    bufferPos = end + 1;
+    return true;
+}
+
+/**
+ * Reads the next chunk of uncompressed data. Corrupt blocks stop
+ * the read and are reported.
+ * @param data The data that was read.
+ * @return The number of bytes read.
+ */
+size_t SpillReader::readBlock(string& data){
+    data.clear();
+    if (file == nullptr || failed) return 0;
+
+    //Plain files are read directly.
+    if (!compressed){
+        data.resize(SpillFormat::READ_SIZE);
+        size_t amt = fread(&data[0], 1, SpillFormat::READ_SIZE, file);
+        data.resize(amt);
+        return amt;
+    }
+
+    //Reads the header.
+    unsigned char header[SpillFormat::HEADER_SIZE];
+    if (fread(header, 1, SpillFormat::HEADER_SIZE, file) != SpillFormat::HEADER_SIZE) return 0;
+    uint32_t rawLen, compLen;
+    SpillFormat::decodeHeader(header, &rawLen, &compLen);
+    if (!SpillFormat::isValidHeader(rawLen, compLen)){
+        cerr << "Error: The spill file " << fileName << " has a corrupt block header." << endl;
+        failed = true;
+        return 0;
+    }
+
+    //Reads the block.
+    vector<unsigned char> compData(compLen);
+    if (fread(compData.data(), 1, compLen, file) != compLen){
+        cerr << "Error: The spill file " << fileName << " ends in the middle of a block." << endl;
+        failed = true;
+        return 0;
+    }
+
+    //Decompresses the block.
+    if (compLen == rawLen){
+        data.assign((const char*) compData.data(), compLen);
+    } else {
+        data.resize(rawLen);
+        uLongf outLen = rawLen;
+        if (uncompress((Bytef*) &data[0], &outLen, compData.data(), compLen) != Z_OK || outLen != rawLen){
+            cerr << "Error: A block in the spill file " << fileName << " could not be decompressed." << endl;
+            failed = true;
+            data.clear();
+            return 0;
+        }
+    }
+
+    return data.size();
+}
+
+/**
+ * Closes the file.
+ */
+void SpillReader::close(){
+    if (file != nullptr) fclose(file);
+    file = nullptr;
+    buffer.clear();
+    bufferPos = 0;
+}
+
+/**
+ * Adds the next block of data to the line buffer.
+ * @return Whether more data was read.
+ */
+bool SpillReader::fillBuffer(){
+    string data;
+    if (readBlock(data) == 0) return false;
+
+    buffer.erase(0, bufferPos);
+    bufferPos = 0;
+    buffer += data;
+    return true;
+}
+
+/**
+ * Writes a block header.
+ * @param header The 8 byte header.
+ * @param rawLen The uncompressed length.
+ * @param compLen The compressed length.
+ */
+void SpillFormat::encodeHeader(unsigned char* header, uint32_t rawLen, uint32_t compLen){
+    for (int i = 0; i < 4; i++){
+        header[i] = (unsigned char) ((rawLen >> (8 * i)) & 0xFF);
+        header[i + 4] = (unsigned char) ((compLen >> (8 * i)) & 0xFF);
+    }
+}
+
+/**
+ * Reads a block header.
+ * @param header The 8 byte header.
+ * @param rawLen The uncompressed length.
+ * @param compLen The compressed length.
+ */
+void SpillFormat::decodeHeader(const unsigned char* header, uint32_t* rawLen, uint32_t* compLen){
+    *rawLen = 0;
+    *compLen = 0;
+    for (int i = 0; i < 4; i++){
+        *rawLen |= ((uint32_t) header[i]) << (8 * i);
+        *compLen |= ((uint32_t) header[i + 4]) << (8 * i);
+    }
+}
+
+/**
+ * Checks whether block lengths could have come from a writer. Blocks
+ * are never larger than the maximum and are stored as is when
+ * compression doesn't make them smaller.
+ * @param rawLen The uncompressed length.
+ * @param compLen The compressed length.
+ * @return Whether the lengths are valid.
+ */
+bool SpillFormat::isValidHeader(uint32_t rawLen, uint32_t compLen){
+    return rawLen > 0 && rawLen <= (uint32_t) MAX_BLOCK_SIZE && compLen > 0 && compLen <= rawLen;
+}
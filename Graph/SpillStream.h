@@ -0,0 +1,102 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// SpillStream.h
+//
+// Created By: Bryan J Muscedere
+// Date: 19/10/26.
+//
+// Reads and writes the spill files used by the low-memory graph.
+// Files can either be plain TA text or a series of independently
+// compressed blocks. Readers detect which format is used.
+//
+// Copyright (C) 2017, Bryan J. Muscedere
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CLANGEX_SPILLSTREAM_H
+#define CLANGEX_SPILLSTREAM_H
+
+#include <string>
+#include <cstdio>
+#include <cstdint>
+
+class SpillWriter {
+public:
+    /** Constructor/Destructor */
+    SpillWriter(std::string fileName, bool append, bool compress, int blockSize, int level);
+    ~SpillWriter();
+
+    /** Write Operations */
+    bool isOpen();
+    bool write(const std::string& data);
+    bool close();
+
+private:
+    /** Private Variables */
+    FILE* file;
+    bool compress;
+    bool failed;
+    size_t blockSize;
+    int level;
+    std::string buffer;
+
+    /** Helper Methods */
+    bool flushBlock();
+};
+
+class SpillReader {
+public:
+    /** Constructor/Destructor */
+    SpillReader(std::string fileName);
+    ~SpillReader();
+
+    /** Read Operations */
+    bool isOpen();
+    bool isCompressed();
+    bool hasFailed();
+    bool getline(std::string& line);
+    size_t readBlock(std::string& data);
+    void close();
+
+private:
+    /** Private Variables */
+    FILE* file;
+    std::string fileName;
+    bool compressed;
+    bool failed;
+    std::string buffer;
+    size_t bufferPos;
+
+    /** Helper Methods */
+    bool fillBuffer();
+};
+
+class SpillFormat {
+public:
+    /** Block Format */
+    static const char MAGIC[4];
+    static const int MAGIC_SIZE = 4;
+    static const int HEADER_SIZE = 8;
+    static const int DEFAULT_BLOCK_SIZE = 256 * 1024;
+    static const int MAX_BLOCK_SIZE = 64 * 1024 * 1024;
+    static const int DEFAULT_LEVEL = 1;
+    static const size_t READ_SIZE = 64 * 1024;
+
+    /** Header Helpers */
+    static void encodeHeader(unsigned char* header, uint32_t rawLen, uint32_t compLen);
+    static void decodeHeader(const unsigned char* header, uint32_t* rawLen, uint32_t* compLen);
+    static bool isValidHeader(uint32_t rawLen, uint32_t compLen);
+};
+
+#endif //CLANGEX_SPILLSTREAM_H
@@ -26,14 +26,26 @@
 /////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include <ctime>
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <fstream>
 #include "TAGraph.h"
+#include "../TupleAttribute/TAProcessor.h"
 #include "../Walker/ASTWalker.h"
+#include "../Metrics/Metrics.h"
 
 using namespace std;
 
 /** File Attribute */
 const string TAGraph::FILE_ATTRIBUTE = "filename";
 
+/** Fragment Path List */
+const string TAGraph::PATHS_EXT = ".paths";
+const string TAGraph::TEMP_EXT = ".tmp";
+
 /**
  * Constructor. Creates all the member variables.
  * @param print The printer type to be used.
@@ -59,8 +71,12 @@ TAGraph::~TAGraph() {
  * @return Whether the node was added or not.
  */
 bool TAGraph::addNode(ClangNode *node, bool assumeValid) {
+    Metrics::Timer timer(Metrics::ADD_NODE);
+
     //Check if the node ID exists.
     if (!assumeValid && nodeExists(node->getID())){
+        Metrics::increment(Metrics::DUPLICATE_NODES);
+        if (hasCurrentTU) recordNode(node->getID());
         delete node;
         return false;
     }
@@ -68,6 +84,7 @@ bool TAGraph::addNode(ClangNode *node, bool assumeValid) {
     //Now, we simply add to the node list.
     nodeList[node->getID()] = node;
     nodeNameList[node->getName()].push_back(node->getID());
+    if (hasCurrentTU) recordNode(node->getID());
     return true;
 }
 
@@ -78,8 +95,12 @@ bool TAGraph::addNode(ClangNode *node, bool assumeValid) {
  * @return Whether the edge was added or not.
  */
 bool TAGraph::addEdge(ClangEdge *edge, bool assumeValid) {
+    Metrics::Timer timer(Metrics::ADD_EDGE);
+
     //Check if the edge already exists.
     if (!assumeValid && edgeExists(edge->getSrcID(), edge->getDstID(), edge->getType())){
+        Metrics::increment(Metrics::DUPLICATE_EDGES);
+        if (hasCurrentTU) recordEdge(findEdgeByIDs(edge->getSrcID(), edge->getDstID(), edge->getType()));
         delete edge;
         return false;
     } else if (edge->getSrcID().compare(edge->getDstID()) == 0 && edge->getType() == ClangEdge::EdgeType::CONTAINS){
@@ -100,6 +121,7 @@ bool TAGraph::addEdge(ClangEdge *edge, bool assumeValid) {
     //Now, we add the edge.
     edgeSrcList[edge->getSrcID()].push_back(edge);
     edgeDstList[edge->getDstID()].push_back(edge);
+    if (hasCurrentTU) recordEdge(edge);
     return true;
 }
 
@@ -111,11 +133,12 @@ bool TAGraph::addEdge(ClangEdge *edge, bool assumeValid) {
 void TAGraph::removeNode(ClangNode *node, bool unsafe) {
     //First, goes through and deletes the node from the map.
     nodeList[node->getID()] = nullptr;
+    if (provenance) forgetNode(node->getID());
 
     //Gets the vector with the name for the node.
     vector<string> nodeString = nodeNameList[node->getName()];
     for (int i = 0; i < nodeString.size(); i++){
-        if (nodeString.at(i).compare(node->getID())) {
+        if (nodeString.at(i).compare(node->getID()) == 0) {
             nodeString.erase(nodeString.begin() + i);
             break;
         }
@@ -155,6 +178,7 @@ void TAGraph::removeEdge(ClangEdge* edge){
             edgeDstList[edge->getDstID()].erase(edgeDstList[edge->getDstID()].begin() + i);
         }
     }
+    if (provenance) forgetEdge(edge);
     delete edge;
 
 }
@@ -171,6 +195,10 @@ bool TAGraph::addAttribute(string ID, string key, string value){
     ClangNode* node = findNodeByID(ID);
     if (node == nullptr) return false;
 
+    //Relabels the node when the name is given.
+    if (key.compare(LABEL_FLAG) == 0) return renameNode(node, value);
+    if (hasCurrentTU) recordAttribute(ID, string(), -1, key, value);
+
     //Check if the attribute exists.
     if (node->doesAttributeExist(key, value)) return true;
 
@@ -191,6 +219,7 @@ bool TAGraph::addAttribute(string IDSrc, string IDDst, ClangEdge::EdgeType type,
     //Get the edge.
     ClangEdge* edge = findEdgeByIDs(IDSrc, IDDst, type);
     if (edge == nullptr) return false;
+    if (hasCurrentTU) recordAttribute(IDSrc, IDDst, type, key, value);
 
     //Check if the attribute exists.
     if (edge->doesAttributeExist(key, value)) return true;
@@ -235,8 +264,10 @@ vector<ClangEdge*> TAGraph::getEdges(){
  * @return The node that was found.
  */
 ClangNode* TAGraph::findNodeByID(string ID) {
-    //We iterate through until we find the node.
-    return nodeList[ID];
+    //Looks up the node without adding an empty entry.
+    auto it = nodeList.find(ID);
+    if (it == nodeList.end()) return nullptr;
+    return it->second;
 }
 
 /**
@@ -334,8 +365,7 @@ vector<ClangEdge*> TAGraph::findEdgesByDstID(ClangNode* dst){
  * @return Whether it exists or not.
  */
 bool TAGraph::nodeExists(string ID) {
-    if (nodeList[ID] == nullptr) return false;
-    return true;
+    return findNodeByID(ID) != nullptr;
 }
 
 /**
@@ -363,16 +393,79 @@ bool TAGraph::edgeExists(string IDOne, string IDTwo, ClangEdge::EdgeType type) {
  * @return The string of the TA representation.
  */
 string TAGraph::generateTAFormat() {
-    string format = generateTAHeader();
-    format += "FACT TUPLE :\n";
-    format += generateInstances();
-    format += generateRelationships() + "\n";
-    format += "FACT ATTRIBUTE :\n";
-    format += generateAttributes() + "\n";
+    string format = "";
+    writeTA([&](const string& data) {
+        format += data;
+        return true;
+    });
 
     return format;
 }
 
+/**
+ * Writes the TA representation of the graph to a file. The file is
+ * written beside its final name and replaced in one step, so a run
+ * that dies never leaves a partial file behind.
+ * @param fileName The file to write to.
+ * @return Whether the file was written.
+ */
+bool TAGraph::writeTAFile(string fileName) {
+    Metrics::Timer timer(Metrics::OUTPUT);
+    string tempName = fileName + TEMP_EXT;
+    int fd = open(tempName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return false;
+
+    if (!writeTAStream(fd)) {
+        close(fd);
+        unlink(tempName.c_str());
+        return false;
+    }
+    return replaceFile(fd, tempName, fileName);
+}
+
+/**
+ * Writes the TA representation of the graph to an open descriptor.
+ * The output is written in small blocks so the whole TA string is
+ * never built in memory.
+ * @param fd The descriptor to write to.
+ * @return Whether the TA was written.
+ */
+bool TAGraph::writeTAStream(int fd) {
+    Metrics::Timer timer(Metrics::OUTPUT);
+    string buffer = "";
+    bool succ = writeTA([&](const string& data) {
+        buffer += data;
+        if (buffer.size() < STREAM_BLOCK_SIZE) return true;
+        bool written = writeData(fd, buffer);
+        buffer.clear();
+        return written;
+    });
+
+    return succ && writeData(fd, buffer);
+}
+
+/**
+ * Loads an existing TA file into the graph. Entries are added as they
+ * are read so the file is never held in memory twice. Large files are
+ * parsed in chunks on several threads when read threads are set.
+ * @param fileName The TA file to load.
+ * @param print The printer that prints messages.
+ * @return Whether the file was loaded.
+ */
+bool TAGraph::loadTAFile(string fileName, Printer* print) {
+    TAProcessor processor(INSTANCE_FLAG, print);
+    processor.setThreads(readThreads);
+    return processor.readTAFile(fileName, this);
+}
+
+/**
+ * Sets the number of threads used to parse large TA files.
+ * @param threads The number of threads.
+ */
+void TAGraph::setReadThreads(int threads){
+    readThreads = (threads < 1) ? 1 : threads;
+}
+
 /**
  * Adds nodes in the graph to a file node.
  * @param fileSkip Whether we're going to skip a certain component.
@@ -435,7 +528,7 @@ void TAGraph::resolveExternalReferences(Printer* print, bool silent) {
 
             if (!src || !dst){
                 unresolved++;
-                toRemove.push_back(edge);
+                if (!keepUnresolved) toRemove.push_back(edge);
                 continue;
             }
 
@@ -448,6 +541,7 @@ void TAGraph::resolveExternalReferences(Printer* print, bool silent) {
     for (ClangEdge* edge : toRemove){
         removeEdge(edge);
     }
+    Metrics::increment(Metrics::UNRESOLVED_EDGES, unresolved);
 
     //Afterwards, notify of success.
     if (!silent){
@@ -467,11 +561,22 @@ void TAGraph::resolveFiles(TAGraph::ClangExclude exclusions){
     //Gets all the associated clang nodes.
     fileParser.processPaths(fileNodes, fileEdges);
 
-    //Adds them to the graph.
+    //Adds them to the graph. Nodes that are already in the graph are reused.
+    map<ClangNode*, ClangNode*> existing;
+    vector<ClangNode*> duplicates;
     for (ClangNode *file : fileNodes) {
         if ((file->getType() == ClangNode::NodeType::SUBSYSTEM && !exclusions.cSubSystem) ||
             (file->getType() == ClangNode::NodeType::FILE && !exclusions.cFile)) {
-            addNode(file, assumeValid);
+            auto it = nodeList.find(file->getID());
+            if (it != nodeList.end() && it->second != nullptr) {
+                existing[file] = it->second;
+                duplicates.push_back(file);
+            } else if (isNodeStored(file->getID())) {
+                existing[file] = file;
+                detachedNodes.push_back(file);
+            } else {
+                addNode(file, assumeValid);
+            }
         } else {
             delete file;
         }
@@ -480,13 +585,36 @@ void TAGraph::resolveFiles(TAGraph::ClangExclude exclusions){
     //Adds the edges to the graph.
     map<string, ClangNode*> fileSkip;
     for (ClangEdge *edge : fileEdges) {
+        ClangNode* src = edge->getSrc();
+        ClangNode* dst = edge->getDst();
+        auto srcIt = existing.find(src);
+        auto dstIt = existing.find(dst);
+        if (srcIt != existing.end()) src = srcIt->second;
+        if (dstIt != existing.end()) dst = dstIt->second;
+
         //Surpasses.
         if (exclusions.cFile && edge->getDst()->getType() == ClangNode::FILE){
-            fileSkip[edge->getDst()->getID()] = edge->getSrc();
-        } else {
-            addEdge(edge, assumeValid);
+            fileSkip[edge->getDst()->getID()] = src;
+            continue;
+        }
+
+        //Skips containment that was already added.
+        if (srcIt != existing.end() && dstIt != existing.end() &&
+                (src == srcIt->first || dst == dstIt->first ||
+                 edgeExists(src->getID(), dst->getID(), edge->getType()))) {
+            delete edge;
+            continue;
+        }
+
+        //Points the edge at the nodes in the graph.
+        if (src != edge->getSrc() || dst != edge->getDst()) {
+            ClangEdge* remapped = new ClangEdge(src, dst, edge->getType());
+            delete edge;
+            edge = remapped;
         }
+        addEdge(edge, assumeValid);
     }
+    for (ClangNode* node : duplicates) delete node;
 
     //Next, for each item in the graph, add it to a file.
     addNodesToFile(fileSkip);
@@ -500,6 +628,182 @@ void TAGraph::addPath(string path){
     fileParser.addPath(path);
 }
 
+/**
+ * Gets the paths added to the TA graph.
+ * @return The paths.
+ */
+vector<string> TAGraph::getPaths(){
+    return fileParser.getPaths();
+}
+
+/**
+ * Removes every path from the TA graph. File nodes that were already
+ * resolved stay in the graph.
+ */
+void TAGraph::clearPaths(){
+    fileParser = FileParse();
+}
+
+/**
+ * Writes the graph as a fragment. Edges are written as they are and the
+ * file paths are written beside the TA file so a later link can build
+ * the file containment. The paths go first, so a fragment whose TA file
+ * exists is complete.
+ * @param fileName The TA file to write.
+ * @return Whether the fragment was written.
+ */
+bool TAGraph::writeFragment(string fileName){
+    string pathName = fileName + PATHS_EXT;
+    string tempName = pathName + TEMP_EXT;
+    int fd = open(tempName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return false;
+
+    string paths = "";
+    for (string path : fileParser.getPaths()) paths += path + "\n";
+    if (!writeData(fd, paths)) {
+        close(fd);
+        unlink(tempName.c_str());
+        return false;
+    }
+    if (!replaceFile(fd, tempName, pathName)) return false;
+
+    return writeTAFile(fileName);
+}
+
+/**
+ * Loads a fragment written by writeFragment.
+ * @param fileName The TA file to load.
+ * @param print The printer that prints messages.
+ * @return Whether the fragment was loaded.
+ */
+bool TAGraph::loadFragment(string fileName, Printer* print){
+    if (!loadTAFile(fileName, print)) return false;
+
+    //Fragments without paths contribute no files.
+    std::ifstream pathFile(fileName + PATHS_EXT);
+    if (!pathFile.is_open()) return true;
+
+    string path;
+    while (getline(pathFile, path)){
+        if (path.compare("") != 0) addPath(path);
+    }
+
+    return true;
+}
+
+/**
+ * Moves the contents of a fragment into this graph. Nodes that already
+ * exist are kept like they are during extraction and edge attributes
+ * are combined. Edges are left unresolved until the references are
+ * resolved. Facts are recorded for the current translation unit. The
+ * fragment is empty afterwards.
+ * @param fragment The graph to move in.
+ */
+void TAGraph::linkGraph(TAGraph* fragment){
+    //Moves the nodes.
+    for (auto it = fragment->nodeList.begin(); it != fragment->nodeList.end(); it++){
+        ClangNode* node = it->second;
+        if (!node) continue;
+
+        auto existing = nodeList.find(node->getID());
+        bool found = existing != nodeList.end() && existing->second != nullptr;
+        if (found && hasCurrentTU) recordNode(node->getID());
+
+        //Values the node already has are recorded for this translation unit too.
+        for (auto const& attr : node->getAttributes()){
+            if (!hasCurrentTU || attr.first.compare(LABEL_FLAG) == 0) continue;
+            for (string value : attr.second){
+                if (found && !existing->second->doesAttributeExist(attr.first, value)) continue;
+                recordAttribute(node->getID(), string(), -1, attr.first, value);
+            }
+        }
+
+        if (found) {
+            delete node;
+        } else {
+            addNode(node, true);
+        }
+    }
+    fragment->nodeList.clear();
+    fragment->nodeNameList.clear();
+
+    //Moves the edges.
+    for (auto it = fragment->edgeSrcList.begin(); it != fragment->edgeSrcList.end(); it++){
+        for (ClangEdge* edge : it->second){
+            ClangEdge* existing = findEdgeByIDs(edge->getSrcID(), edge->getDstID(), edge->getType());
+            ClangEdge* target = existing;
+            if (target == nullptr) target = new ClangEdge(edge->getSrcID(), edge->getDstID(), edge->getType());
+
+            //Copies the attributes.
+            for (auto const& attr : edge->getAttributes()){
+                for (string value : attr.second){
+                    if (hasCurrentTU) recordAttribute(edge->getSrcID(), edge->getDstID(), edge->getType(), attr.first, value);
+                    if (!target->doesAttributeExist(attr.first, value)) target->addAttribute(attr.first, value);
+                }
+            }
+
+            if (existing == nullptr) {
+                addEdge(target);
+            } else if (hasCurrentTU) {
+                recordEdge(existing);
+            }
+            delete edge;
+        }
+    }
+    fragment->edgeSrcList.clear();
+    fragment->edgeDstList.clear();
+
+    //Moves the paths.
+    for (string path : fragment->fileParser.getPaths()) addPath(path);
+}
+
+/**
+ * Moves the facts found in one translation unit into this graph. Facts
+ * that already exist are dropped like they are during extraction and
+ * edges are resolved against the nodes in this graph. The buffer is
+ * empty afterwards.
+ * @param buffer The graph holding the facts of the translation unit.
+ */
+void TAGraph::mergeGraph(TAGraph* buffer){
+    //Moves the nodes.
+    for (auto it = buffer->nodeList.begin(); it != buffer->nodeList.end(); it++){
+        ClangNode* node = it->second;
+        if (node == nullptr) continue;
+        if (!addNode(node) || !hasCurrentTU) continue;
+
+        for (auto const& attr : node->getAttributes()){
+            if (attr.first.compare(LABEL_FLAG) == 0) continue;
+            for (string value : attr.second) recordAttribute(node->getID(), string(), -1, attr.first, value);
+        }
+    }
+    buffer->nodeList.clear();
+    buffer->nodeNameList.clear();
+
+    //Moves the edges and points them at the nodes in this graph.
+    for (auto it = buffer->edgeSrcList.begin(); it != buffer->edgeSrcList.end(); it++){
+        for (ClangEdge* edge : it->second){
+            edge->unresolve(edge->getSrc());
+            edge->unresolve(edge->getDst());
+            ClangNode* src = findNodeByID(edge->getSrcID());
+            ClangNode* dst = findNodeByID(edge->getDstID());
+            if (src) edge->setSrc(src);
+            if (dst) edge->setDst(dst);
+            if (!addEdge(edge) || !hasCurrentTU) continue;
+
+            for (auto const& attr : edge->getAttributes()){
+                for (string value : attr.second)
+                    recordAttribute(edge->getSrcID(), edge->getDstID(), edge->getType(), attr.first, value);
+            }
+        }
+    }
+    buffer->edgeSrcList.clear();
+    buffer->edgeDstList.clear();
+
+    //Moves the paths.
+    for (string path : buffer->fileParser.getPaths()) addPath(path);
+    buffer->fileParser = FileParse();
+}
+
 /**
  * Clears the graph and deletes all items.
  */
@@ -518,6 +822,286 @@ void TAGraph::clearGraph(){
     }
     nodeList.clear();
     nodeNameList.clear();
+    for (ClangNode* node : detachedNodes) delete node;
+    detachedNodes.clear();
+
+    nodeSources.clear();
+    edgeSources.clear();
+    attrSources.clear();
+    sources = ProvenanceTable();
+}
+
+/**
+ * Turns tracking of the translation units behind each fact on or off.
+ * Only facts added while a translation unit is set are tracked. Facts
+ * without a source are never retracted.
+ * @param enabled Whether provenance is tracked.
+ */
+void TAGraph::setProvenance(bool enabled){
+    provenance = enabled;
+    if (!enabled) hasCurrentTU = false;
+}
+
+/**
+ * Sets whether edges that can't be resolved are kept. Kept edges are
+ * left out of the TA output and resolve again once the missing node
+ * is added. Graphs that retract translation units keep them so the
+ * edges come back when the node does.
+ * @param enabled Whether unresolved edges are kept.
+ */
+void TAGraph::setKeepUnresolved(bool enabled){
+    keepUnresolved = enabled;
+}
+
+/**
+ * Checks whether provenance is tracked.
+ * @return Whether provenance is tracked.
+ */
+bool TAGraph::isTrackingProvenance(){
+    return provenance;
+}
+
+/**
+ * Sets the translation unit that new facts come from.
+ * @param file The file of the translation unit or empty for none.
+ */
+void TAGraph::setCurrentTU(string file){
+    if (!provenance || file.compare("") == 0) {
+        hasCurrentTU = false;
+        return;
+    }
+
+    currentTU = sources.getTU(file);
+    hasCurrentTU = true;
+}
+
+/**
+ * Removes what a translation unit contributed. Facts that another
+ * translation unit also produced are kept. Edges that are still
+ * supported lose their removed endpoints and stay unresolved until
+ * the references are resolved again.
+ * @param file The file of the translation unit.
+ * @return The number of facts removed.
+ */
+int TAGraph::retractTU(string file){
+    uint32_t tu;
+    if (!provenance || !sources.findTU(file, &tu)) return 0;
+    int removed = 0;
+
+    //Retracts the attribute values.
+    for (auto it = attrSources.begin(); it != attrSources.end();) {
+        AttributeSource& attr = it->second;
+        attr.sources = sources.remove(attr.sources, tu);
+        if (attr.sources != ProvenanceTable::EMPTY_SET) {
+            it++;
+            continue;
+        }
+
+        if (attr.edgeType < 0) {
+            auto node = nodeList.find(attr.srcID);
+            if (node != nodeList.end() && node->second) node->second->removeAttribute(attr.key, attr.value);
+        } else {
+            ClangEdge* edge = findEdgeByIDs(attr.srcID, attr.dstID, (ClangEdge::EdgeType) attr.edgeType);
+            if (edge) edge->removeAttribute(attr.key, attr.value);
+        }
+        it = attrSources.erase(it);
+        removed++;
+    }
+
+    //Retracts the edges.
+    vector<ClangEdge*> edges;
+    for (auto& entry : edgeSources) {
+        entry.second = sources.remove(entry.second, tu);
+        if (entry.second == ProvenanceTable::EMPTY_SET) edges.push_back(entry.first);
+    }
+    for (ClangEdge* edge : edges) {
+        removeEdge(edge);
+        removed++;
+    }
+
+    //Retracts the nodes.
+    vector<string> nodes;
+    for (auto& entry : nodeSources) {
+        entry.second = sources.remove(entry.second, tu);
+        if (entry.second == ProvenanceTable::EMPTY_SET) nodes.push_back(entry.first);
+    }
+    for (string ID : nodes) {
+        auto it = nodeList.find(ID);
+        if (it == nodeList.end() || !it->second) {
+            forgetNode(ID);
+            continue;
+        }
+
+        ClangNode* node = it->second;
+        for (ClangEdge* edge : edgeSrcList[ID]) edge->unresolve(node);
+        for (ClangEdge* edge : edgeDstList[ID]) edge->unresolve(node);
+        removeNode(node, true);
+        removed++;
+    }
+
+    //Drops the attribute sources of removed nodes and edges.
+    for (auto it = attrSources.begin(); it != attrSources.end();) {
+        AttributeSource& attr = it->second;
+        bool exists = (attr.edgeType < 0) ? nodeExists(attr.srcID) :
+                      edgeExists(attr.srcID, attr.dstID, (ClangEdge::EdgeType) attr.edgeType);
+        if (exists) {
+            it++;
+            continue;
+        }
+
+        sources.release(attr.sources);
+        it = attrSources.erase(it);
+    }
+
+    return removed;
+}
+
+/**
+ * Gets the translation units that produced a node.
+ * @param ID The ID of the node.
+ * @return The files of the translation units.
+ */
+vector<string> TAGraph::getNodeSources(string ID){
+    vector<string> files;
+    auto it = nodeSources.find(ID);
+    if (it == nodeSources.end()) return files;
+
+    for (uint32_t tu : sources.getTUs(it->second)) files.push_back(sources.getTUName(tu));
+    return files;
+}
+
+/**
+ * Records that the current translation unit produced a node.
+ * @param ID The ID of the node.
+ */
+void TAGraph::recordNode(string ID){
+    ProvenanceTable::SetID& set = nodeSources[ID];
+    set = sources.add(set, currentTU);
+}
+
+/**
+ * Records that the current translation unit produced an edge.
+ * @param edge The edge in the graph.
+ */
+void TAGraph::recordEdge(ClangEdge* edge){
+    if (edge == nullptr) return;
+
+    ProvenanceTable::SetID& set = edgeSources[edge];
+    set = sources.add(set, currentTU);
+}
+
+/**
+ * Records that the current translation unit produced an attribute value.
+ * @param srcID The ID of the node or the source of the edge.
+ * @param dstID The destination of the edge or empty for nodes.
+ * @param edgeType The type of the edge or -1 for nodes.
+ * @param key The key of the attribute.
+ * @param value The value of the attribute.
+ */
+void TAGraph::recordAttribute(string srcID, string dstID, int edgeType, string key, string value){
+    string entry = srcID + '\0' + dstID + '\0' + to_string(edgeType) + '\0' + key + '\0' + value;
+    auto it = attrSources.find(entry);
+    if (it == attrSources.end()) {
+        AttributeSource attr;
+        attr.srcID = srcID;
+        attr.dstID = dstID;
+        attr.edgeType = edgeType;
+        attr.key = key;
+        attr.value = value;
+        attr.sources = ProvenanceTable::EMPTY_SET;
+        it = attrSources.insert(make_pair(entry, attr)).first;
+    }
+
+    it->second.sources = sources.add(it->second.sources, currentTU);
+}
+
+/**
+ * Stops tracking a node that is removed.
+ * @param ID The ID of the node.
+ */
+void TAGraph::forgetNode(string ID){
+    auto it = nodeSources.find(ID);
+    if (it == nodeSources.end()) return;
+
+    sources.release(it->second);
+    nodeSources.erase(it);
+}
+
+/**
+ * Stops tracking an edge that is removed.
+ * @param edge The edge.
+ */
+void TAGraph::forgetEdge(ClangEdge* edge){
+    auto it = edgeSources.find(edge);
+    if (it == edgeSources.end()) return;
+
+    sources.release(it->second);
+    edgeSources.erase(it);
+}
+
+/**
+ * Changes the name of a node and updates the name lookup.
+ * @param node The node to rename.
+ * @param name The new name.
+ * @return Whether the node was renamed.
+ */
+bool TAGraph::renameNode(ClangNode* node, string name){
+    //Removes the old name.
+    auto it = nodeNameList.find(node->getName());
+    if (it != nodeNameList.end()) {
+        vector<string>& IDs = it->second;
+        IDs.erase(remove(IDs.begin(), IDs.end(), node->getID()), IDs.end());
+        if (IDs.size() == 0) nodeNameList.erase(it);
+    }
+
+    //Adds the new name.
+    node->setName(name);
+    nodeNameList[name].push_back(node->getID());
+    return true;
+}
+
+/**
+ * Checks whether a node is kept outside of the in-memory graph.
+ * @param ID The ID of the node.
+ * @return Whether the node is stored elsewhere.
+ */
+bool TAGraph::isNodeStored(string ID){
+    return false;
+}
+
+/**
+ * Writes a string to a descriptor, retrying on short writes.
+ * @param fd The descriptor to write to.
+ * @param data The data to write.
+ * @return Whether all the data was written.
+ */
+bool TAGraph::writeData(int fd, const string& data) {
+    size_t written = 0;
+    while (written < data.size()) {
+        ssize_t amt = write(fd, data.data() + written, data.size() - written);
+        if (amt < 0 && errno == EINTR) continue;
+        if (amt <= 0) return false;
+        written += amt;
+    }
+
+    return true;
+}
+
+/**
+ * Syncs and closes a finished temporary file and moves it over its
+ * final name. The temporary file is removed if anything fails.
+ * @param fd The open descriptor of the temporary file.
+ * @param tempName The temporary file.
+ * @param fileName The final file.
+ * @return Whether the file was replaced.
+ */
+bool TAGraph::replaceFile(int fd, string tempName, string fileName) {
+    bool succ = fsync(fd) == 0;
+    if (close(fd) != 0) succ = false;
+    if (succ && rename(tempName.c_str(), fileName.c_str()) == 0) return true;
+
+    unlink(tempName.c_str());
+    return false;
 }
 
 /**
@@ -546,13 +1130,10 @@ string TAGraph::generateTAHeader() {
  */
 string TAGraph::generateInstances() {
     string instances = "";
-
-    //Iterate through our node list to generate.
-    for (auto it = nodeList.begin(); it != nodeList.end(); it++){
-        if (!it->second) continue;
-
-        instances += it->second->generateInstance() + "\n";
-    }
+    writeInstances([&](const string& data) {
+        instances += data;
+        return true;
+    });
 
     return instances;
 }
@@ -563,12 +1144,10 @@ string TAGraph::generateInstances() {
  */
 string TAGraph::generateRelationships() {
     string relationships = "";
-
-    //Iterate through our edge list to generate.
-    for (auto it = edgeSrcList.begin(); it != edgeSrcList.end(); it++){
-        for (ClangEdge* edge : it->second)
-            relationships += edge->generateRelationship() + "\n";
-    }
+    writeRelationships([&](const string& data) {
+        relationships += data;
+        return true;
+    });
 
     return relationships;
 }
@@ -579,24 +1158,86 @@ string TAGraph::generateRelationships() {
  */
 string TAGraph::generateAttributes() {
     string attributes = "";
+    writeAttributes([&](const string& data) {
+        attributes += data;
+        return true;
+    });
+
+    return attributes;
+}
+
+/**
+ * Writes the TA representation of the graph piece by piece. Both the
+ * TA string and the streamed TA are built from this.
+ * @param sink Takes each piece in order and returns false to stop.
+ * @return Whether every piece was taken.
+ */
+bool TAGraph::writeTA(const TASink& sink) {
+    if (!sink(generateTAHeader() + "FACT TUPLE :\n")) return false;
+    if (!writeInstances(sink) || !writeRelationships(sink)) return false;
+    if (!sink("\nFACT ATTRIBUTE :\n")) return false;
+    if (!writeAttributes(sink)) return false;
+
+    return sink("\n");
+}
+
+/**
+ * Writes the set of nodes for the TA file.
+ * @param sink Takes each instance line and returns false to stop.
+ * @return Whether every line was taken.
+ */
+bool TAGraph::writeInstances(const TASink& sink) {
+    //Iterate through our node list to generate.
+    for (auto it = nodeList.begin(); it != nodeList.end(); it++){
+        if (!it->second) continue;
+
+        if (!sink(it->second->generateInstance() + "\n")) return false;
+    }
+
+    return true;
+}
 
+/**
+ * Writes the set of edges for the TA file.
+ * @param sink Takes each relationship line and returns false to stop.
+ * @return Whether every line was taken.
+ */
+bool TAGraph::writeRelationships(const TASink& sink) {
+    //Iterate through our edge list to generate.
+    for (auto it = edgeSrcList.begin(); it != edgeSrcList.end(); it++){
+        for (ClangEdge* edge : it->second) {
+            if (keepUnresolved && !edge->isResolved()) continue;
+            if (!sink(edge->generateRelationship() + "\n")) return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Writes the set of attributes for the TA file.
+ * @param sink Takes each attribute line and returns false to stop.
+ * @return Whether every line was taken.
+ */
+bool TAGraph::writeAttributes(const TASink& sink) {
     //Iterate through our node list again to generate.
     for (auto it = nodeList.begin(); it != nodeList.end(); it++){
         if (!it->second) continue;
 
         string attribute = it->second->generateAttribute();
         if (attribute.compare("") == 0) continue;
-        attributes += attribute + "\n";
+        if (!sink(attribute + "\n")) return false;
     }
 
     //Next, iterate through our edge list.
     for (auto it = edgeSrcList.begin(); it != edgeSrcList.end(); it++){
         for (ClangEdge* edge : it->second) {
+            if (keepUnresolved && !edge->isResolved()) continue;
             string attribute = edge->generateAttribute();
             if (attribute.compare("") == 0) continue;
-            attributes += attribute + "\n";
+            if (!sink(attribute + "\n")) return false;
         }
     }
 
-    return attributes;
+    return true;
 }
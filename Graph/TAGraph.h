@@ -30,13 +30,17 @@
 
 #include <vector>
 #include <string>
+#include <functional>
 #include <unordered_map>
 #include "ClangNode.h"
 #include "ClangEdge.h"
+#include "Provenance.h"
 #include "../Printer/Printer.h"
 #include "../File/FileParse.h"
 
 class TAGraph {
+    friend class ConcurrentTAGraph;
+
 public:
     /** Toggle System */
     typedef struct {
@@ -86,36 +90,100 @@ public:
 
     /** TA Operations */
     virtual std::string generateTAFormat();
+    bool writeTAFile(std::string fileName);
+    virtual bool writeTAStream(int fd);
+    virtual bool loadTAFile(std::string fileName, Printer* print);
+    void setReadThreads(int threads);
     virtual void addNodesToFile(std::map<std::string, ClangNode*> fileSkip);
 
     /** Unresolved Operations */
     virtual void resolveExternalReferences(Printer* print, bool silent = false);
     virtual void resolveFiles(ClangExclude exclusions);
-    void addPath(std::string path);
+    virtual void addPath(std::string path);
+    std::vector<std::string> getPaths();
+    void clearPaths();
+
+    /** Fragment Operations */
+    bool writeFragment(std::string fileName);
+    bool loadFragment(std::string fileName, Printer* print);
+    void linkGraph(TAGraph* fragment);
+    virtual void mergeGraph(TAGraph* buffer);
+
+    /** Provenance System */
+    void setProvenance(bool enabled);
+    void setKeepUnresolved(bool enabled);
+    bool isTrackingProvenance();
+    void setCurrentTU(std::string file);
+    int retractTU(std::string file);
+    std::vector<std::string> getNodeSources(std::string ID);
 
     static const std::string FILE_ATTRIBUTE;
+    static const std::string PATHS_EXT;
+    static const std::string TEMP_EXT;
+    static const size_t STREAM_BLOCK_SIZE = 1 << 16;
 
 protected:
     std::string const INSTANCE_FLAG = "$INSTANCE";
+    std::string const LABEL_FLAG = "label";
 
     /** TA Variables */
     std::unordered_map<std::string, ClangNode*> nodeList;
     std::unordered_map<std::string, std::vector<std::string>> nodeNameList;
     std::unordered_map<std::string, std::vector<ClangEdge*>> edgeSrcList;
     std::unordered_map<std::string, std::vector<ClangEdge*>> edgeDstList;
+    std::vector<ClangNode*> detachedNodes;
+
+    /** Source of an Attribute Value */
+    typedef struct {
+        std::string srcID;
+        std::string dstID;
+        int edgeType;
+        std::string key;
+        std::string value;
+        ProvenanceTable::SetID sources;
+    } AttributeSource;
+
+    /** Provenance Variables */
+    bool provenance = false;
+    bool keepUnresolved = false;
+    bool hasCurrentTU = false;
+    uint32_t currentTU = 0;
+    ProvenanceTable sources;
+    std::unordered_map<std::string, ProvenanceTable::SetID> nodeSources;
+    std::unordered_map<ClangEdge*, ProvenanceTable::SetID> edgeSources;
+    std::unordered_map<std::string, AttributeSource> attrSources;
 
     /** Clear Graph */
     void clearGraph();
 
+    /** Provenance Helpers */
+    void recordNode(std::string ID);
+    void recordEdge(ClangEdge* edge);
+    void recordAttribute(std::string srcID, std::string dstID, int edgeType, std::string key, std::string value);
+    void forgetNode(std::string ID);
+    void forgetEdge(ClangEdge* edge);
+
+    /** Node Helpers */
+    bool renameNode(ClangNode* node, std::string name);
+    virtual bool isNodeStored(std::string ID);
+
     /** TA Helper Methods */
+    typedef std::function<bool(const std::string&)> TASink;
     std::string generateTAHeader();
     std::string generateInstances();
     std::string generateRelationships();
     std::string generateAttributes();
+    bool writeTA(const TASink& sink);
+    bool writeInstances(const TASink& sink);
+    bool writeRelationships(const TASink& sink);
+    bool writeAttributes(const TASink& sink);
+    static bool writeData(int fd, const std::string& data);
+    static bool replaceFile(int fd, std::string tempName, std::string fileName);
 
 private:
     /** Settings */
     FileParse fileParser;
+    int readThreads = 1;
 
     /** TA Const Variables */
     std::string const TA_HEADER = "//Generated TA File";
@@ -125,7 +193,8 @@ private:
             "able\t\tcAsgNds\n$INHERIT\tcLang\t\t\tcAsgNds\n$INHERIT\tcEnum\t\t\tcLang\n$INHERIT\tcEnumConst\t\tcLang\n"
             "$INHERIT\tcStruct\t\t\tcLang\n$INHERIT\tcUnion\t\t\tcLang\n\n//Relationships\ncontain\t\tcRoot\t\t\tcRoot\n"
             "call\t\tcFunction\t\tcFunction\nreference\tcAsgNds\t\t\tcAsgNds\ninherit\t\tcClass\t\t\tcClass\nfContain\t"
-            "cArchitecturalNds\tcAsgNds\n\nSCHEME ATTRIBUTE :\n$ENTITY {\n\tx\n\ty\n\twidth\n\theight\n\tlabel\n}\n\ncR"
+            "cArchitecturalNds\tcAsgNds\ninclude\t\tcFile\t\t\tcFile\n\nSCHEME ATTRIBUTE :\n$ENTITY {\n\tx\n\ty\n"
+            "\twidth\n\theight\n\tlabel\n}\n\ncR"
             "oot {\n\telision = contain\n\tcolor = (0.0 0.0 0.0)\n\tfile\n\tline\n\tname\n}\n\ncAsgNds {\n\tbeg\n\tend"
             "\n\tfile\n\tline\n\tvalue\n\tcolor = (0.0 0.0 0.0)\n}\n\ncArchitecturalNds {\n\tclass_style = 4\n\tcolor ="
             " (0.0 0.0 1.0)\n\tcolor = (0.0 0.0 0.0)\n}\n\ncSubSystem {\n\tclass_style = 4\n\tcolor = (1.0 1.0 1.0)\n\t"
@@ -0,0 +1,212 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Metrics.cpp
+//
+// Created By: Bryan J Muscedere
+// Date: 19/10/26.
+//
+// Low-overhead timers and counters for each phase of the extraction.
+// Everything is disabled by default and costs a single flag check until
+// metrics are turned on. Results are reported as JSON.
+//
+// Copyright (C) 2017, Bryan J. Muscedere
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <sys/resource.h>
+#include "Metrics.h"
+
+using namespace std;
+
+/** Metric Names */
+const char* Metrics::PHASE_NAMES[NUM_PHASES] = {"parse", "match", "generateID", "generateLabel", "addNode",
+                                                "addEdge", "purge", "resolve", "output"};
+const char* Metrics::COUNTER_NAMES[NUM_COUNTERS] = {"duplicateNodes", "duplicateEdges", "unresolvedEdges"};
+
+/** Metric Values */
+atomic<bool> Metrics::enabled(false);
+atomic<unsigned long long> Metrics::phaseTimes[NUM_PHASES];
+atomic<unsigned long long> Metrics::phaseCalls[NUM_PHASES];
+atomic<unsigned long long> Metrics::counters[NUM_COUNTERS];
+map<string, unsigned long long> Metrics::matchCounts;
+chrono::steady_clock::time_point Metrics::startTime = chrono::steady_clock::now();
+
+/** Guards the match counts */
+static mutex matchLock;
+
+/** How many timers of each phase are running on this thread */
+static thread_local int timerDepth[Metrics::NUM_PHASES];
+
+/**
+ * Starts timing a phase. Only the outermost timer of a phase on a
+ * thread records so recursive calls aren't counted twice.
+ * @param phase The phase to time.
+ */
+Metrics::Timer::Timer(Metrics::Phase phase) {
+    this->phase = phase;
+    counted = Metrics::isEnabled();
+    active = counted && timerDepth[phase]++ == 0;
+    if (active) start = chrono::steady_clock::now();
+}
+
+/**
+ * Stops timing the phase.
+ */
+Metrics::Timer::~Timer() {
+    if (active) Metrics::addTime(phase, chrono::steady_clock::now() - start);
+    if (counted) timerDepth[phase]--;
+}
+
+/**
+ * Turns metrics on or off.
+ * @param enabled Whether metrics are recorded.
+ */
+void Metrics::setEnabled(bool enabled){
+    Metrics::enabled.store(enabled, memory_order_relaxed);
+}
+
+/**
+ * Checks whether metrics are recorded.
+ * @return Whether metrics are enabled.
+ */
+bool Metrics::isEnabled(){
+    return enabled.load(memory_order_relaxed);
+}
+
+/**
+ * Clears every timer and counter.
+ */
+void Metrics::reset(){
+    for (int i = 0; i < NUM_PHASES; i++){
+        phaseTimes[i].store(0);
+        phaseCalls[i].store(0);
+    }
+    for (int i = 0; i < NUM_COUNTERS; i++) counters[i].store(0);
+
+    lock_guard<mutex> guard(matchLock);
+    matchCounts.clear();
+    startTime = chrono::steady_clock::now();
+}
+
+/**
+ * Adds time to a phase.
+ * @param phase The phase.
+ * @param time The time spent.
+ */
+void Metrics::addTime(Metrics::Phase phase, chrono::steady_clock::duration time){
+    if (!isEnabled()) return;
+
+    unsigned long long nanos = (unsigned long long) chrono::duration_cast<chrono::nanoseconds>(time).count();
+    phaseTimes[phase].fetch_add(nanos, memory_order_relaxed);
+    phaseCalls[phase].fetch_add(1, memory_order_relaxed);
+}
+
+/**
+ * Increments a counter.
+ * @param counter The counter.
+ * @param amount The amount to add.
+ */
+void Metrics::increment(Metrics::Counter counter, unsigned long long amount){
+    if (!isEnabled()) return;
+    counters[counter].fetch_add(amount, memory_order_relaxed);
+}
+
+/**
+ * Adds the match counts from a walker.
+ * @param matches The number of matches for each binding.
+ */
+void Metrics::addMatches(const map<string, unsigned long long>& matches){
+    if (!isEnabled()) return;
+
+    lock_guard<mutex> guard(matchLock);
+    for (auto entry : matches) matchCounts[entry.first] += entry.second;
+}
+
+/**
+ * Gets the peak resident memory of the process.
+ * @return The number of bytes.
+ */
+unsigned long long Metrics::getPeakMemory(){
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+
+    //Linux reports this in KiB.
+    return (unsigned long long) usage.ru_maxrss * 1024;
+}
+
+/**
+ * Generates a JSON report of every metric. Phase times are inclusive
+ * so nested phases are also counted in the phase that called them.
+ * @return The JSON report.
+ */
+string Metrics::generateJSON(){
+    stringstream json;
+    chrono::duration<double> total = chrono::steady_clock::now() - startTime;
+
+    json << "{" << endl << "  \"totalSeconds\": " << total.count() << "," << endl;
+
+    //Prints the phases.
+    json << "  \"phases\": {";
+    for (int i = 0; i < NUM_PHASES; i++){
+        json << ((i == 0) ? "" : ",") << endl << "    \"" << PHASE_NAMES[i] << "\": {\"seconds\": "
+             << phaseTimes[i].load() / 1e9 << ", \"calls\": " << phaseCalls[i].load() << "}";
+    }
+    json << endl << "  }," << endl;
+
+    //Prints the counters.
+    json << "  \"counters\": {";
+    for (int i = 0; i < NUM_COUNTERS; i++){
+        json << ((i == 0) ? "" : ",") << endl << "    \"" << COUNTER_NAMES[i] << "\": " << counters[i].load();
+    }
+    json << endl << "  }," << endl;
+
+    //Prints the matches.
+    json << "  \"matches\": {";
+    {
+        lock_guard<mutex> guard(matchLock);
+        bool first = true;
+        for (auto entry : matchCounts){
+            json << ((first) ? "" : ",") << endl << "    \"" << entry.first << "\": " << entry.second;
+            first = false;
+        }
+    }
+    json << endl << "  }," << endl;
+
+    json << "  \"peakMemoryBytes\": " << getPeakMemory() << endl << "}" << endl;
+    return json.str();
+}
+
+/**
+ * Writes the JSON report to a file.
+ * @param fileName The file to write to, or - for standard output.
+ * @return Whether the report was written.
+ */
+bool Metrics::writeJSON(string fileName){
+    if (fileName.compare("-") == 0) {
+        cout << generateJSON();
+        return true;
+    }
+
+    ofstream output(fileName);
+    if (!output.is_open()) return false;
+    output << generateJSON();
+    output.close();
+
+    return !output.fail();
+}
@@ -0,0 +1,84 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Metrics.h
+//
+// Created By: Bryan J Muscedere
+// Date: 19/10/26.
+//
+// Low-overhead timers and counters for each phase of the extraction.
+// Everything is disabled by default and costs a single flag check until
+// metrics are turned on. Results are reported as JSON.
+//
+// Copyright (C) 2017, Bryan J. Muscedere
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef CLANGEX_METRICS_H
+#define CLANGEX_METRICS_H
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <string>
+
+class Metrics {
+public:
+    /** Metric Types */
+    enum Phase {PARSE, MATCH, GENERATE_ID, GENERATE_LABEL, ADD_NODE, ADD_EDGE, PURGE, RESOLVE, OUTPUT, NUM_PHASES};
+    enum Counter {DUPLICATE_NODES, DUPLICATE_EDGES, UNRESOLVED_EDGES, NUM_COUNTERS};
+
+    /** Times a phase until it goes out of scope */
+    class Timer {
+    public:
+        Timer(Metrics::Phase phase);
+        ~Timer();
+
+    private:
+        Metrics::Phase phase;
+        bool counted;
+        bool active;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    /** Toggle Operations */
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+    static void reset();
+
+    /** Recording Operations */
+    static void addTime(Metrics::Phase phase, std::chrono::steady_clock::duration time);
+    static void increment(Metrics::Counter counter, unsigned long long amount = 1);
+    static void addMatches(const std::map<std::string, unsigned long long>& matches);
+
+    /** Reporting Operations */
+    static unsigned long long getPeakMemory();
+    static std::string generateJSON();
+    static bool writeJSON(std::string fileName);
+
+private:
+    /** Metric Names */
+    const static char* PHASE_NAMES[NUM_PHASES];
+    const static char* COUNTER_NAMES[NUM_COUNTERS];
+
+    /** Metric Values */
+    static std::atomic<bool> enabled;
+    static std::atomic<unsigned long long> phaseTimes[NUM_PHASES];
+    static std::atomic<unsigned long long> phaseCalls[NUM_PHASES];
+    static std::atomic<unsigned long long> counters[NUM_COUNTERS];
+    static std::map<std::string, unsigned long long> matchCounts;
+    static std::chrono::steady_clock::time_point startTime;
+};
+
+#endif //CLANGEX_METRICS_H
@@ -26,43 +26,13 @@
 /////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include <fstream>
-#include <boost/algorithm/string/split.hpp>
-#include <boost/algorithm/string/classification.hpp>
+#include <algorithm>
+#include <cstring>
+#include <thread>
 #include "TAProcessor.h"
 
 using namespace std;
 
-/**
- * Left trim string.
- * @param s The string to trim.
- * @return The trimmed string.
- */
-static inline string &ltrim(string &s) {
-    s.erase(s.begin(), find_if(s.begin(), s.end(),
-                                    not1(ptr_fun<int, int>(isspace))));
-    return s;
-}
-
-/**
- * Right trim string.
- * @param s The string to trim.
- * @return The trimmed string.
- */
-static inline string &rtrim(string &s) {
-    s.erase(find_if(s.rbegin(), s.rend(),
-                         not1(ptr_fun<int, int>(isspace))).base(), s.end());
-    return s;
-}
-
-/**
- * Overall trim string.
- * @param s The string to trim.
- * @return The trimmed string.
- */
-static inline string &trim(string &s) {
-    return ltrim(rtrim(s));
-}
-
 /**
  * Constructor. Sets the entity flag name. By default, it is $INSTANCE.
  * @param entityRelName The entity relationship name.
@@ -70,6 +40,12 @@ static inline string &trim(string &s) {
  */
 TAProcessor::TAProcessor(string entityRelName, Printer* print) : clangPrinter(print) {
     this->entityString = entityRelName;
+    relationsCompact = true;
+    streamGraph = nullptr;
+    numThreads = 1;
+    recordErrors = false;
+    chunkSuccess = true;
+    errorLine = 0;
 }
 
 /**
@@ -83,22 +59,55 @@ TAProcessor::~TAProcessor(){ }
  * @return Whether it was read successfully.
  */
 bool TAProcessor::readTAFile(string fileName){
-    //Starts by creating the file stream.
-    ifstream modelStream(fileName);
+    //Starts by mapping the file.
+    TAScanner scanner(fileName);
 
     //Check if the file opens.
-    if (!modelStream.is_open()){
+    if (!scanner.isOpen()){
         clangPrinter->printErrorTAProcessRead(fileName);
         return false;
     }
 
+    //Splits the file up when it's large enough.
+    size_t relStart, relEnd, attrStart;
+    if (numThreads > 1 && scanner.getSize() >= PARALLEL_MIN_SIZE &&
+            canReadParallel(scanner, &relStart, &relEnd, &attrStart)){
+        return readSection(scanner.getData(), relStart, relEnd, true) &&
+               readSection(scanner.getData(), attrStart, scanner.getSize(), false);
+    }
+
     //Next starts the main loop.
-    bool success = readGeneric(modelStream, fileName);
+    return readGeneric(scanner, fileName);
+}
+
+/**
+ * Reads a TA file straight into a graph without building the
+ * intermediate tables.
+ * @param fileName The file name to read from.
+ * @param graph The graph to add the entries to.
+ * @return Whether it was read successfully.
+ */
+bool TAProcessor::readTAFile(string fileName, TAGraph* graph){
+    if (graph == nullptr){
+        clangPrinter->printErrorTAProcessGraph();
+        return false;
+    }
+
+    streamGraph = graph;
+    bool success = readTAFile(fileName);
+    streamGraph = nullptr;
 
-    modelStream.close();
     return success;
 }
 
+/**
+ * Sets the number of threads used to read large TA files.
+ * @param threads The number of threads.
+ */
+void TAProcessor::setThreads(int threads){
+    numThreads = (threads < 1) ? 1 : threads;
+}
+
 /**
  * Writes a TA file to a given file name.
  * @param fileName The location to write to.
@@ -160,213 +169,192 @@ TAGraph* TAProcessor::writeTAGraph(){
 
 /**
  * From a file, reads each line. This method decides how to proceed.
- * @param modelStream The stream of the filename.
+ * @param scanner The scanner over the file.
  * @param fileName The filename being read from.
  * @return Whether it was successful.
  */
-bool TAProcessor::readGeneric(ifstream& modelStream, string fileName){
-    bool running = true;
+bool TAProcessor::readGeneric(TAScanner& scanner, string fileName){
     bool tupleEncountered = false;
 
     //Starts by iterating until complete.
-    string curLine;
-    int line = 1;
-    while(running){
-        //We've hit the end.
-        if (!getline(modelStream, curLine)){
-            running = false;
-            continue;
-        }
-
+    boost::string_ref curLine;
+    while(scanner.nextLine(curLine)){
         //We now check the line.
-        if (!curLine.compare(0, SCHEME_FLAG.size(), SCHEME_FLAG)){
+        if (curLine.starts_with(TAScanner::SCHEME_FLAG)){
             //Fast forward.
-            bool success = readScheme(modelStream, &line);
+            bool success = readScheme(scanner);
             if (!success) return false;
 
-        } else if (!curLine.compare(0, RELATION_FLAG.size(), RELATION_FLAG)){
+        } else if (curLine.starts_with(TAScanner::RELATION_FLAG)){
             tupleEncountered = true;
 
             //Reads the relations.
-            bool success = readRelations(modelStream, &line);
+            bool success = readRelations(scanner);
             if (!success) return false;
-        } else if (!curLine.compare(0, ATTRIBUTE_FLAG.size(), ATTRIBUTE_FLAG)){
+        } else if (curLine.starts_with(TAScanner::ATTRIBUTE_FLAG)){
             if (tupleEncountered == false){
-                clangPrinter->printErrorTAProcess(line, ATTRIBUTE_FLAG + " encountered before " + RELATION_FLAG + "!");
+                printLineError(scanner.getLineNumber(),
+                               TAScanner::ATTRIBUTE_FLAG + " encountered before " + TAScanner::RELATION_FLAG + "!");
                 return false;
             }
 
             //Reads the attributes.
-            bool success = readAttributes(modelStream, &line);
+            bool success = readAttributes(scanner);
             if (!success) return false;
         }
-
-        line++;
     }
 
     //Checks whether we've encountered a "fact tuple" section.
-    if (tupleEncountered){
-        return true;
-    }
-
-    return false;
+    return tupleEncountered;
 }
 
 /**
  * Reader that reads the schema section of the file.
- * @param modelStream The model stream.
- * @param lineNum The current line number.
+ * @param scanner The scanner over the file.
  * @return Whether or not it was successful.
  */
-bool TAProcessor::readScheme(ifstream& modelStream, int* lineNum){
-    string line;
+bool TAProcessor::readScheme(TAScanner& scanner){
+    boost::string_ref line;
 
     //Start iterating through
-    auto pos = modelStream.tellg();
-    while(getline(modelStream, line)){
+    size_t pos = scanner.tell();
+    int lineNum = scanner.getLineNumber();
+    while(scanner.nextLine(line)){
         //Check the line.
-        if (!line.compare(0, SCHEME_FLAG.size(), SCHEME_FLAG)){
+        if (line.starts_with(TAScanner::SCHEME_FLAG)){
             //Invalid input.
-            clangPrinter->printErrorTAProcess(*lineNum, UNEXPECTED_FLAG);
+            printLineError(scanner.getLineNumber(), UNEXPECTED_FLAG);
 
             return false;
-        } else if (!line.compare(0, RELATION_FLAG.size(), RELATION_FLAG) ||
-                !line.compare(0, ATTRIBUTE_FLAG.size(), ATTRIBUTE_FLAG)) {
+        } else if (line.starts_with(TAScanner::RELATION_FLAG) || line.starts_with(TAScanner::ATTRIBUTE_FLAG)) {
             //Breaks out of the loop.
             break;
         }
 
         //Get the current line.
-        pos = modelStream.tellg();
-        (*lineNum)++;
+        pos = scanner.tell();
+        lineNum = scanner.getLineNumber();
     }
 
     //Seeks backward.
-    modelStream.seekg(pos);
+    scanner.seek(pos, lineNum);
     return true;
 }
 
 /**
  * Reads the relation section from the TA file.
- * @param modelStream The model stream.
- * @param lineNum The current line number.
+ * @param scanner The scanner over the file.
  * @return Whether or not it was successful.
  */
-bool TAProcessor::readRelations(ifstream& modelStream, int* lineNum){
-    string line;
+bool TAProcessor::readRelations(TAScanner& scanner){
+    boost::string_ref line;
+    vector<boost::string_ref> entry;
     bool blockComment = false;
-    (*lineNum)--;
 
     //Start iterating through
-    auto pos = modelStream.tellg();
-    while(getline(modelStream, line)){
-        if (!line.compare(0, SCHEME_FLAG.size(), SCHEME_FLAG) ||
-            !line.compare(0, ATTRIBUTE_FLAG.size(), ATTRIBUTE_FLAG)) {
+    size_t pos = scanner.tell();
+    int lineNum = scanner.getLineNumber();
+    while(scanner.nextLine(line)){
+        if (line.starts_with(TAScanner::SCHEME_FLAG) || line.starts_with(TAScanner::ATTRIBUTE_FLAG)) {
             //Breaks out of the loop.
             break;
-        } else if (!line.compare(0, RELATION_FLAG.size(), RELATION_FLAG)) {
+        } else if (line.starts_with(TAScanner::RELATION_FLAG)) {
             //Invalid input.
-            clangPrinter->printErrorTAProcess(*lineNum, UNEXPECTED_FLAG);
+            printLineError(scanner.getLineNumber(), UNEXPECTED_FLAG);
 
             return false;
         }
 
-        (*lineNum)++;
+        pos = scanner.tell();
+        lineNum = scanner.getLineNumber();
 
         //Tokenize.
-        vector<string> entry = prepareLine(line, blockComment);
-        if ((blockComment && entry.size() == 0) || entry.size() == 0) continue;
+        TAScanner::tokenize(line, blockComment, entry);
+        if (entry.size() == 0) continue;
 
         //Check whether the entry is valid.
         if (entry.size() != 3) {
-            clangPrinter->printErrorTAProcess(*lineNum, RSF_INVALID);
+            printLineError(lineNum, RSF_INVALID);
             return false;
         }
 
-        //Next, gets the relation name.
-        auto relName = entry.at(0);
-        auto toName = entry.at(1);
-        auto fromName = entry.at(2);
+        //Streams the entry straight into the graph.
+        string relName = entry.at(0).to_string();
+        if (streamGraph != nullptr){
+            addRelationToGraph(streamGraph, relName, entry.at(1).to_string(), entry.at(2).to_string());
+            continue;
+        }
 
         //Finds if a pair exists.
-        int pos = findRelEntry(relName);
-        if (pos == -1) {
+        int relPos = findRelEntry(relName);
+        if (relPos == -1) {
             createRelEntry(relName);
-            pos = (int) relations.size() - 1;
+            relPos = (int) relations.size() - 1;
         }
 
-        //Creates a to from pair.
-        pair<string, string> edge = pair<string, string>();
-        edge.first = toName;
-        edge.second = fromName;
-
-        //Inserts it.
-        relations.at(pos).second.insert(edge);
-
+        //Inserts the to from pair.
+        addRelation(relPos, entry.at(1).to_string(), entry.at(2).to_string());
     }
 
     //Seeks backward.
-    modelStream.seekg(pos);
+    scanner.seek(pos, lineNum);
 
     return true;
 }
 
 /**
  * Reads the attributes from the TA file.
- * @param modelStream The model stream.
- * @param lineNum The current line number.
+ * @param scanner The scanner over the file.
  * @return Whether or not it was successful.
  */
-bool TAProcessor::readAttributes(ifstream& modelStream, int* lineNum){
-    string line;
+bool TAProcessor::readAttributes(TAScanner& scanner){
+    boost::string_ref line;
+    vector<boost::string_ref> entry;
     bool blockComment = false;
-    (*lineNum)--;
 
     //Start iterating through
-    auto pos = modelStream.tellg();
-    while(getline(modelStream, line)) {
-        (*lineNum)++;
+    while(scanner.nextLine(line)) {
+        int lineNum = scanner.getLineNumber();
 
         //Prepare the line.
-        vector<string> entry = prepareLine(line, blockComment);
-        if ((blockComment && entry.size() == 0) || entry.size() == 0) continue;
+        TAScanner::tokenize(line, blockComment, entry);
+        if (entry.size() == 0) continue;
 
         //Checks for what type of system we're dealing with.
         bool succ = true;
-        if (entry.at(0).compare("(") == 0 || entry.at(0).find("(") == 0) {
+        size_t i = 0;
+        if (entry.at(0).starts_with('(')) {
             //Relation attribute.
-            if (entry.at(0).compare("(") == 0){
-                entry.erase(entry.begin());
+            if (entry.at(0).size() == 1){
+                i++;
             } else {
-                entry.at(0).erase(0, 1);
+                entry.at(0).remove_prefix(1);
             }
 
             //Check for valid entry.
-            if (entry.size() < 3 || entry.at(1).compare(")") == 0 || entry.at(2).compare(")") == 0){
-                clangPrinter->printErrorTAProcess(*lineNum, ATTRIBUTE_SHORT);
+            if (entry.size() - i < 3 || entry.at(i + 1) == ")" || entry.at(i + 2) == ")"){
+                printLineError(lineNum, ATTRIBUTE_SHORT);
                 return false;
             }
 
-            //Gets the relation name.
-            string relName = entry.at(0);
-            entry.erase(entry.begin());
-
-            //Gets the IDs.
-            string srcID = entry.at(0);
-            entry.erase(entry.begin());
-            string dstID = entry.at(0);
-            if (dstID.back() == ')'){
-                dstID.erase(dstID.size() - 1, 1);
-                entry.erase(entry.begin());
+            //Gets the relation name and the IDs.
+            string relName = entry.at(i++).to_string();
+            string srcID = entry.at(i++).to_string();
+            boost::string_ref dstRef = entry.at(i++);
+            if (dstRef.ends_with(')')){
+                dstRef.remove_suffix(1);
             } else {
-                entry.erase(entry.begin());
-                entry.erase(entry.begin());
+                i++;
             }
-
+            string dstID = dstRef.to_string();
 
             //Generates the attribute list.
-            auto attrs = generateAttributes(*lineNum, succ, entry);
+            auto attrs = generateAttributes(lineNum, succ, entry, i);
             if (!succ) return false;
+            if (streamGraph != nullptr){
+                if (!addAttributesToGraph(streamGraph, relName, srcID, dstID, attrs)) return false;
+                continue;
+            }
 
             //Next, we insert
             int pos = findAttrEntry(relName, srcID, dstID);
@@ -377,13 +365,15 @@ bool TAProcessor::readAttributes(ifstream& modelStream, int* lineNum){
             this->relAttributes.at(pos).second = attrs;
         } else {
             //Regular attribute.
-            //Gets the name and trims down the vector.
-            string attrName = entry.at(0);
-            entry.erase(entry.begin());
+            string attrName = entry.at(0).to_string();
 
             //Generates the attribute list.
-            auto attrs = generateAttributes(*lineNum, succ, entry);
+            auto attrs = generateAttributes(lineNum, succ, entry, 1);
             if (!succ) return false;
+            if (streamGraph != nullptr){
+                if (!addAttributesToGraph(streamGraph, attrName, attrs)) return false;
+                continue;
+            }
 
             //Next, we insert
             int pos = findAttrEntry(attrName);
@@ -398,6 +388,199 @@ bool TAProcessor::readAttributes(ifstream& modelStream, int* lineNum){
     return true;
 }
 
+/**
+ * Checks whether the file has a layout that can be split up. Block
+ * comments could span chunks, so any file with one is read in order.
+ * @param scanner The scanner over the file.
+ * @param relStart The start of the relation section.
+ * @param relEnd The end of the relation section.
+ * @param attrStart The start of the attribute section.
+ * @return Whether the file can be read in parallel.
+ */
+bool TAProcessor::canReadParallel(TAScanner& scanner, size_t* relStart, size_t* relEnd, size_t* attrStart){
+    const char* data = scanner.getData();
+    size_t size = scanner.getSize();
+    if (memmem(data, size, "/*", 2) != nullptr) return false;
+
+    //Finds the sections.
+    vector<size_t> schemes = findFlagLines(data, size, TAScanner::SCHEME_FLAG);
+    vector<size_t> rels = findFlagLines(data, size, TAScanner::RELATION_FLAG);
+    vector<size_t> attrs = findFlagLines(data, size, TAScanner::ATTRIBUTE_FLAG);
+    if (rels.size() != 1 || attrs.size() > 1) return false;
+    if (schemes.size() > 0 && schemes.back() > rels.at(0)) return false;
+    if (attrs.size() == 1 && attrs.at(0) < rels.at(0)) return false;
+
+    //Gets the bounds of each section.
+    const char* relLine = (const char*) memchr(data + rels.at(0), '\n', size - rels.at(0));
+    *relStart = (relLine == nullptr) ? size : (size_t) (relLine - data) + 1;
+    *relEnd = (attrs.size() == 1) ? attrs.at(0) : size;
+    *attrStart = size;
+    if (attrs.size() == 1){
+        const char* attrLine = (const char*) memchr(data + attrs.at(0), '\n', size - attrs.at(0));
+        *attrStart = (attrLine == nullptr) ? size : (size_t) (attrLine - data) + 1;
+    }
+
+    return true;
+}
+
+/**
+ * Finds every line that starts with a section flag.
+ * @param data The buffer to search.
+ * @param size The size of the buffer.
+ * @param flag The flag to find.
+ * @return The offsets of the lines.
+ */
+vector<size_t> TAProcessor::findFlagLines(const char* data, size_t size, const string& flag){
+    vector<size_t> lines;
+
+    size_t pos = 0;
+    while (pos < size){
+        const char* found = (const char*) memmem(data + pos, size - pos, flag.c_str(), flag.size());
+        if (found == nullptr) break;
+
+        size_t offset = (size_t) (found - data);
+        if (offset == 0 || data[offset - 1] == '\n') lines.push_back(offset);
+        pos = offset + 1;
+    }
+
+    return lines;
+}
+
+/**
+ * Splits a section into chunks at line boundaries, reads each chunk on
+ * its own thread and merges the results in file order. When streaming,
+ * the chunks are added to the graph in file order instead.
+ * @param data The file buffer.
+ * @param start The start of the section.
+ * @param end The end of the section.
+ * @param relationSection Whether this is the relation section.
+ * @return Whether or not it was successful.
+ */
+bool TAProcessor::readSection(const char* data, size_t start, size_t end, bool relationSection){
+    if (start >= end) return true;
+
+    //Gets the chunk boundaries.
+    vector<size_t> bounds;
+    bounds.push_back(start);
+    for (int i = 1; i < numThreads; i++){
+        size_t pos = start + (end - start) / numThreads * i;
+        if (pos < bounds.back()) pos = bounds.back();
+
+        const char* line = (const char*) memchr(data + pos, '\n', end - pos);
+        bounds.push_back((line == nullptr) ? end : (size_t) (line - data) + 1);
+    }
+    bounds.push_back(end);
+
+    //Reads each chunk.
+    vector<TAProcessor*> workers;
+    vector<thread> threads;
+    for (int i = 0; i + 1 < bounds.size(); i++){
+        TAProcessor* worker = new TAProcessor(entityString, clangPrinter);
+        worker->recordErrors = true;
+        workers.push_back(worker);
+        threads.push_back(thread(&TAProcessor::readChunk, worker, data + bounds.at(i),
+                                 bounds.at(i + 1) - bounds.at(i), relationSection));
+    }
+    for (auto& cur : threads) cur.join();
+
+    //Checks the chunks in order.
+    bool succ = true;
+    for (int i = 0; i < workers.size() && succ; i++){
+        TAProcessor* worker = workers.at(i);
+        if (!worker->chunkSuccess){
+            succ = false;
+
+            //Prints the error with the line in the file.
+            if (worker->errorLine > 0){
+                int lineNum = (int) count(data, data + bounds.at(i), '\n') + worker->errorLine;
+                clangPrinter->printErrorTAProcess(lineNum, worker->errorMessage);
+            }
+        }
+    }
+
+    //Merges or streams the chunks in order.
+    if (succ && streamGraph == nullptr){
+        for (TAProcessor* worker : workers) mergeTables(*worker);
+    } else if (succ && relationSection){
+        //Entities go in first so every edge can find its nodes.
+        for (TAProcessor* worker : workers) worker->streamRelations(streamGraph, true);
+        for (TAProcessor* worker : workers) worker->streamRelations(streamGraph, false);
+    } else if (succ){
+        for (int i = 0; i < workers.size() && succ; i++) succ = workers.at(i)->writeAttributes(streamGraph);
+    }
+
+    for (TAProcessor* worker : workers) delete worker;
+    return succ;
+}
+
+/**
+ * Reads a chunk of a section into this processor's tables.
+ * @param data The start of the chunk.
+ * @param size The size of the chunk.
+ * @param relationSection Whether this is the relation section.
+ */
+void TAProcessor::readChunk(const char* data, size_t size, bool relationSection){
+    TAScanner scanner(data, size);
+    chunkSuccess = (relationSection) ? readRelations(scanner) : readAttributes(scanner);
+}
+
+/**
+ * Merges the tables of another processor into this one. Later
+ * attribute entries replace earlier ones like they do when reading
+ * in order.
+ * @param other The processor to merge in.
+ */
+void TAProcessor::mergeTables(TAProcessor& other){
+    for (auto& rel : other.relations){
+        int pos = findRelEntry(rel.first);
+        if (pos == -1) {
+            createRelEntry(rel.first);
+            pos = (int) relations.size() - 1;
+        }
+
+        auto& entries = relations.at(pos).second;
+        if (entries.size() == 0) {
+            entries.swap(rel.second);
+        } else {
+            entries.insert(entries.end(), make_move_iterator(rel.second.begin()), make_move_iterator(rel.second.end()));
+        }
+        relationsCompact = false;
+    }
+
+    for (auto& attr : other.attributes){
+        int pos = findAttrEntry(attr.first);
+        if (pos == -1) {
+            createAttrEntry(attr.first);
+            pos = (int) attributes.size() - 1;
+        }
+        attributes.at(pos).second = move(attr.second);
+    }
+
+    for (auto& attr : other.relAttributes){
+        int pos = findAttrEntry(attr.first.at(0), attr.first.at(1), attr.first.at(2));
+        if (pos == -1) {
+            createAttrEntry(attr.first.at(0), attr.first.at(1), attr.first.at(2));
+            pos = (int) relAttributes.size() - 1;
+        }
+        relAttributes.at(pos).second = move(attr.second);
+    }
+}
+
+/**
+ * Prints an error for a line in the file. Chunk readers keep the first
+ * error so it can be printed with the right line number.
+ * @param lineNum The line number.
+ * @param message The error message.
+ */
+void TAProcessor::printLineError(int lineNum, string message){
+    if (!recordErrors){
+        clangPrinter->printErrorTAProcess(lineNum, message);
+    } else if (errorLine == 0){
+        errorLine = lineNum;
+        errorMessage = message;
+    }
+}
+
 /**
  * Writes relations to a TA graph.
  * @param graph The graph to write to.
@@ -412,53 +595,38 @@ bool TAProcessor::writeRelations(TAGraph* graph){
     }
 
     //Gets the entity relation.
-    auto entity = relations.at(pos).second;
-    for (auto entry : entity){
-        //Gets the name.
-        string ID = entry.first;
-
-        //Gets the ClangNode enum.
-        ClangNode::NodeType type = ClangNode::getTypeNode(entry.second);
-
-        //Creates a new node.
-        ClangNode* node = new ClangNode(ID, ID, type);
-        graph->addNode(node);
+    compactRelations();
+    for (const auto& entry : relations.at(pos).second){
+        addRelationToGraph(graph, entityString, entry.first, entry.second);
     }
 
     //Next, processes the other relationships.
-    int i = 0;
-    for (auto rels : relations){
+    for (int i = 0; i < relations.size(); i++){
         if (i == pos) continue;
 
-        string relName = rels.first;
-        ClangEdge::EdgeType type = ClangEdge::getTypeEdge(relName);
-
-        std::set<pair<string, string>>::iterator it;
-        for (it = rels.second.begin(); it != rels.second.end(); it++) {
-            auto nodes = *it;
-
-            //Gets the nodes.
-            ClangNode* src = graph->findNodeByID(nodes.first);
-            ClangNode* dst = graph->findNodeByID(nodes.second);
-
-            ClangEdge* edge;
-            if (src && dst) {
-                edge = new ClangEdge(src, dst, type);
-            } else if (!src && dst) {
-                edge = new ClangEdge(nodes.first, dst, type);
-            } else if (src && !dst) {
-                edge = new ClangEdge(src, nodes.second, type);
-            } else {
-                edge = new ClangEdge(nodes.first, nodes.second, type);
-            }
-
-            graph->addEdge(edge);
+        const auto& rels = relations.at(i);
+        for (const auto& nodes : rels.second) {
+            addRelationToGraph(graph, rels.first, nodes.first, nodes.second);
         }
     }
 
     return true;
 }
 
+/**
+ * Adds the relations read by a chunk to a TA graph without requiring
+ * the entity relation to be present.
+ * @param graph The graph to write to.
+ * @param entities Whether the entity relation or the others are added.
+ */
+void TAProcessor::streamRelations(TAGraph* graph, bool entities){
+    for (const auto& rel : relations){
+        if ((rel.first.compare(entityString) == 0) != entities) continue;
+
+        for (const auto& entry : rel.second) addRelationToGraph(graph, rel.first, entry.first, entry.second);
+    }
+}
+
 /**
  * Writes attributes to a TA graph.
  * @param graph The graph to write to.
@@ -466,49 +634,99 @@ bool TAProcessor::writeRelations(TAGraph* graph){
  */
 bool TAProcessor::writeAttributes(TAGraph* graph){
     //We simply go through and process them.
-    for (auto attr : attributes){
-        string itemID = attr.first;
-
-        //Next, we go through all the KVs.
-        for (auto kv : attr.second){
-            string key = kv.first;
-            vector<string> values = kv.second;
-
-            //Now, updates the attributes.
-            for (auto value : values) {
-                bool succ = graph->addAttribute(itemID, key, value);
-                if (!succ) {
-                    clangPrinter->printErrorTAProcess(Printer::ENTITY_ATTRIBUTE, itemID);
-                    return false;
-                }
-            }
-        }
+    for (const auto& attr : attributes){
+        if (!addAttributesToGraph(graph, attr.first, attr.second)) return false;
     }
 
     //Next, we deal with relation attributes.
-    for (auto attr : relAttributes){
-        vector<string> items = attr.first;
+    for (const auto& attr : relAttributes){
+        const vector<string>& items = attr.first;
         if (items.size() != 3) {
             clangPrinter->printErrorTAProcessMalformed();
             return false;
         }
 
-        ClangEdge::EdgeType relName = ClangEdge::getTypeEdge(items.at(0));
-        string srcID = items.at(1);
-        string dstID = items.at(2);
-
-        //Next, we go through all the KVs.
-        for (auto kv : attr.second){
-            string key = kv.first;
-            vector<string> values = kv.second;
-
-            //Now, updates the attributes.
-            for (auto value : values) {
-                bool succ = graph->addAttribute(srcID, dstID, relName, key, value);
-                if (!succ) {
-                    clangPrinter->printErrorTAProcess(Printer::RELATION_ATTRIBUTE, "(" + srcID + ", " + dstID + ")");
-                    return false;
-                }
+        if (!addAttributesToGraph(graph, items.at(0), items.at(1), items.at(2), attr.second)) return false;
+    }
+
+    return true;
+}
+
+/**
+ * Adds a single relation entry to a TA graph. Entries of the entity
+ * relation become nodes and all others become edges.
+ * @param graph The graph to write to.
+ * @param relName The name of the relation.
+ * @param src The source of the entry.
+ * @param dst The destination of the entry.
+ */
+void TAProcessor::addRelationToGraph(TAGraph* graph, const string& relName, const string& src, const string& dst){
+    //Creates a new node.
+    if (relName.compare(entityString) == 0){
+        ClangNode* node = new ClangNode(src, src, ClangNode::getTypeNode(dst));
+        graph->addNode(node);
+        return;
+    }
+
+    //Gets the nodes.
+    ClangEdge::EdgeType type = ClangEdge::getTypeEdge(relName);
+    ClangNode* srcNode = graph->findNodeByID(src);
+    ClangNode* dstNode = graph->findNodeByID(dst);
+
+    ClangEdge* edge;
+    if (srcNode && dstNode) {
+        edge = new ClangEdge(srcNode, dstNode, type);
+    } else if (!srcNode && dstNode) {
+        edge = new ClangEdge(src, dstNode, type);
+    } else if (srcNode && !dstNode) {
+        edge = new ClangEdge(srcNode, dst, type);
+    } else {
+        edge = new ClangEdge(src, dst, type);
+    }
+
+    graph->addEdge(edge);
+}
+
+/**
+ * Adds the attributes of an entity to a TA graph.
+ * @param graph The graph to write to.
+ * @param itemID The ID of the entity.
+ * @param attrs The KV pairs to add.
+ * @return Whether or not it was successful.
+ */
+bool TAProcessor::addAttributesToGraph(TAGraph* graph, const string& itemID,
+                                       const vector<pair<string, vector<string>>>& attrs){
+    for (const auto& kv : attrs){
+        for (const auto& value : kv.second) {
+            bool succ = graph->addAttribute(itemID, kv.first, TAScanner::unquote(value));
+            if (!succ) {
+                clangPrinter->printErrorTAProcess(Printer::ENTITY_ATTRIBUTE, itemID);
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Adds the attributes of a relation to a TA graph.
+ * @param graph The graph to write to.
+ * @param relName The name of the relation.
+ * @param srcID The source ID.
+ * @param dstID The destination ID.
+ * @param attrs The KV pairs to add.
+ * @return Whether or not it was successful.
+ */
+bool TAProcessor::addAttributesToGraph(TAGraph* graph, const string& relName, const string& srcID,
+                                       const string& dstID, const vector<pair<string, vector<string>>>& attrs){
+    ClangEdge::EdgeType type = ClangEdge::getTypeEdge(relName);
+    for (const auto& kv : attrs){
+        for (const auto& value : kv.second) {
+            bool succ = graph->addAttribute(srcID, dstID, type, kv.first, TAScanner::unquote(value));
+            if (!succ) {
+                clangPrinter->printErrorTAProcess(Printer::RELATION_ATTRIBUTE, "(" + srcID + ", " + dstID + ")");
+                return false;
             }
         }
     }
@@ -544,14 +762,15 @@ string TAProcessor::generateTAString(){
  */
 string TAProcessor::generateRelationString(){
     string relString = "";
-    relString += RELATION_FLAG + "\n";
+    relString += TAScanner::RELATION_FLAG + "\n";
 
     //Iterate through the relations.
-    for (auto curr : relations){
-        string relName = curr.first;
+    compactRelations();
+    for (const auto& curr : relations){
+        const string& relName = curr.first;
 
         //Iterate through the entries.
-        for (auto currRel : curr.second){
+        for (const auto& currRel : curr.second){
             relString += relName + " " + currRel.first + " " + currRel.second + "\n";
         }
     }
@@ -566,18 +785,18 @@ string TAProcessor::generateRelationString(){
  */
 string TAProcessor::generateAttributeString(){
     string attrString = "";
-    attrString += ATTRIBUTE_FLAG + "\n";
+    attrString += TAScanner::ATTRIBUTE_FLAG + "\n";
 
     //Iterate through the entity attributes first.
-    for (auto curr : attributes){
-        string attributeID = curr.first;
+    for (const auto& curr : attributes){
+        const string& attributeID = curr.first;
         attrString += attributeID + generateAttributeStringFromKVs(curr.second) + "\n";
     }
 
     //Next, deals with the relation attribute list.
-    for (auto curr : relAttributes){
-        vector<string> items = curr.first;
-        auto kVs = curr.second;
+    for (const auto& curr : relAttributes){
+        const vector<string>& items = curr.first;
+        const auto& kVs = curr.second;
 
         if (items.size() != 3) return "";
 
@@ -593,17 +812,17 @@ string TAProcessor::generateAttributeString(){
  * @param attr The attribute KV pair map.
  * @return The attribute string.
  */
-string TAProcessor::generateAttributeStringFromKVs(vector<pair<string, vector<string>>> attr){
+string TAProcessor::generateAttributeStringFromKVs(const vector<pair<string, vector<string>>>& attr){
     string attrString = " { ";
 
     //Iterate through the pairs.
-    for (auto currAttr : attr){
+    for (const auto& currAttr : attr){
         //Check what type of string we need to generate.
         if (currAttr.second.size() == 1){
             attrString += currAttr.first + " = " + currAttr.second.at(0) + " ";
         } else {
             attrString += currAttr.first + " = (";
-            for (auto value : currAttr.second)
+            for (const auto& value : currAttr.second)
                 attrString += " " + value;
 
             attrString += " ) ";
@@ -618,69 +837,76 @@ string TAProcessor::generateAttributeStringFromKVs(vector<pair<string, vector<st
  * Generates attributes from a given line.
  * @param lineNum The line number.
  * @param succ Whether or not it was successful.
- * @param line The line to process.
+ * @param tokens The tokens of the line to process.
+ * @param start The first token of the attribute list.
  * @return A vector of all KV pairs for the attribute.
  */
 vector<pair<string, vector<string>>> TAProcessor::generateAttributes(int lineNum, bool& succ,
-                                                                     std::vector<std::string> line){
-    if (line.size() < 3){
+                                                                     const vector<boost::string_ref>& tokens,
+                                                                     size_t start){
+    if (start > tokens.size() || tokens.size() - start < 3){
         succ = false;
         return vector<pair<string, vector<string>>>();
     }
+    vector<boost::string_ref> line(tokens.begin() + start, tokens.end());
 
     //Start by expecting the { symbol.
-    if (line.at(0).compare("{") == 0){
+    if (line.at(0) == "{"){
         line.erase(line.begin());
-    } else if (line.at(0).find("{") == 0){
-        line.at(0).erase(0, 1);
+    } else if (line.at(0).starts_with('{')){
+        line.at(0).remove_prefix(1);
     } else {
         succ = false;
         return vector<pair<string, vector<string>>>();
     }
+    if (line.size() == 0){
+        succ = false;
+        return vector<pair<string, vector<string>>>();
+    }
 
     //Now, we iterate until we hit the end.
     int i = 0;
     bool end = false;
-    string current = line.at(i);
+    boost::string_ref current = line.at(i);
     vector<pair<string, vector<string>>> attrList = vector<pair<string, vector<string>>>();
     do {
         //Adds in the first part of the entry.
         pair<string, vector<string>> currentEntry = pair<string, vector<string>>();
-        currentEntry.first = current;
+        currentEntry.first = current.to_string();
 
         //Checks for validity.
-        if (i + 2 >= line.size() || line.at(++i).compare("=") != 0){
+        if (i + 2 >= line.size() || line.at(++i) != "="){
             succ = false;
             return vector<pair<string, vector<string>>>();
         }
 
         //Gets the next KV pair.
-        string next = line.at(++i);
-        if (next.compare("(") == 0 || next.find("(") == 0) {
+        boost::string_ref next = line.at(++i);
+        if (next.starts_with('(')) {
             //First, remove the ( symbol.
-            if (next.compare("(") == 0){
+            if (next == "("){
                 if (i + 1 == line.size()){
                     succ = false;
                     return vector<pair<string, vector<string>>>();
                 }
                 next = line.at(++i);
-            } else if (next.find("(") == 0){
-                next.erase(0, 1);
+            } else {
+                next.remove_prefix(1);
             }
 
             //We now iterate through the attribute list.
             bool endList = false;
             do {
                 //Check if we hit the end.
-                if (next.compare(")") == 0) {
+                if (next == ")") {
                     break;
-                } else if (next.find(")") == next.size() - 1) {
-                    next.erase(next.size() - 1, 1);
+                } else if (next.ends_with(')')) {
+                    next.remove_suffix(1);
                     endList = true;
                 }
 
                 //Next, process the item.
-                currentEntry.second.push_back(next);
+                currentEntry.second.push_back(next.to_string());
 
                 //Finally check if we've hit the conditions.
                 if (endList){
@@ -694,13 +920,13 @@ vector<pair<string, vector<string>>> TAProcessor::generateAttributes(int lineNum
             } while (true);
         } else {
             //Check if we have a "} symbol at the end.
-            if (next.find("}") == next.size() - 1){
+            if (next.ends_with('}')){
                 end = true;
-                next.erase(next.size() - 1, 1);
+                next.remove_suffix(1);
             }
 
             //Add it to the current entry.
-            currentEntry.second.push_back(next);
+            currentEntry.second.push_back(next.to_string());
         }
 
         //Increments the current string.
@@ -713,130 +939,60 @@ vector<pair<string, vector<string>>> TAProcessor::generateAttributes(int lineNum
 
         //Adds the entry in.
         attrList.push_back(currentEntry);
-    } while (current.compare("}") != 0 && end == false);
+    } while (current != "}" && end == false);
 
     return attrList;
 }
 
 /**
- * Prepares a line for being processed.
- * @param line The line to process.
- * @param blockComment Whether or not a block comment was encountered.
- * @return The tokenized string.
+ * Finds a relationship entry.
+ * @param name The name of the relationship.
+ * @return The index of the relationship.
  */
-vector<string> TAProcessor::prepareLine(string line, bool& blockComment){
-    //Perform comment processing.
-    line = removeStandardComment(line);
-    line = removeBlockComment(line, blockComment);
-
-    //Split into a vector.
-    vector<string> stringList;
-    boost::split(stringList, line, boost::is_any_of(" "));
-
-    //Trim the strings.
-    vector<string> modified;
-    for (string curr : stringList){
-        trim(curr);
-        modified.push_back(curr);
-    }
-
-    //Sanity check for the modified system.
-    if (modified.size() == 1 && modified.at(0).compare("") == 0){
-        modified.erase(modified.begin());
-    }
+int TAProcessor::findRelEntry(const string& name){
+    auto it = relIndex.find(name);
+    if (it == relIndex.end()) return -1;
 
-    return modified;
+    return it->second;
 }
 
 /**
- * Removes a standard comment from a line.
- * @param line The line to process.
- * @return The string with the comment removed.
+ * Creates a relationship entry in the system.
+ * @param name The name of the relationship.
  */
-string TAProcessor::removeStandardComment(string line){
-    //Iterate through the string two characters at a time.
-    for (int i = 0; i + 1 < line.size(); i++){
-        //Get the next two characters.
-        char first = line.at(i);
-        char second = line.at(i + 1);
-
-        //Erase the characters.
-        if (first == COMMENT_CHAR && second == COMMENT_CHAR){
-            //We want to purge the line of all subsequent characters.
-            line.erase(i, string::npos);
-            break;
-        }
-    }
+void TAProcessor::createRelEntry(const string& name){
+    pair<string, vector<pair<string, string>>> entry = pair<string, vector<pair<string, string>>>();
+    entry.first = name;
 
-    return line;
+    relIndex[name] = (int) relations.size();
+    relations.push_back(entry);
 }
 
 /**
- * Removes a block comment.
- * @param line The line to process.
- * @param blockComment Whether a block comment was encountered.
- * @return The line without the block comment.
+ * Adds a pair to a relationship entry. Duplicates are removed when
+ * the relations are compacted.
+ * @param pos The index of the relationship.
+ * @param src The source name.
+ * @param dst The destination name.
  */
-string TAProcessor::removeBlockComment(string line, bool& blockComment){
-    string newLine = "";
-
-    //Iterate through the string two characters at a time.
-    for (int i = 0; i + 1 < line.size(); i++){
-        //Get the next two characters.
-        char first = line.at(i);
-        char second = line.at(i + 1);
-
-        //Check if we have a block comment ending to look for.
-        if (blockComment == true && (first == COMMENT_BLOCK_CHAR && second == COMMENT_CHAR)){
-            //Set block comment to false.
-            blockComment = false;
-
-            //Now, we move the pointer ahead by 1.
-            i++;
-        } else if (blockComment == false && (first == COMMENT_CHAR && second == COMMENT_BLOCK_CHAR)){
-            //Set block comment to true.
-            blockComment = true;
-
-            //Now, we move the pointer ahead by 1.
-            i++;
-        } else if (blockComment == false) {
-            //Adds the character.
-            newLine += first;
-            if (i + 2 == line.size())
-                newLine += second;
-        }
-    }
-
-    return newLine;
+void TAProcessor::addRelation(int pos, string src, string dst){
+    relations.at(pos).second.push_back(pair<string, string>(move(src), move(dst)));
+    relationsCompact = false;
 }
 
 /**
- * Finds a relationship entry.
- * @param name The name of the relationship.
- * @return The index of the relationship.
+ * Sorts each relationship entry and removes duplicate pairs.
  */
-int TAProcessor::findRelEntry(string name){
-    int i = 0;
-
-    //Goes through the relation vector.
-    for (auto rel : relations){
-        if (rel.first.compare(name) == 0) return i;
+void TAProcessor::compactRelations(){
+    if (relationsCompact) return;
 
-        i++;
+    for (auto& rel : relations){
+        sort(rel.second.begin(), rel.second.end());
+        rel.second.erase(unique(rel.second.begin(), rel.second.end()), rel.second.end());
+        rel.second.shrink_to_fit();
     }
 
-    return -1;
-}
-
-/**
- * Creates a relationship entry in the system.
- * @param name The name of the relationship.
- */
-void TAProcessor::createRelEntry(string name){
-    pair<string, set<pair<string, string>>> entry = pair<string, set<pair<string, string>>>();
-    entry.first = name;
-
-    relations.push_back(entry);
+    relationsCompact = true;
 }
 
 /**
@@ -844,17 +1000,11 @@ void TAProcessor::createRelEntry(string name){
  * @param attrName The name of the attribute.
  * @return The index of the attribute.
  */
-int TAProcessor::findAttrEntry(string attrName){
-    int i = 0;
-
-    //Goes through the attribute vector.
-    for (auto attr : attributes){
-        if (attr.first.compare(attrName) == 0) return i;
+int TAProcessor::findAttrEntry(const string& attrName){
+    auto it = attrIndex.find(attrName);
+    if (it == attrIndex.end()) return -1;
 
-        i++;
-    }
-
-    return -1;
+    return it->second;
 }
 
 /**
@@ -864,33 +1014,23 @@ int TAProcessor::findAttrEntry(string attrName){
  * @param dst The destination name.
  * @return The index of the attribute
  */
-int TAProcessor::findAttrEntry(string relName, string src, string dst){
-    int i = 0;
-
-    //Goes through the attribute vector
-    for (auto attr : relAttributes){
-        //Abort!
-        if (attr.first.size() != 3) return -1;
-
-        if (attr.first.at(0).compare(relName) == 0 &&
-                attr.first.at(1).compare(src) == 0 &&
-                attr.first.at(2).compare(dst) ==0) return i;
+int TAProcessor::findAttrEntry(const string& relName, const string& src, const string& dst){
+    auto it = relAttrIndex.find(generateRelKey(relName, src, dst));
+    if (it == relAttrIndex.end()) return -1;
 
-        i++;
-    }
-
-    return -1;
+    return it->second;
 }
 
 /**
  * Creates an attribute entry.
  * @param attrName The name of the attribute.
  */
-void TAProcessor::createAttrEntry(string attrName){
+void TAProcessor::createAttrEntry(const string& attrName){
     //Create the pair object.
     pair<string, vector<pair<string, vector<string>>>> entry = pair<string, vector<pair<string, vector<string>>>>();
     entry.first = attrName;
 
+    attrIndex[attrName] = (int) attributes.size();
     attributes.push_back(entry);
 }
 
@@ -900,7 +1040,7 @@ void TAProcessor::createAttrEntry(string attrName){
  * @param src The source name.
  * @param dst The destination name.
  */
-void TAProcessor::createAttrEntry(string relName, string src, string dst){
+void TAProcessor::createAttrEntry(const string& relName, const string& src, const string& dst){
     //Create the pair object.
     pair<vector<string>, vector<pair<string, vector<string>>>> entry =
         pair<vector<string>, vector<pair<string, vector<string>>>>();
@@ -908,9 +1048,29 @@ void TAProcessor::createAttrEntry(string relName, string src, string dst){
     entry.first.push_back(src);
     entry.first.push_back(dst);
 
+    relAttrIndex[generateRelKey(relName, src, dst)] = (int) relAttributes.size();
     relAttributes.push_back(entry);
 }
 
+/**
+ * Generates the index key for a relation attribute.
+ * @param relName The relationship name.
+ * @param src The source name.
+ * @param dst The destination name.
+ * @return The key for the relation attribute index.
+ */
+string TAProcessor::generateRelKey(const string& relName, const string& src, const string& dst){
+    string key;
+    key.reserve(relName.size() + src.size() + dst.size() + 2);
+    key += relName;
+    key += '\0';
+    key += src;
+    key += '\0';
+    key += dst;
+
+    return key;
+}
+
 /**
  * Processes a collection of ClangNodes and adds them.
  * @param nodes The collection of ClangNodes.
@@ -929,7 +1089,7 @@ void TAProcessor::processNodes(vector<ClangNode*> nodes){
         pair<string, string> relPair = pair<string, string>();
         relPair.first = curNode->getID();
         relPair.second = ClangNode::getTypeString(curNode->getType());
-        relations.at(pos).second.insert(relPair);
+        addRelation(pos, relPair.first, relPair.second);
 
         //Adds in the attributes.
         auto curAttr = curNode->getAttributes();
@@ -986,7 +1146,7 @@ void TAProcessor::processEdges(vector<ClangEdge*> edges){
         relPair.second = dstID;
 
         //Add it to the relation list.
-        relations.at(pos).second.insert(relPair);
+        addRelation(pos, relPair.first, relPair.second);
 
 
         //Now we deal with any edge attributes;
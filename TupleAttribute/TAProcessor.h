@@ -29,7 +29,9 @@
 #define CLANGEX_TAPROCESSOR_H
 
 #include <string>
-#include <set>
+#include <unordered_map>
+#include <boost/utility/string_ref.hpp>
+#include "TAScanner.h"
 #include "../Graph/TAGraph.h"
 
 class TAProcessor {
@@ -40,61 +42,91 @@ public:
 
     /** TA File I/O */
     bool readTAFile(std::string fileName);
+    bool readTAFile(std::string fileName, TAGraph* graph);
     bool writeTAFile(std::string fileName);
 
+    /** Settings */
+    void setThreads(int threads);
+
     /** TA Graph I/O */
     bool readTAGraph(TAGraph* graph);
     TAGraph* writeTAGraph();
 
 private:
     /** Private Flags and Strings */
-    const char COMMENT_CHAR = '/';
-    const char COMMENT_BLOCK_CHAR = '*';
     const std::string UNEXPECTED_FLAG = "Unexpected flag.";
     const std::string RSF_INVALID = "Line should contain a single tuple in RSF format.";
     const std::string ATTRIBUTE_SHORT = "Attribute line is too short to be valid!";
-    const std::string RELATION_FLAG = "FACT TUPLE :";
-    const std::string ATTRIBUTE_FLAG = "FACT ATTRIBUTE :";
-    const std::string SCHEME_FLAG = "SCHEME TUPLE :";
     const std::string SCHEMA_HEADER = "//TAProcessor TA File Created by ClangEx";
+    const size_t PARALLEL_MIN_SIZE = 1 << 20;
 
     /** Private Variables */
     std::string entityString;
     Printer *clangPrinter;
-    std::vector<std::pair<std::string, std::set<std::pair<std::string, std::string>>>> relations;
+    std::vector<std::pair<std::string, std::vector<std::pair<std::string, std::string>>>> relations;
     std::vector<std::pair<std::string, std::vector<std::pair<std::string, std::vector<std::string>>>>> attributes;
     std::vector<std::pair<std::vector<std::string>,
             std::vector<std::pair<std::string, std::vector<std::string>>>>> relAttributes;
+    bool relationsCompact;
+    TAGraph* streamGraph;
+
+    /** Parallel Read Variables */
+    int numThreads;
+    bool recordErrors;
+    bool chunkSuccess;
+    int errorLine;
+    std::string errorMessage;
+
+    /** Entry Indices */
+    std::unordered_map<std::string, int> relIndex;
+    std::unordered_map<std::string, int> attrIndex;
+    std::unordered_map<std::string, int> relAttrIndex;
 
     /** TA Readers */
-    bool readGeneric(std::ifstream& modelStream, std::string fileName);
-    bool readScheme(std::ifstream& modelStream, int* lineNum);
-    bool readRelations(std::ifstream& modelStream, int* lineNum);
-    bool readAttributes(std::ifstream& modelStream, int* lineNum);
+    bool readGeneric(TAScanner& scanner, std::string fileName);
+    bool readScheme(TAScanner& scanner);
+    bool readRelations(TAScanner& scanner);
+    bool readAttributes(TAScanner& scanner);
+
+    /** Parallel Readers */
+    bool canReadParallel(TAScanner& scanner, size_t* relStart, size_t* relEnd, size_t* attrStart);
+    std::vector<size_t> findFlagLines(const char* data, size_t size, const std::string& flag);
+    bool readSection(const char* data, size_t start, size_t end, bool relationSection);
+    void readChunk(const char* data, size_t size, bool relationSection);
+    void mergeTables(TAProcessor& other);
+    void printLineError(int lineNum, std::string message);
 
     /** TA Writers */
     bool writeRelations(TAGraph* graph);
     bool writeAttributes(TAGraph* graph);
+    void streamRelations(TAGraph* graph, bool entities);
+    void addRelationToGraph(TAGraph* graph, const std::string& relName, const std::string& src, const std::string& dst);
+    bool addAttributesToGraph(TAGraph* graph, const std::string& itemID,
+                              const std::vector<std::pair<std::string, std::vector<std::string>>>& attrs);
+    bool addAttributesToGraph(TAGraph* graph, const std::string& relName, const std::string& srcID,
+                              const std::string& dstID,
+                              const std::vector<std::pair<std::string, std::vector<std::string>>>& attrs);
 
     /** TA Component Generators */
     std::string generateTAString();
     std::string generateRelationString();
     std::string generateAttributeString();
-    std::string generateAttributeStringFromKVs(std::vector<std::pair<std::string, std::vector<std::string>>> attr);
+    std::string generateAttributeStringFromKVs(const std::vector<std::pair<std::string, std::vector<std::string>>>& attr);
     std::vector<std::pair<std::string, std::vector<std::string>>> generateAttributes(int lineNum,
                                                                                      bool& succ,
-                                                                                     std::vector<std::string> line);
+                                                                                     const std::vector<boost::string_ref>& tokens,
+                                                                                     size_t start);
 
     /** Helper Methods */
-    std::vector<std::string> prepareLine(std::string line, bool &blockComment);
-    std::string removeStandardComment(std::string line);
-    std::string removeBlockComment(std::string line, bool &blockComment);
-    int findRelEntry(std::string name);
-    void createRelEntry(std::string name);
-    int findAttrEntry(std::string attrName);
-    int findAttrEntry(std::string relName, std::string src, std::string dst);
-    void createAttrEntry(std::string attrName);
-    void createAttrEntry(std::string relName, std::string src, std::string dst);
+    int findRelEntry(const std::string& name);
+    void createRelEntry(const std::string& name);
+    void addRelation(int pos, std::string src, std::string dst);
+    void compactRelations();
+    int findAttrEntry(const std::string& attrName);
+    int findAttrEntry(const std::string& relName, const std::string& src, const std::string& dst);
+    void createAttrEntry(const std::string& attrName);
+    void createAttrEntry(const std::string& relName, const std::string& src, const std::string& dst);
+    std::string generateRelKey(const std::string& relName, const std::string& src, const std::string& dst);
 
     /** Node / Edge Processors */
     void processNodes(std::vector<ClangNode*> nodes);
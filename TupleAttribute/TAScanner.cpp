@@ -0,0 +1,251 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// TAScanner.cpp
+//
+// Created By: Bryan J Muscedere
+// Date: 19/10/26.
+//
+// Scanner that maps a TA file into memory and hands out lines and
+// tokens as views into the mapped buffer. Comments are stripped in
+// the same pass that splits tokens so nothing is copied until the
+// processor decides to keep a value.
+//
+// Copyright (C) 2017, Bryan J. Muscedere
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <cctype>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "TAScanner.h"
+
+using namespace std;
+
+/** Section Flags */
+const string TAScanner::SCHEME_FLAG = "SCHEME TUPLE :";
+const string TAScanner::RELATION_FLAG = "FACT TUPLE :";
+const string TAScanner::ATTRIBUTE_FLAG = "FACT ATTRIBUTE :";
+
+/**
+ * Maps a TA file into memory.
+ * @param fileName The file to scan.
+ */
+TAScanner::TAScanner(string fileName) {
+    data = nullptr;
+    size = 0;
+    pos = 0;
+    lineNum = 0;
+    mapped = false;
+    opened = false;
+
+    //Opens the file.
+    int fd = open(fileName.c_str(), O_RDONLY);
+    if (fd < 0) return;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0){
+        close(fd);
+        return;
+    }
+
+    //Empty files can't be mapped.
+    opened = true;
+    size = (size_t) st.st_size;
+    if (size == 0){
+        close(fd);
+        return;
+    }
+
+    //Maps the file.
+    void* map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED){
+        opened = false;
+        size = 0;
+        return;
+    }
+    madvise(map, size, MADV_SEQUENTIAL);
+
+    data = (const char*) map;
+    mapped = true;
+}
+
+/**
+ * Scans a buffer that is already in memory. The buffer is not owned.
+ * @param data The buffer to scan.
+ * @param size The size of the buffer.
+ * @param startLine The line number of the first line.
+ */
+TAScanner::TAScanner(const char* data, size_t size, int startLine) {
+    this->data = data;
+    this->size = size;
+    pos = 0;
+    lineNum = startLine - 1;
+    mapped = false;
+    opened = true;
+}
+
+/**
+ * Unmaps the file.
+ */
+TAScanner::~TAScanner() {
+    if (mapped) munmap((void*) data, size);
+}
+
+/**
+ * Checks whether the file could be opened.
+ * @return Whether the scanner is open.
+ */
+bool TAScanner::isOpen(){
+    return opened;
+}
+
+/**
+ * Gets the size of the buffer.
+ * @return The number of bytes.
+ */
+size_t TAScanner::getSize(){
+    return size;
+}
+
+/**
+ * Gets the start of the buffer.
+ * @return The buffer.
+ */
+const char* TAScanner::getData(){
+    return data;
+}
+
+/**
+ * Gets the next line from the buffer.
+ * @param line The line without the trailing newline.
+ * @return Whether a line was read.
+ */
+bool TAScanner::nextLine(boost::string_ref& line){
+    if (pos >= size) return false;
+
+    //Finds the end of the line.
+    const char* start = data + pos;
+    const char* end = (const char*) memchr(start, '\n', size - pos);
+    size_t len = (end == nullptr) ? size - pos : (size_t) (end - start);
+
+    line = boost::string_ref(start, len);
+    pos += len + ((end == nullptr) ? 0 : 1);
+    lineNum++;
+    return true;
+}
+
+/**
+ * Gets the current position in the buffer.
+ * @return The offset of the next line.
+ */
+size_t TAScanner::tell(){
+    return pos;
+}
+
+/**
+ * Moves to a position in the buffer.
+ * @param pos The offset of the next line.
+ * @param lineNum The line number of the last line read.
+ */
+void TAScanner::seek(size_t pos, int lineNum){
+    this->pos = (pos > size) ? size : pos;
+    this->lineNum = lineNum;
+}
+
+/**
+ * Gets the number of the last line read.
+ * @return The line number.
+ */
+int TAScanner::getLineNumber(){
+    return lineNum;
+}
+
+/**
+ * Splits a line into whitespace separated tokens while removing
+ * line and block comments. Quoted values are kept as one token.
+ * @param line The line to tokenize.
+ * @param blockComment Whether we're inside a block comment.
+ * @param tokens The tokens that were found.
+ */
+void TAScanner::tokenize(boost::string_ref line, bool& blockComment, vector<boost::string_ref>& tokens){
+    tokens.clear();
+
+    const char* str = line.data();
+    size_t len = line.size();
+    size_t tokStart = 0;
+    bool inToken = false;
+    bool quoted = false;
+
+    for (size_t i = 0; i < len; i++){
+        char cur = str[i];
+        char next = (i + 1 < len) ? str[i + 1] : '\0';
+
+        //Looks for the end of the block comment.
+        if (blockComment){
+            if (cur == COMMENT_BLOCK_CHAR && next == COMMENT_CHAR){
+                blockComment = false;
+                i++;
+            }
+            continue;
+        }
+
+        //Everything inside quotes is part of the token.
+        if (quoted){
+            if (cur == QUOTE_CHAR) quoted = false;
+            continue;
+        }
+
+        //Checks for comments.
+        bool lineComment = (cur == COMMENT_CHAR && next == COMMENT_CHAR);
+        bool blockStart = (cur == COMMENT_CHAR && next == COMMENT_BLOCK_CHAR);
+        if (lineComment || blockStart || isspace((unsigned char) cur)){
+            if (inToken) tokens.push_back(boost::string_ref(str + tokStart, i - tokStart));
+            inToken = false;
+
+            if (lineComment) return;
+            if (blockStart){
+                blockComment = true;
+                i++;
+            }
+            continue;
+        }
+
+        //Adds the character to the token.
+        if (!inToken){
+            tokStart = i;
+            inToken = true;
+        }
+        if (cur == QUOTE_CHAR) quoted = true;
+    }
+
+    if (inToken) tokens.push_back(boost::string_ref(str + tokStart, len - tokStart));
+}
+
+/**
+ * Removes the quotes around a value.
+ * @param token The value to unquote.
+ * @return The value without quotes.
+ */
+string TAScanner::unquote(boost::string_ref token){
+    if (token.size() >= 2 && token.front() == QUOTE_CHAR && token.back() == QUOTE_CHAR){
+        token.remove_prefix(1);
+        token.remove_suffix(1);
+    }
+
+    return token.to_string();
+}
@@ -0,0 +1,78 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// TAScanner.h
+//
+// Created By: Bryan J Muscedere
+// Date: 19/10/26.
+//
+// Scanner that maps a TA file into memory and hands out lines and
+// tokens as views into the mapped buffer. Comments are stripped in
+// the same pass that splits tokens so nothing is copied until the
+// processor decides to keep a value.
+//
+// Copyright (C) 2017, Bryan J. Muscedere
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CLANGEX_TASCANNER_H
+#define CLANGEX_TASCANNER_H
+
+#include <string>
+#include <vector>
+#include <boost/utility/string_ref.hpp>
+
+class TAScanner {
+public:
+    /** Constructor/Destructor */
+    TAScanner(std::string fileName);
+    TAScanner(const char* data, size_t size, int startLine = 1);
+    ~TAScanner();
+
+    /** Scanner Status */
+    bool isOpen();
+    size_t getSize();
+    const char* getData();
+
+    /** Line Operations */
+    bool nextLine(boost::string_ref& line);
+    size_t tell();
+    void seek(size_t pos, int lineNum);
+    int getLineNumber();
+
+    /** Tokenizer */
+    static void tokenize(boost::string_ref line, bool& blockComment, std::vector<boost::string_ref>& tokens);
+    static std::string unquote(boost::string_ref token);
+
+    /** Section Flags */
+    static const std::string SCHEME_FLAG;
+    static const std::string RELATION_FLAG;
+    static const std::string ATTRIBUTE_FLAG;
+
+private:
+    /** Comment Characters */
+    const static char COMMENT_CHAR = '/';
+    const static char COMMENT_BLOCK_CHAR = '*';
+    const static char QUOTE_CHAR = '"';
+
+    /** Buffer Variables */
+    const char* data;
+    size_t size;
+    size_t pos;
+    int lineNum;
+    bool mapped;
+    bool opened;
+};
+
+
+#endif //CLANGEX_TASCANNER_H
@@ -31,8 +31,10 @@
 #include <openssl/md5.h>
 #include "ASTWalker.h"
 #include "clang/AST/Mangle.h"
+#include "clang/Index/USRGeneration.h"
 #include "../Graph/ClangNode.h"
 #include "../Graph/LowMemoryTAGraph.h"
+#include "../Metrics/Metrics.h"
 
 using namespace std;
 using namespace clang;
@@ -43,7 +45,10 @@ using namespace llvm;
 /**
  * Default Destructor
  */
-ASTWalker::~ASTWalker() { }
+ASTWalker::~ASTWalker() {
+    for (MatchFinder::MatchCallback* handler : handlers) delete handler;
+    delete tuGraph;
+}
 
 /**
  * Gets the graph for the current AST.
@@ -87,19 +92,143 @@ ASTWalker::ASTWalker(TAGraph::ClangExclude ex, bool lowMemory, Printer *print, T
         clangPrinter(print){
     //Sets the current file name to blank.
     curFileName = "";
+    usrMode = false;
+    pathFilter = nullptr;
+    curContext = nullptr;
+    astMemory = 0;
+    tuStarted = false;
+    matchTime = chrono::steady_clock::duration::zero();
 
     //Creates the graph system.
     if (existing == nullptr){
-        if (lowMemory == true) graph = new LowMemoryTAGraph();
+        if (lowMemory == true) graph = new LowMemoryTAGraph(LowMemoryTAGraph::LowMemoryConfig());
         else graph = new TAGraph();
     } else {
         graph = existing;
     }
+    tuGraph = new TAGraph();
 
     //Sets up the exclusions.
     exclusions = ex;
 }
 
+/**
+ * Checks whether any matcher looks inside function bodies. Calls and
+ * variable uses only appear in bodies.
+ * @return Whether function bodies must be parsed.
+ */
+bool ASTWalker::needsFunctionBodies(){
+    return !exclusions.cFunction || !exclusions.cVariable;
+}
+
+/**
+ * Sets whether declarations are identified by their USR.
+ * @param enabled Whether USR IDs are used.
+ */
+void ASTWalker::setUSRMode(bool enabled){
+    usrMode = enabled;
+}
+
+/**
+ * Sets the filter for the files that facts are extracted from.
+ * @param filter The filter or null for every file.
+ */
+void ASTWalker::setPathFilter(const PathFilter* filter){
+    pathFilter = filter;
+    filterCache.clear();
+}
+
+/**
+ * Clears the USR and filter caches since declarations and files
+ * from the last translation unit are no longer valid.
+ */
+void ASTWalker::onStartOfTranslationUnit(){
+    usrCache.clear();
+    filterCache.clear();
+    curContext = nullptr;
+    tuStarted = false;
+    if (Metrics::isEnabled()) matchStart = chrono::steady_clock::now();
+}
+
+/**
+ * Gets the most memory used by the AST of a translation unit.
+ * @return The number of bytes.
+ */
+size_t ASTWalker::getASTMemory(){
+    return astMemory;
+}
+
+/**
+ * Moves the facts of the translation unit into the graph and
+ * records the memory used by the AST before it's freed.
+ */
+void ASTWalker::onEndOfTranslationUnit(){
+    graph->mergeGraph(tuGraph);
+    if (tuStarted) graph->setCurrentTU(string());
+    tuStarted = false;
+
+    //Records how long matching took.
+    if (Metrics::isEnabled()) {
+        chrono::steady_clock::duration elapsed = chrono::steady_clock::now() - matchStart;
+        matchTime += elapsed;
+        Metrics::addTime(Metrics::MATCH, elapsed);
+        Metrics::addMatches(matchCounts);
+        matchCounts.clear();
+    }
+
+    if (curContext == nullptr) return;
+
+    size_t curMemory = curContext->getASTAllocatedMemory() + curContext->getSideTableAllocatedMemory();
+    if (curMemory > astMemory) astMemory = curMemory;
+}
+
+/**
+ * Gets the time spent matching the translation units.
+ * @return The time spent.
+ */
+chrono::steady_clock::duration ASTWalker::getMatchTime(){
+    return matchTime;
+}
+
+/**
+ * Records a match. The first match of a translation unit tells the
+ * graph which file the facts come from and each binding is counted.
+ * @param result The match result.
+ */
+void ASTWalker::recordMatch(const MatchFinder::MatchResult &result){
+    if (!tuStarted && graph->isTrackingProvenance()) {
+        SourceManager& srcMgr = *result.SourceManager;
+        const FileEntry* entry = srcMgr.getFileEntryForID(srcMgr.getMainFileID());
+        if (entry != nullptr) {
+            string mainName(entry->getName());
+            boost::system::error_code error;
+            boost::filesystem::path mainFile = canonical(boost::filesystem::path(mainName), error);
+            graph->setCurrentTU((error) ? mainName : mainFile.string());
+        }
+        tuStarted = true;
+    }
+
+    if (!Metrics::isEnabled()) return;
+    for (auto binding : result.Nodes.getMap()) matchCounts[binding.first]++;
+}
+
+/**
+ * Checks whether a match involves a file that is filtered out. Each
+ * bound node is checked so declarations in those files are skipped
+ * along with everything inside their bodies.
+ * @param result The match result.
+ * @return Whether the match should be skipped.
+ */
+bool ASTWalker::isFiltered(const MatchFinder::MatchResult &result){
+    if (pathFilter == nullptr) return false;
+
+    for (auto binding : result.Nodes.getMap()){
+        if (isFilteredLocation(*result.SourceManager, binding.second.getSourceRange().getBegin())) return true;
+    }
+
+    return false;
+}
+
 /**
  * Generates a file name from a given source location.
  * @param result The match result.
@@ -110,6 +239,7 @@ ASTWalker::ASTWalker(TAGraph::ClangExclude ex, bool lowMemory, Printer *print, T
 string ASTWalker::generateFileName(const MatchFinder::MatchResult result,
                                    SourceLocation loc, bool suppressFileOutput){
     //Gets the file name.
+    curContext = result.Context;
     SourceManager& SrcMgr = result.Context->getSourceManager();
     const FileEntry* Entry = SrcMgr.getFileEntryForID(SrcMgr.getFileID(loc));
 
@@ -122,7 +252,7 @@ string ASTWalker::generateFileName(const MatchFinder::MatchResult result,
     string newPath = canonical(fN.normalize()).string();
 
     //Adds the file path.
-    graph->addPath(newPath);
+    tuGraph->addPath(newPath);
 
     //Checks if we have a output suppression in place.
     if (!suppressFileOutput && newPath.compare("") != 0) printFileName(newPath);
@@ -136,6 +266,14 @@ string ASTWalker::generateFileName(const MatchFinder::MatchResult result,
  * @return The ID of the declaration.
  */
 string ASTWalker::generateID(const MatchFinder::MatchResult result, const NamedDecl *dec){
+    Metrics::Timer timer(Metrics::GENERATE_ID);
+
+    //Uses the USR when it's available.
+    if (usrMode) {
+        string ID = generateUSRID(dec);
+        if (ID.compare("") != 0) return ID;
+    }
+
     //Generates the ID.
     string name = generateIDString(result, dec);
     name = generateMD5(name);
@@ -149,6 +287,7 @@ string ASTWalker::generateID(const MatchFinder::MatchResult result, const NamedD
  * @return The generated string.
  */
 string ASTWalker::generateLabel(const MatchFinder::MatchResult result, const NamedDecl* curDecl) {
+    Metrics::Timer timer(Metrics::GENERATE_LABEL);
     string name = curDecl->getNameAsString();
     if (isa<RecordDecl>(curDecl) && (static_cast<const RecordDecl*>(curDecl)->isStruct()
                                  || static_cast<const RecordDecl*>(curDecl)->isUnion())
@@ -260,11 +399,11 @@ void ASTWalker::addFunctionDecl(const MatchFinder::MatchResult results, const Fu
 
     //Creates a new function entry.
     ClangNode* node = new ClangNode(ID, label, ClangNode::FUNCTION);
-    bool succ = graph->addNode(node);
+    bool succ = tuGraph->addNode(node);
     if (!succ) return;
 
     //Adds parameters.
-    graph->addAttribute(node->getID(),
+    tuGraph->addAttribute(node->getID(),
                                 ClangNode::FILE_ATTRIBUTE.attrName,
                                 ClangNode::FILE_ATTRIBUTE.processFileName(filename));
 
@@ -283,19 +422,19 @@ void ASTWalker::addFunctionDecl(const MatchFinder::MatchResult results, const Fu
         AccessSpecifier spec = methDecl->getAccess();
 
         //Add these types of attributes.
-        graph->addAttribute(node->getID(),
+        tuGraph->addAttribute(node->getID(),
                                     ClangNode::FUNC_IS_ATTRIBUTE.staticName,
                                     std::to_string(isStatic));
-        graph->addAttribute(node->getID(),
+        tuGraph->addAttribute(node->getID(),
                                     ClangNode::FUNC_IS_ATTRIBUTE.constName,
                                     std::to_string(isConst));
-        graph->addAttribute(node->getID(),
+        tuGraph->addAttribute(node->getID(),
                                     ClangNode::FUNC_IS_ATTRIBUTE.volName,
                                     std::to_string(isVol));
-        graph->addAttribute(node->getID(),
+        tuGraph->addAttribute(node->getID(),
                                     ClangNode::FUNC_IS_ATTRIBUTE.varName,
                                     std::to_string(isVari));
-        graph->addAttribute(node->getID(),
+        tuGraph->addAttribute(node->getID(),
                                     ClangNode::VIS_ATTRIBUTE.attrName,
                                     ClangNode::VIS_ATTRIBUTE.processAccessSpec(spec));
     }
@@ -337,19 +476,19 @@ void ASTWalker::addVariableDecl(const MatchFinder::MatchResult results,
 
     //Creates a variable entry.
     ClangNode* node = new ClangNode(ID, label, ClangNode::VARIABLE);
-    bool succ = graph->addNode(node);
+    bool succ = tuGraph->addNode(node);
     if (!succ) return;
 
     //Process attributes.
-    graph->addAttribute(node->getID(),
+    tuGraph->addAttribute(node->getID(),
                                 ClangNode::FILE_ATTRIBUTE.attrName,
                                 ClangNode::FILE_ATTRIBUTE.processFileName(filename));
 
     //Get the scope of the decl.
-    graph->addAttribute(node->getID(),
+    tuGraph->addAttribute(node->getID(),
                                 ClangNode::VAR_ATTRIBUTE.scopeName,
                                 scopeInfo);
-    graph->addAttribute(node->getID(),
+    tuGraph->addAttribute(node->getID(),
                                 ClangNode::VAR_ATTRIBUTE.staticName,
                                 staticInfo);
 }
@@ -384,14 +523,14 @@ void ASTWalker::addClassDecl(const MatchFinder::MatchResult results, const CXXRe
 
     //Creates a class entry.
     ClangNode* node = new ClangNode(ID, className, ClangNode::CLASS);
-    bool succ = graph->addNode(node);
+    bool succ = tuGraph->addNode(node);
     if (!succ) return;
 
     //Process attributes.
-    graph->addAttribute(node->getID(),
+    tuGraph->addAttribute(node->getID(),
                                 ClangNode::FILE_ATTRIBUTE.attrName,
                                 ClangNode::FILE_ATTRIBUTE.processFileName(filename));
-    graph->addAttribute(node->getID(),
+    tuGraph->addAttribute(node->getID(),
                                 ClangNode::BASE_ATTRIBUTE.attrName,
                                 std::to_string(numBases));
 
@@ -424,11 +563,11 @@ void ASTWalker::addEnumDecl(const MatchFinder::MatchResult result, const EnumDec
 
     //Creates a enum entry.
     ClangNode* node = new ClangNode(ID, enumName, ClangNode::ENUM);
-    bool succ = graph->addNode(node);
+    bool succ = tuGraph->addNode(node);
     if (!succ) return;
 
     //Process attributes.
-    graph->addAttribute(node->getID(),
+    tuGraph->addAttribute(node->getID(),
                                 ClangNode::FILE_ATTRIBUTE.attrName,
                                 ClangNode::FILE_ATTRIBUTE.processFileName(filename));
 }
@@ -450,11 +589,11 @@ void ASTWalker::addEnumConstantDecl(const MatchFinder::MatchResult result, const
 
     //Creates a new enum entry.
     ClangNode* node = new ClangNode(ID, enumName, ClangNode::ENUM_CONST);
-    bool succ = graph->addNode(node);
+    bool succ = tuGraph->addNode(node);
     if (!succ) return;
 
     //Process attributes.
-    graph->addAttribute(node->getID(),
+    tuGraph->addAttribute(node->getID(),
                                 ClangNode::FILE_ATTRIBUTE.attrName,
                                 ClangNode::FILE_ATTRIBUTE.processFileName(filename));
 }
@@ -476,14 +615,14 @@ void ASTWalker::addStructDecl(const MatchFinder::MatchResult result, const clang
 
     //Next, generates the node.
     ClangNode* node = new ClangNode(ID, label, ClangNode::STRUCT);
-    bool succ = graph->addNode(node);
+    bool succ = tuGraph->addNode(node);
     if (!succ) return;
 
     //Process the attributes.
-    graph->addAttribute(node->getID(),
+    tuGraph->addAttribute(node->getID(),
                                 ClangNode::FILE_ATTRIBUTE.attrName,
                                 ClangNode::FILE_ATTRIBUTE.processFileName(filename));
-    graph->addAttribute(node->getID(),
+    tuGraph->addAttribute(node->getID(),
                                 ClangNode::STRUCT_ATTRIBUTE.anonymousName,
                                 ClangNode::STRUCT_ATTRIBUTE.processAnonymous(isAnonymous));
 }
@@ -505,14 +644,14 @@ void ASTWalker::addUnionDecl(const MatchFinder::MatchResult result, const Record
 
     //Next, generates the node.
     ClangNode* node = new ClangNode(ID, label, ClangNode::UNION);
-    bool succ = graph->addNode(node);
+    bool succ = tuGraph->addNode(node);
     if (!succ) return;
 
     //Process the attributes.
-    graph->addAttribute(node->getID(),
+    tuGraph->addAttribute(node->getID(),
                         ClangNode::FILE_ATTRIBUTE.attrName,
                         ClangNode::FILE_ATTRIBUTE.processFileName(filename));
-    graph->addAttribute(node->getID(),
+    tuGraph->addAttribute(node->getID(),
                         ClangNode::STRUCT_ATTRIBUTE.anonymousName,
                         ClangNode::STRUCT_ATTRIBUTE.processAnonymous(isAnonymous));
 }
@@ -728,8 +867,8 @@ void ASTWalker::addRecordUseCall(const MatchFinder::MatchResult result, const Re
 void ASTWalker::processEdge(string srcID, string srcLabel, string dstID, string dstLabel, ClangEdge::EdgeType type,
                             vector<pair<string, string>> attributes){
     //Looks up the nodes by label.
-    ClangNode* sourceNode = graph->findNodeByID(srcID);
-    ClangNode* destNode = graph->findNodeByID(dstID);
+    ClangNode* sourceNode = tuGraph->findNodeByID(srcID);
+    ClangNode* destNode = tuGraph->findNodeByID(dstID);
 
     //Add the edge.
     ClangEdge* edge;
@@ -742,12 +881,12 @@ void ASTWalker::processEdge(string srcID, string srcLabel, string dstID, string
     } else {
         edge = new ClangEdge(srcID, dstID, type);
     }
-    bool succ = graph->addEdge(edge);
+    bool succ = tuGraph->addEdge(edge);
     if (!succ) return;
 
     //Iterate through our vector and add.
     for (auto mapItem : attributes) {
-        graph->addAttribute(edge->getSrcID(), edge->getDstID(), type,
+        tuGraph->addAttribute(edge->getSrcID(), edge->getDstID(), type,
                             mapItem.first, mapItem.second);
     }
 }
@@ -841,6 +980,26 @@ string ASTWalker::generateIDString(const MatchFinder::MatchResult result, const
     return name;
 }
 
+/**
+ * Generates an ID from the USR of a declaration. IDs are cached by
+ * canonical declaration so each USR is only built once.
+ * @param dec The declaration.
+ * @return The ID or blank if the declaration has no USR.
+ */
+string ASTWalker::generateUSRID(const NamedDecl* dec){
+    const Decl* canonical = dec->getCanonicalDecl();
+    auto it = usrCache.find(canonical);
+    if (it != usrCache.end()) return it->second;
+
+    //Hashes the USR to keep IDs the same width.
+    SmallString<128> usr;
+    string ID = "";
+    if (!clang::index::generateUSRForDecl(canonical, usr)) ID = generateMD5(usr.str().str());
+
+    usrCache[canonical] = ID;
+    return ID;
+}
+
 /**
  * Generates the line number for the current source location.
  * @param result The match result.
@@ -881,4 +1040,16 @@ bool ASTWalker::isAnonymousRecord(string qualName){
     }
 
     return false;
-}
\ No newline at end of file
+}
+
+/**
+ * Checks whether a location is in a filtered file. Each file is only
+ * matched against the filter once per translation unit.
+ * @param srcMgr The source manager.
+ * @param loc The location to check.
+ * @return Whether the file is filtered out.
+ */
+bool ASTWalker::isFilteredLocation(const SourceManager& srcMgr, SourceLocation loc){
+    if (loc.isInvalid()) return false;
+    return pathFilter->isExcluded(srcMgr, srcMgr.getFileID(srcMgr.getExpansionLoc(loc)), &filterCache);
+}
@@ -28,9 +28,12 @@
 #ifndef CLANGEX_ASTWALKER_H
 #define CLANGEX_ASTWALKER_H
 
+#include <map>
+#include <chrono>
 #include <vector>
 #include <tuple>
 #include <string>
+#include <unordered_map>
 #include "clang/Frontend/FrontendActions.h"
 #include "clang/Tooling/CommonOptionsParser.h"
 #include "clang/Tooling/Tooling.h"
@@ -39,22 +42,41 @@
 #include "../Graph/TAGraph.h"
 #include "../Driver/ClangDriver.h"
 #include "../File/FileParse.h"
+#include "../File/PathFilter.h"
 #include "../Printer/Printer.h"
 
 using namespace clang::ast_matchers;
 
-class ASTWalker : public MatchFinder::MatchCallback {
+template <class Walker> class MatchHandler;
+
+class ASTWalker {
 public:
     /** Destructor */
     virtual ~ASTWalker();
 
     /** Pure Virtual Methods */
-    virtual void run(const MatchFinder::MatchResult &result) = 0;
     virtual void generateASTMatches(MatchFinder *finder) = 0;
 
+    /** Body Operations */
+    virtual bool needsFunctionBodies();
+
     /** Graph Operations */
     TAGraph* getGraph();
 
+    /** ID Operations */
+    void setUSRMode(bool enabled);
+
+    /** Filter Operations */
+    void setPathFilter(const PathFilter* filter);
+    void onStartOfTranslationUnit();
+
+    /** Memory Operations */
+    size_t getASTMemory();
+    void onEndOfTranslationUnit();
+
+    /** Metric Operations */
+    std::chrono::steady_clock::duration getMatchTime();
+
     /** MD5 Operations */
     static std::string generateMD5(std::string text);
 
@@ -65,10 +87,16 @@ protected:
     /** Constructor */
     ASTWalker(TAGraph::ClangExclude ex, bool lowMemory, Printer* print, TAGraph* existing = nullptr);
 
+    /** Handler Operations */
+    template <class Walker>
+    MatchFinder::MatchCallback* addHandler(Walker* walker, void (Walker::*handler)(const MatchFinder::MatchResult&));
+
     /** Item Qualifiers */
     std::string generateFileName(const MatchFinder::MatchResult result,
                                  clang::SourceLocation loc, bool suppressOutput = false);
     std::string generateID(const MatchFinder::MatchResult result, const clang::NamedDecl *dec);
+    void recordMatch(const MatchFinder::MatchResult &result);
+    bool isFiltered(const MatchFinder::MatchResult &result);
     std::string generateLabel(const MatchFinder::MatchResult result, const clang::NamedDecl *dec);
 
     /** Protected Helper Methods */
@@ -121,8 +149,33 @@ private:
     /** Private Variables */
     std::string curFileName;
     TAGraph* graph;
+    TAGraph* tuGraph;
     Printer *clangPrinter;
 
+    /** USR Variables */
+    bool usrMode;
+    std::unordered_map<const clang::Decl*, std::string> usrCache;
+
+    /** Filter Variables */
+    const PathFilter* pathFilter;
+    PathFilter::ResultCache filterCache;
+
+    /** Memory Variables */
+    clang::ASTContext* curContext;
+    size_t astMemory;
+
+    /** Provenance Variables */
+    bool tuStarted;
+
+    /** Handler Variables */
+    std::vector<MatchFinder::MatchCallback*> handlers;
+    template <class Walker> friend class MatchHandler;
+
+    /** Metric Variables */
+    std::chrono::steady_clock::time_point matchStart;
+    std::chrono::steady_clock::duration matchTime;
+    std::map<std::string, unsigned long long> matchCounts;
+
     /** Edge Processor */
     void processEdge(std::string srcID, std::string srcLabel, std::string dstID, std::string dstLabel,
                      ClangEdge::EdgeType type, std::vector<std::pair<std::string, std::string>> attributes =
@@ -131,10 +184,78 @@ private:
     /** Helper Methods */
     void printFileName(std::string curFile);
     std::string generateIDString(const MatchFinder::MatchResult result, const clang::NamedDecl* dec);
+    std::string generateUSRID(const clang::NamedDecl* dec);
     std::string generateLineNumber(const MatchFinder::MatchResult result, const SourceLocation loc);
     bool isSource(std::string fileName);
     bool isAnonymousRecord(std::string qualName);
+    bool isFilteredLocation(const clang::SourceManager& srcMgr, clang::SourceLocation loc);
 };
 
+/**
+ * Callback for a single matcher. Each matcher calls its own method on
+ * the walker so matches don't have to be told apart by their bindings.
+ * Only the first handler of a walker passes on the translation unit
+ * events since the match finder sends them to every callback.
+ */
+template <class Walker>
+class MatchHandler : public MatchFinder::MatchCallback {
+public:
+    /** Handler Method Type */
+    typedef void (Walker::*Handler)(const MatchFinder::MatchResult&);
+
+    /**
+     * Creates a handler for a matcher.
+     * @param walker The walker that gets the matches.
+     * @param handler The method that handles the matches.
+     * @param primary Whether translation unit events are passed on.
+     */
+    MatchHandler(Walker* walker, Handler handler, bool primary) :
+            walker(walker), handler(handler), primary(primary) { }
+
+    /**
+     * Passes a match to the walker unless it's in a filtered file.
+     * @param result The match result.
+     */
+    void run(const MatchFinder::MatchResult &result) override {
+        walker->recordMatch(result);
+        if (walker->isFiltered(result)) return;
+        (walker->*handler)(result);
+    }
+
+    /**
+     * Tells the walker a translation unit started.
+     */
+    void onStartOfTranslationUnit() override {
+        if (primary) walker->onStartOfTranslationUnit();
+    }
+
+    /**
+     * Tells the walker a translation unit ended.
+     */
+    void onEndOfTranslationUnit() override {
+        if (primary) walker->onEndOfTranslationUnit();
+    }
+
+private:
+    /** Handler Variables */
+    Walker* walker;
+    Handler handler;
+    bool primary;
+};
+
+/**
+ * Creates the callback for a matcher. The walker owns the callback.
+ * @param walker The walker that gets the matches.
+ * @param handler The method that handles the matches.
+ * @return The callback to register with the matcher.
+ */
+template <class Walker>
+MatchFinder::MatchCallback* ASTWalker::addHandler(Walker* walker,
+                                                  void (Walker::*handler)(const MatchFinder::MatchResult&)){
+    MatchFinder::MatchCallback* callback = new MatchHandler<Walker>(walker, handler, handlers.size() == 0);
+    handlers.push_back(callback);
+    return callback;
+}
+
 
 #endif //CLANGEX_ASTWALKER_H
@@ -44,290 +44,495 @@ BlobWalker::BlobWalker(Printer* print, bool lowMemory, TAGraph::ClangExclude exc
 BlobWalker::~BlobWalker(){ }
 
 /**
- * Runs the AST matcher system. Looks for the match type and then acts on it.
+ * Adds a function declaration.
  * @param result The result that triggers this function.
  */
-void BlobWalker::run(const MatchFinder::MatchResult &result) {
-    //Check if the current result fits any of our match criteria.
-    if (const FunctionDecl *functionDecl = result.Nodes.getNodeAs<clang::FunctionDecl>(types[FUNC_DEC])) {
-        //Get whether we have a system header.
-        if (isInSystemHeader(result, functionDecl)) return;
-
-        //Gets the canonical decl.
-        functionDecl = functionDecl->getCanonicalDecl();
-
-        //Adds a function decl.
-        addFunctionDecl(result, functionDecl);
-
-        //Adds a class reference.
-        performAddClassCall(result, functionDecl, ClangNode::FUNCTION);
-    } else if (const VarDecl *variableDecl = result.Nodes.getNodeAs<clang::VarDecl>(types[VAR_DEC])){
-        //Get whether we have a system header.
-        if (isInSystemHeader(result, variableDecl) || variableDecl->getQualifiedNameAsString().compare("") == 0) return;
-
-        //Adds a variable decl.
-        addVariableDecl(result, variableDecl);
-
-        //Adds a class reference.
-        performAddClassCall(result, variableDecl, ClangNode::VARIABLE);
-    } else if (const FieldDecl *fieldDecl = result.Nodes.getNodeAs<clang::FieldDecl>(types[FIELD_DEC])) {
-        //Get whether we have a system header.
-        if (isInSystemHeader(result, fieldDecl) || fieldDecl->getQualifiedNameAsString().compare("") == 0) return;
-
-        //Adds a field decl.
-        addVariableDecl(result, nullptr, fieldDecl);
-
-        //Adds a class reference.
-        performAddClassCall(result, fieldDecl, ClangNode::VARIABLE);
-    } else if (const VarDecl *varInside = result.Nodes.getNodeAs<clang::VarDecl>(types[VAR_INSIDE])) {
-        //Get the parent function.
-        auto *parentFunc = result.Nodes.getNodeAs<clang::FunctionDecl>(types[INSIDE_FUNC]);
-
-        //Get whether this call expression is a system header.
-        if (isInSystemHeader(result, varInside) || varInside->getQualifiedNameAsString().compare("") == 0) return;
-
-        //Adds the function call.
-        addVariableInsideCall(result, parentFunc, varInside);
-    } else if (const FieldDecl *fieldInside = result.Nodes.getNodeAs<clang::FieldDecl>(types[FIELD_INSIDE])) {
-        //Get the parent function.
-        auto *parentFunc = result.Nodes.getNodeAs<clang::FunctionDecl>(types[INSIDE_FUNC]);
-
-        //Get whether this call expression is a system header.
-        if (isInSystemHeader(result, fieldInside) || fieldInside->getQualifiedNameAsString().compare("") == 0) return;
-
-        //Adds the function call.
-        addVariableInsideCall(result, parentFunc, nullptr, fieldInside);
-    } else if (const VarDecl *varParam = result.Nodes.getNodeAs<clang::VarDecl>(types[VAR_PARAM])) {
-        //Get the parent function.
-        auto *parentFunc = result.Nodes.getNodeAs<clang::FunctionDecl>(types[FUNC_PARAM]);
-
-        //Get whether this call expression is a system header.
-        if (isInSystemHeader(result, varParam) || varParam->getQualifiedNameAsString().compare("") == 0) return;
-
-        //Adds the function call.
-        addVariableInsideCall(result, parentFunc, varParam);
-    } else if (const CallExpr *expr = result.Nodes.getNodeAs<clang::CallExpr>(types[FUNC_CALLEE])){
-        if (expr->getCalleeDecl() == nullptr || !(isa<const clang::FunctionDecl>(expr->getCalleeDecl()))) return;
-        auto callee = expr->getCalleeDecl()->getAsFunction();
-        auto caller = result.Nodes.getNodeAs<clang::DeclaratorDecl>(types[FUNC_CALLER]);
-
-        //Get whether this call expression is a system header.
-        if (isInSystemHeader(result, callee)) return;
-
-        addFunctionCall(result, caller, callee);
-    } else if (const VarDecl *callee = result.Nodes.getNodeAs<clang::VarDecl>(types[VAR_CALLEE])) {
-        //If a variable reference has been found.
-        auto *caller = result.Nodes.getNodeAs<clang::DeclaratorDecl>(types[VAR_CALLER]);
-        auto *expr = result.Nodes.getNodeAs<clang::Expr>(types[VAR_EXPR]);
-
-        //Get whether this call expression is in the system header.
-        if (isInSystemHeader(result, callee)) return;
-
-        addVariableCall(result, caller, expr, callee);
-    } else if (const FieldDecl *callee = result.Nodes.getNodeAs<clang::FieldDecl>(types[FIELD_CALLEE])){
-        //If a variable reference has been found.
-        auto *caller = result.Nodes.getNodeAs<clang::DeclaratorDecl>(types[VAR_CALLER]);
-        auto *expr = result.Nodes.getNodeAs<clang::Expr>(types[VAR_EXPR]);
-
-        //Get whether this call expression is in the system header.
-        if (isInSystemHeader(result, callee)) return;
-
-        addVariableCall(result, caller, expr, nullptr, callee);
-    } else if (const CXXRecordDecl *classRec = result.Nodes.getNodeAs<clang::CXXRecordDecl>(types[CLASS_DEC])){
-        //Get whether this call expression is in the system header.
-        if (isInSystemHeader(result, classRec)) return;
-
-        addClassDecl(result, classRec);
-    } else if (const EnumDecl *enumDecl = result.Nodes.getNodeAs<clang::EnumDecl>(types[ENUM_DEC])){
-        //Get whether this call expression is in the system header.
-        if (isInSystemHeader(result, enumDecl)) return;
-
-        //Adds the enum declaration.
-        addEnumDecl(result, enumDecl);
-    } else if (const EnumConstantDecl *enumConstDecl = result.Nodes.getNodeAs<clang::EnumConstantDecl>(types[ENUM_CONST_DECL])){
-        //Get whether this call expression is in the system header.
-        if (isInSystemHeader(result, enumConstDecl)) return;
-
-        //Adds the enum constant declarations.
-        addEnumConstantDecl(result, enumConstDecl);
-
-        auto *parent = result.Nodes.getNodeAs<clang::EnumDecl>(types[ENUM_PARENT]);
-        if (parent == nullptr) return;
-
-        addEnumConstantCall(result, parent, enumConstDecl);
-    } else if (const VarDecl *varEnumRef = result.Nodes.getNodeAs<clang::VarDecl>(types[VAR_REF_ENUM])){
-        auto *enumRef = result.Nodes.getNodeAs<clang::EnumDecl>(types[ENUM_DEC_REF]);
-
-        //Get whether this call expression is in the system header.
-        if (isInSystemHeader(result, varEnumRef) || isInSystemHeader(result, enumRef)) return;
-
-        addEnumCall(result, enumRef, varEnumRef);
-    } else if (const FieldDecl *fieldEnumRef = result.Nodes.getNodeAs<clang::FieldDecl>(types[FIELD_REF_ENUM])){
-        auto *enumRef = result.Nodes.getNodeAs<clang::EnumDecl>(types[ENUM_DEC_REF]);
-
-        //Get whether this call expression is in the system header.
-        if (isInSystemHeader(result, fieldEnumRef) || isInSystemHeader(result, enumRef)) return;
-
-        addEnumCall(result, enumRef, nullptr, fieldEnumRef);
-    } else if (const RecordDecl *structDecl = result.Nodes.getNodeAs<clang::RecordDecl>(types[STRUCT_DECL])){
-        //Get whether this call expression is in the system header.
-        if (isInSystemHeader(result, structDecl)) return;
-
-        addStructDecl(result, structDecl);
-    } else if (const DeclaratorDecl *itemDecl = result.Nodes.getNodeAs<clang::DeclaratorDecl>(types[STRUCT_REF_ITEM])){
-        //Get the struct being referenced.
-        auto *structDecl = result.Nodes.getNodeAs<clang::RecordDecl>(types[STRUCT_REF]);
-
-        //Checks if the expression is in the system header.
-        if (isInSystemHeader(result, itemDecl) || isInSystemHeader(result, structDecl)) return;
-
-        addRecordCall(result, structDecl, itemDecl);
-    } else if (const VarDecl *varStruct = result.Nodes.getNodeAs<clang::VarDecl>(types[VAR_BOUND_STRUCT])){
-        //Get the struct being referenced.
-        auto *structDecl = result.Nodes.getNodeAs<clang::RecordDecl>(types[STRUCT_REF_DECL]);
-
-        //Get whether this call expression is in the system header.
-        if (isInSystemHeader(result, varStruct) || isInSystemHeader(result, structDecl)) return;
-
-        addRecordUseCall(result, structDecl, varStruct);
-    } else if (const FieldDecl *fieldStruct = result.Nodes.getNodeAs<clang::FieldDecl>(types[FIELD_BOUND_STRUCT])){
-        //Get the struct being referenced.
-        auto *structDecl = result.Nodes.getNodeAs<clang::RecordDecl>(types[STRUCT_REF_DECL]);
-
-        //Get whether this call expression is in the system header.
-        if (isInSystemHeader(result, fieldStruct) || isInSystemHeader(result, structDecl)) return;
-
-        addRecordUseCall(result, structDecl, nullptr, fieldStruct);
-    } else if (const RecordDecl *unionDecl = result.Nodes.getNodeAs<clang::RecordDecl>(types[UNION_DECL])){
-        //Get whether this call expression is in the system header.
-        if (isInSystemHeader(result, unionDecl)) return;
-
-        addUnionDecl(result, unionDecl);
-    } else if (const DeclaratorDecl *itemDecl = result.Nodes.getNodeAs<clang::DeclaratorDecl>(types[STRUCT_REF_ITEM])){
-        //Get the union being referenced.
-        auto *unionDecl = result.Nodes.getNodeAs<clang::RecordDecl>(types[UNION_REF]);
-
-        //Checks if the expression is in the system header.
-        if (isInSystemHeader(result, itemDecl) || isInSystemHeader(result, unionDecl)) return;
+void BlobWalker::matchFunctionDecl(const MatchFinder::MatchResult &result){
+    const FunctionDecl *functionDecl = result.Nodes.getNodeAs<clang::FunctionDecl>(types[FUNC_DEC]);
 
-        addRecordCall(result, unionDecl, itemDecl);
-    } else if (const VarDecl *varStruct = result.Nodes.getNodeAs<clang::VarDecl>(types[VAR_BOUND_UNION])){
-        //Get the struct being referenced.
-        auto *unionDecl = result.Nodes.getNodeAs<clang::RecordDecl>(types[UNION_REF_DECL]);
-
-        //Get whether this call expression is in the system header.
-        if (isInSystemHeader(result, varStruct) || isInSystemHeader(result, unionDecl)) return;
+    //Get whether we have a system header.
+    if (functionDecl == nullptr || isInSystemHeader(result, functionDecl)) return;
 
-        addRecordUseCall(result, unionDecl, varStruct);
-    } else if (const FieldDecl *fieldStruct = result.Nodes.getNodeAs<clang::FieldDecl>(types[FIELD_BOUND_UNION])){
-        //Get the struct being referenced.
-        auto *unionDecl = result.Nodes.getNodeAs<clang::RecordDecl>(types[UNION_REF_DECL]);
+    //Gets the canonical decl.
+    functionDecl = functionDecl->getCanonicalDecl();
 
-        //Get whether this call expression is in the system header.
-        if (isInSystemHeader(result, fieldStruct) || isInSystemHeader(result, unionDecl)) return;
+    //Adds a function decl.
+    addFunctionDecl(result, functionDecl);
 
-        addRecordUseCall(result, unionDecl, nullptr, fieldStruct);
-    }
+    //Adds a class reference.
+    performAddClassCall(result, functionDecl, ClangNode::FUNCTION);
+}
+
+/**
+ * Adds a variable declaration.
+ * @param result The result that triggers this function.
+ */
+void BlobWalker::matchVariableDecl(const MatchFinder::MatchResult &result){
+    const VarDecl *variableDecl = result.Nodes.getNodeAs<clang::VarDecl>(types[VAR_DEC]);
+
+    //Get whether we have a system header.
+    if (variableDecl == nullptr || isInSystemHeader(result, variableDecl) ||
+            variableDecl->getQualifiedNameAsString().compare("") == 0) return;
+
+    //Adds a variable decl.
+    addVariableDecl(result, variableDecl);
+
+    //Adds a class reference.
+    performAddClassCall(result, variableDecl, ClangNode::VARIABLE);
+}
+
+/**
+ * Adds a field declaration.
+ * @param result The result that triggers this function.
+ */
+void BlobWalker::matchFieldDecl(const MatchFinder::MatchResult &result){
+    const FieldDecl *fieldDecl = result.Nodes.getNodeAs<clang::FieldDecl>(types[FIELD_DEC]);
+
+    //Get whether we have a system header.
+    if (fieldDecl == nullptr || isInSystemHeader(result, fieldDecl) ||
+            fieldDecl->getQualifiedNameAsString().compare("") == 0) return;
+
+    //Adds a field decl.
+    addVariableDecl(result, nullptr, fieldDecl);
+
+    //Adds a class reference.
+    performAddClassCall(result, fieldDecl, ClangNode::VARIABLE);
+}
+
+/**
+ * Adds a variable declared inside a function.
+ * @param result The result that triggers this function.
+ */
+void BlobWalker::matchVariableInside(const MatchFinder::MatchResult &result){
+    const VarDecl *varInside = result.Nodes.getNodeAs<clang::VarDecl>(types[VAR_INSIDE]);
+
+    //Get the parent function.
+    auto *parentFunc = result.Nodes.getNodeAs<clang::FunctionDecl>(types[INSIDE_FUNC]);
+
+    //Get whether this call expression is a system header.
+    if (varInside == nullptr || isInSystemHeader(result, varInside) ||
+            varInside->getQualifiedNameAsString().compare("") == 0) return;
+
+    //Adds the function call.
+    addVariableInsideCall(result, parentFunc, varInside);
 }
 
 /**
- * Generates the AST matchers that will trigger the run function.
+ * Adds a field declared inside a function.
+ * @param result The result that triggers this function.
+ */
+void BlobWalker::matchFieldInside(const MatchFinder::MatchResult &result){
+    const FieldDecl *fieldInside = result.Nodes.getNodeAs<clang::FieldDecl>(types[FIELD_INSIDE]);
+
+    //Get the parent function.
+    auto *parentFunc = result.Nodes.getNodeAs<clang::FunctionDecl>(types[INSIDE_FUNC]);
+
+    //Get whether this call expression is a system header.
+    if (fieldInside == nullptr || isInSystemHeader(result, fieldInside) ||
+            fieldInside->getQualifiedNameAsString().compare("") == 0) return;
+
+    //Adds the function call.
+    addVariableInsideCall(result, parentFunc, nullptr, fieldInside);
+}
+
+/**
+ * Adds a function parameter.
+ * @param result The result that triggers this function.
+ */
+void BlobWalker::matchVariableParam(const MatchFinder::MatchResult &result){
+    const VarDecl *varParam = result.Nodes.getNodeAs<clang::VarDecl>(types[VAR_PARAM]);
+
+    //Get the parent function.
+    auto *parentFunc = result.Nodes.getNodeAs<clang::FunctionDecl>(types[FUNC_PARAM]);
+
+    //Get whether this call expression is a system header.
+    if (varParam == nullptr || isInSystemHeader(result, varParam) ||
+            varParam->getQualifiedNameAsString().compare("") == 0) return;
+
+    //Adds the function call.
+    addVariableInsideCall(result, parentFunc, varParam);
+}
+
+/**
+ * Adds a call from one function to another.
+ * @param result The result that triggers this function.
+ */
+void BlobWalker::matchFunctionCall(const MatchFinder::MatchResult &result){
+    const CallExpr *expr = result.Nodes.getNodeAs<clang::CallExpr>(types[FUNC_CALLEE]);
+    if (expr == nullptr || expr->getCalleeDecl() == nullptr ||
+            !(isa<const clang::FunctionDecl>(expr->getCalleeDecl()))) return;
+    auto callee = expr->getCalleeDecl()->getAsFunction();
+    auto caller = result.Nodes.getNodeAs<clang::DeclaratorDecl>(types[FUNC_CALLER]);
+
+    //Get whether this call expression is a system header.
+    if (isInSystemHeader(result, callee)) return;
+
+    addFunctionCall(result, caller, callee);
+}
+
+/**
+ * Adds a function's use of a variable.
+ * @param result The result that triggers this function.
+ */
+void BlobWalker::matchVariableCall(const MatchFinder::MatchResult &result){
+    const VarDecl *callee = result.Nodes.getNodeAs<clang::VarDecl>(types[VAR_CALLEE]);
+    auto *caller = result.Nodes.getNodeAs<clang::DeclaratorDecl>(types[VAR_CALLER]);
+    auto *expr = result.Nodes.getNodeAs<clang::Expr>(types[VAR_EXPR]);
+
+    //Get whether this call expression is in the system header.
+    if (callee == nullptr || isInSystemHeader(result, callee)) return;
+
+    addVariableCall(result, caller, expr, callee);
+}
+
+/**
+ * Adds a function's use of a field.
+ * @param result The result that triggers this function.
+ */
+void BlobWalker::matchFieldCall(const MatchFinder::MatchResult &result){
+    const FieldDecl *callee = result.Nodes.getNodeAs<clang::FieldDecl>(types[FIELD_CALLEE]);
+    auto *caller = result.Nodes.getNodeAs<clang::DeclaratorDecl>(types[VAR_CALLER]);
+    auto *expr = result.Nodes.getNodeAs<clang::Expr>(types[FIELD_EXPR]);
+
+    //Get whether this call expression is in the system header.
+    if (callee == nullptr || isInSystemHeader(result, callee)) return;
+
+    addVariableCall(result, caller, expr, nullptr, callee);
+}
+
+/**
+ * Adds a class declaration.
+ * @param result The result that triggers this function.
+ */
+void BlobWalker::matchClassDecl(const MatchFinder::MatchResult &result){
+    const CXXRecordDecl *classRec = result.Nodes.getNodeAs<clang::CXXRecordDecl>(types[CLASS_DEC]);
+
+    //Get whether this call expression is in the system header.
+    if (classRec == nullptr || isInSystemHeader(result, classRec)) return;
+
+    addClassDecl(result, classRec);
+}
+
+/**
+ * Adds an enum declaration.
+ * @param result The result that triggers this function.
+ */
+void BlobWalker::matchEnumDecl(const MatchFinder::MatchResult &result){
+    const EnumDecl *enumDecl = result.Nodes.getNodeAs<clang::EnumDecl>(types[ENUM_DEC]);
+
+    //Get whether this call expression is in the system header.
+    if (enumDecl == nullptr || isInSystemHeader(result, enumDecl)) return;
+
+    //Adds the enum declaration.
+    addEnumDecl(result, enumDecl);
+}
+
+/**
+ * Adds an enum constant and its link to the enum.
+ * @param result The result that triggers this function.
+ */
+void BlobWalker::matchEnumConstantDecl(const MatchFinder::MatchResult &result){
+    const EnumConstantDecl *enumConstDecl = result.Nodes.getNodeAs<clang::EnumConstantDecl>(types[ENUM_CONST_DECL]);
+
+    //Get whether this call expression is in the system header.
+    if (enumConstDecl == nullptr || isInSystemHeader(result, enumConstDecl)) return;
+
+    //Adds the enum constant declarations.
+    addEnumConstantDecl(result, enumConstDecl);
+
+    auto *parent = result.Nodes.getNodeAs<clang::EnumDecl>(types[ENUM_PARENT]);
+    if (parent == nullptr) return;
+
+    addEnumConstantCall(result, parent, enumConstDecl);
+}
+
+/**
+ * Adds a variable of an enum type.
+ * @param result The result that triggers this function.
+ */
+void BlobWalker::matchVariableEnumRef(const MatchFinder::MatchResult &result){
+    const VarDecl *varEnumRef = result.Nodes.getNodeAs<clang::VarDecl>(types[VAR_REF_ENUM]);
+    auto *enumRef = result.Nodes.getNodeAs<clang::EnumDecl>(types[ENUM_DEC_REF]);
+
+    //Get whether this call expression is in the system header.
+    if (varEnumRef == nullptr || isInSystemHeader(result, varEnumRef) || isInSystemHeader(result, enumRef)) return;
+
+    addEnumCall(result, enumRef, varEnumRef);
+}
+
+/**
+ * Adds a field of an enum type.
+ * @param result The result that triggers this function.
+ */
+void BlobWalker::matchFieldEnumRef(const MatchFinder::MatchResult &result){
+    const FieldDecl *fieldEnumRef = result.Nodes.getNodeAs<clang::FieldDecl>(types[FIELD_REF_ENUM]);
+    auto *enumRef = result.Nodes.getNodeAs<clang::EnumDecl>(types[ENUM_DEC_REF]);
+
+    //Get whether this call expression is in the system header.
+    if (fieldEnumRef == nullptr || isInSystemHeader(result, fieldEnumRef) || isInSystemHeader(result, enumRef)) return;
+
+    addEnumCall(result, enumRef, nullptr, fieldEnumRef);
+}
+
+/**
+ * Adds a struct declaration.
+ * @param result The result that triggers this function.
+ */
+void BlobWalker::matchStructDecl(const MatchFinder::MatchResult &result){
+    const RecordDecl *structDecl = result.Nodes.getNodeAs<clang::RecordDecl>(types[STRUCT_DECL]);
+
+    //Get whether this call expression is in the system header.
+    if (structDecl == nullptr || isInSystemHeader(result, structDecl)) return;
+
+    addStructDecl(result, structDecl);
+}
+
+/**
+ * Adds an item that is part of a struct.
+ * @param result The result that triggers this function.
+ */
+void BlobWalker::matchStructItem(const MatchFinder::MatchResult &result){
+    const DeclaratorDecl *itemDecl = result.Nodes.getNodeAs<clang::DeclaratorDecl>(types[STRUCT_REF_ITEM]);
+
+    //Get the struct being referenced.
+    auto *structDecl = result.Nodes.getNodeAs<clang::RecordDecl>(types[STRUCT_REF]);
+
+    //Checks if the expression is in the system header.
+    if (itemDecl == nullptr || isInSystemHeader(result, itemDecl) || isInSystemHeader(result, structDecl)) return;
+
+    addRecordCall(result, structDecl, itemDecl);
+}
+
+/**
+ * Adds a variable of a struct type.
+ * @param result The result that triggers this function.
+ */
+void BlobWalker::matchVariableStructRef(const MatchFinder::MatchResult &result){
+    const VarDecl *varStruct = result.Nodes.getNodeAs<clang::VarDecl>(types[VAR_BOUND_STRUCT]);
+
+    //Get the struct being referenced.
+    auto *structDecl = result.Nodes.getNodeAs<clang::RecordDecl>(types[STRUCT_REF_DECL]);
+
+    //Get whether this call expression is in the system header.
+    if (varStruct == nullptr || isInSystemHeader(result, varStruct) || isInSystemHeader(result, structDecl)) return;
+
+    addRecordUseCall(result, structDecl, varStruct);
+}
+
+/**
+ * Adds a field of a struct type.
+ * @param result The result that triggers this function.
+ */
+void BlobWalker::matchFieldStructRef(const MatchFinder::MatchResult &result){
+    const FieldDecl *fieldStruct = result.Nodes.getNodeAs<clang::FieldDecl>(types[FIELD_BOUND_STRUCT]);
+
+    //Get the struct being referenced.
+    auto *structDecl = result.Nodes.getNodeAs<clang::RecordDecl>(types[STRUCT_REF_DECL]);
+
+    //Get whether this call expression is in the system header.
+    if (fieldStruct == nullptr || isInSystemHeader(result, fieldStruct) || isInSystemHeader(result, structDecl)) return;
+
+    addRecordUseCall(result, structDecl, nullptr, fieldStruct);
+}
+
+/**
+ * Adds a union declaration.
+ * @param result The result that triggers this function.
+ */
+void BlobWalker::matchUnionDecl(const MatchFinder::MatchResult &result){
+    const RecordDecl *unionDecl = result.Nodes.getNodeAs<clang::RecordDecl>(types[UNION_DECL]);
+
+    //Get whether this call expression is in the system header.
+    if (unionDecl == nullptr || isInSystemHeader(result, unionDecl)) return;
+
+    addUnionDecl(result, unionDecl);
+}
+
+/**
+ * Adds an item that is part of a union.
+ * @param result The result that triggers this function.
+ */
+void BlobWalker::matchUnionItem(const MatchFinder::MatchResult &result){
+    const DeclaratorDecl *itemDecl = result.Nodes.getNodeAs<clang::DeclaratorDecl>(types[UNION_REF_ITEM]);
+
+    //Get the union being referenced.
+    auto *unionDecl = result.Nodes.getNodeAs<clang::RecordDecl>(types[UNION_REF]);
+
+    //Checks if the expression is in the system header.
+    if (itemDecl == nullptr || isInSystemHeader(result, itemDecl) || isInSystemHeader(result, unionDecl)) return;
+
+    addRecordCall(result, unionDecl, itemDecl);
+}
+
+/**
+ * Adds a variable of a union type.
+ * @param result The result that triggers this function.
+ */
+void BlobWalker::matchVariableUnionRef(const MatchFinder::MatchResult &result){
+    const VarDecl *varUnion = result.Nodes.getNodeAs<clang::VarDecl>(types[VAR_BOUND_UNION]);
+
+    //Get the union being referenced.
+    auto *unionDecl = result.Nodes.getNodeAs<clang::RecordDecl>(types[UNION_REF_DECL]);
+
+    //Get whether this call expression is in the system header.
+    if (varUnion == nullptr || isInSystemHeader(result, varUnion) || isInSystemHeader(result, unionDecl)) return;
+
+    addRecordUseCall(result, unionDecl, varUnion);
+}
+
+/**
+ * Adds a field of a union type.
+ * @param result The result that triggers this function.
+ */
+void BlobWalker::matchFieldUnionRef(const MatchFinder::MatchResult &result){
+    const FieldDecl *fieldUnion = result.Nodes.getNodeAs<clang::FieldDecl>(types[FIELD_BOUND_UNION]);
+
+    //Get the union being referenced.
+    auto *unionDecl = result.Nodes.getNodeAs<clang::RecordDecl>(types[UNION_REF_DECL]);
+
+    //Get whether this call expression is in the system header.
+    if (fieldUnion == nullptr || isInSystemHeader(result, fieldUnion) || isInSystemHeader(result, unionDecl)) return;
+
+    addRecordUseCall(result, unionDecl, nullptr, fieldUnion);
+}
+
+/**
+ * Generates the AST matchers. Each matcher gets its own handler so
+ * matches don't need to be told apart by their bindings.
  * @param finder The match finder that will store these triggers.
  */
 void BlobWalker::generateASTMatches(MatchFinder *finder){
     //Function methods.
     if (!exclusions.cFunction){
         //Finds function declarations for current C/C++ file.
-        finder->addMatcher(functionDecl(isDefinition()).bind(types[FUNC_DEC]), this);
+        finder->addMatcher(functionDecl(isDefinition()).bind(types[FUNC_DEC]),
+                           addHandler(this, &BlobWalker::matchFunctionDecl));
 
         //Finds function calls from one function to another.
-        finder->addMatcher(callExpr(hasAncestor(functionDecl().bind(types[FUNC_CALLER]))).bind(types[FUNC_CALLEE]), this);
+        finder->addMatcher(callExpr(hasAncestor(functionDecl().bind(types[FUNC_CALLER]))).bind(types[FUNC_CALLEE]),
+                           addHandler(this, &BlobWalker::matchFunctionCall));
     }
 
     //Variable methods.
     if (!exclusions.cVariable){
         //Finds variable declarations in functions AND in class decs.
-        finder->addMatcher(varDecl().bind(types[VAR_DEC]), this);
-        finder->addMatcher(fieldDecl().bind(types[FIELD_DEC]), this);
+        finder->addMatcher(varDecl().bind(types[VAR_DEC]),
+                           addHandler(this, &BlobWalker::matchVariableDecl));
+        finder->addMatcher(fieldDecl().bind(types[FIELD_DEC]),
+                           addHandler(this, &BlobWalker::matchFieldDecl));
 
         //Adds scope for variables.
-        finder->addMatcher(varDecl(hasAncestor(functionDecl().bind(types[INSIDE_FUNC]))).bind(types[VAR_INSIDE]), this);
-        finder->addMatcher(fieldDecl(hasAncestor(functionDecl().bind(types[INSIDE_FUNC]))).bind(types[FIELD_INSIDE]), this);
+        finder->addMatcher(varDecl(hasAncestor(functionDecl().bind(types[INSIDE_FUNC]))).bind(types[VAR_INSIDE]),
+                           addHandler(this, &BlobWalker::matchVariableInside));
+        finder->addMatcher(fieldDecl(hasAncestor(functionDecl().bind(types[INSIDE_FUNC]))).bind(types[FIELD_INSIDE]),
+                           addHandler(this, &BlobWalker::matchFieldInside));
         finder->addMatcher(parmVarDecl(hasAncestor(functionDecl()
-                                                           .bind(types[FUNC_PARAM]))).bind(types[VAR_PARAM]), this);
+                                                           .bind(types[FUNC_PARAM]))).bind(types[VAR_PARAM]),
+                           addHandler(this, &BlobWalker::matchVariableParam));
         
         //Finds variable uses amongst functions.
         finder->addMatcher(declRefExpr(hasDeclaration(varDecl().bind(types[VAR_CALLEE])),
                            hasAncestor(functionDecl().bind(types[VAR_CALLER])),
-                           hasParent(expr().bind(types[VAR_EXPR]))), this);
+                           hasParent(expr().bind(types[VAR_EXPR]))),
+                           addHandler(this, &BlobWalker::matchVariableCall));
         finder->addMatcher(declRefExpr(hasDeclaration(fieldDecl().bind(types[FIELD_CALLEE])),
                                        hasAncestor(functionDecl().bind(types[VAR_CALLER])),
-                                       hasParent(expr().bind(types[FIELD_EXPR]))), this);
+                                       hasParent(expr().bind(types[FIELD_EXPR]))),
+                           addHandler(this, &BlobWalker::matchFieldCall));
     }
 
     //Class methods.
     if (!exclusions.cClass){
         //Finds class declarations.
-        finder->addMatcher(cxxRecordDecl(isClass()).bind(types[CLASS_DEC]), this);
+        finder->addMatcher(cxxRecordDecl(isClass()).bind(types[CLASS_DEC]),
+                           addHandler(this, &BlobWalker::matchClassDecl));
     }
 
     //Enum methods.
     if (!exclusions.cEnum){
         //Finds enum declarations.
-        finder->addMatcher(enumDecl().bind(types[ENUM_DEC]), this);
+        finder->addMatcher(enumDecl().bind(types[ENUM_DEC]),
+                           addHandler(this, &BlobWalker::matchEnumDecl));
 
         //Finds enum constant declarations.
         //Also deals with their connections to enums.
-        finder->addMatcher(enumConstantDecl().bind(types[ENUM_CONST_DECL]), this);
+        finder->addMatcher(enumConstantDecl().bind(types[ENUM_CONST_DECL]),
+                           addHandler(this, &BlobWalker::matchEnumConstantDecl));
         finder->addMatcher(enumConstantDecl(hasAncestor(enumDecl().bind(types[ENUM_PARENT])))
-                .bind(types[ENUM_CONST_DECL]), this);
+                .bind(types[ENUM_CONST_DECL]),
+                           addHandler(this, &BlobWalker::matchEnumConstantDecl));
 
         //Looks for enum references.
-        finder->addMatcher(varDecl(hasType(enumDecl().bind(types[ENUM_DEC_REF]))).bind(types[VAR_REF_ENUM]), this);
-        finder->addMatcher(fieldDecl(hasType(enumDecl().bind(types[ENUM_DEC_REF]))).bind(types[FIELD_REF_ENUM]), this);
+        finder->addMatcher(varDecl(hasType(enumDecl().bind(types[ENUM_DEC_REF]))).bind(types[VAR_REF_ENUM]),
+                           addHandler(this, &BlobWalker::matchVariableEnumRef));
+        finder->addMatcher(fieldDecl(hasType(enumDecl().bind(types[ENUM_DEC_REF]))).bind(types[FIELD_REF_ENUM]),
+                           addHandler(this, &BlobWalker::matchFieldEnumRef));
     }
 
     //Struct methods.
     if (!exclusions.cStruct){
         //Builds the struct definition.
-        finder->addMatcher(recordDecl(isStruct()).bind(types[STRUCT_DECL]), this);
+        finder->addMatcher(recordDecl(isStruct()).bind(types[STRUCT_DECL]),
+                           addHandler(this, &BlobWalker::matchStructDecl));
 
         //Builds up struct.
         finder->addMatcher(varDecl(hasAncestor(recordDecl(isStruct()).bind(types[STRUCT_REF])))
-                                   .bind(types[STRUCT_REF_ITEM]), this);
+                                   .bind(types[STRUCT_REF_ITEM]),
+                           addHandler(this, &BlobWalker::matchStructItem));
         finder->addMatcher(fieldDecl(hasAncestor(recordDecl(isStruct()).bind(types[STRUCT_REF])))
-                                   .bind(types[STRUCT_REF_ITEM]), this);
+                                   .bind(types[STRUCT_REF_ITEM]),
+                           addHandler(this, &BlobWalker::matchStructItem));
         finder->addMatcher(functionDecl(hasAncestor(recordDecl(isStruct()).bind(types[STRUCT_REF])))
-                                   .bind(types[STRUCT_REF_ITEM]), this);
+                                   .bind(types[STRUCT_REF_ITEM]),
+                           addHandler(this, &BlobWalker::matchStructItem));
 
         //Builds the struct reference.
         finder->addMatcher(varDecl(hasType(elaboratedType(namesType(recordType(hasDeclaration(recordDecl(isStruct())
-                           .bind(types[STRUCT_REF_DECL]))))))).bind(types[VAR_BOUND_STRUCT]), this);
+                           .bind(types[STRUCT_REF_DECL]))))))).bind(types[VAR_BOUND_STRUCT]),
+                           addHandler(this, &BlobWalker::matchVariableStructRef));
         finder->addMatcher(fieldDecl(hasType(elaboratedType(namesType(recordType(hasDeclaration(recordDecl(isStruct())
-                           .bind(types[STRUCT_REF_DECL]))))))).bind(types[FIELD_BOUND_STRUCT]), this);
+                           .bind(types[STRUCT_REF_DECL]))))))).bind(types[FIELD_BOUND_STRUCT]),
+                           addHandler(this, &BlobWalker::matchFieldStructRef));
     }
 
     //Union methods.
     if (!exclusions.cUnion){
         //Builds the union definition.
-        finder->addMatcher(recordDecl(isUnion()).bind(types[UNION_DECL]), this);
+        finder->addMatcher(recordDecl(isUnion()).bind(types[UNION_DECL]),
+                           addHandler(this, &BlobWalker::matchUnionDecl));
 
         //Builds up union.
         finder->addMatcher(varDecl(hasAncestor(recordDecl(isUnion()).bind(types[UNION_REF])))
-                                   .bind(types[UNION_REF_ITEM]), this);
+                                   .bind(types[UNION_REF_ITEM]),
+                           addHandler(this, &BlobWalker::matchUnionItem));
         finder->addMatcher(fieldDecl(hasAncestor(recordDecl(isUnion()).bind(types[UNION_REF])))
-                                   .bind(types[UNION_REF_ITEM]), this);
+                                   .bind(types[UNION_REF_ITEM]),
+                           addHandler(this, &BlobWalker::matchUnionItem));
         finder->addMatcher(functionDecl(hasAncestor(recordDecl(isUnion()).bind(types[UNION_REF])))
-                                   .bind(types[UNION_REF_ITEM]), this);
+                                   .bind(types[UNION_REF_ITEM]),
+                           addHandler(this, &BlobWalker::matchUnionItem));
 
         //Builds the struct reference.
         finder->addMatcher(varDecl(hasType(elaboratedType(namesType(recordType(hasDeclaration(recordDecl(isUnion())
-                           .bind(types[UNION_REF_DECL]))))))).bind(types[VAR_BOUND_UNION]), this);
+                           .bind(types[UNION_REF_DECL]))))))).bind(types[VAR_BOUND_UNION]),
+                           addHandler(this, &BlobWalker::matchVariableUnionRef));
         finder->addMatcher(fieldDecl(hasType(elaboratedType(namesType(recordType(hasDeclaration(recordDecl(isUnion())
-                           .bind(types[UNION_REF_DECL]))))))).bind(types[FIELD_BOUND_UNION]), this);
+                           .bind(types[UNION_REF_DECL]))))))).bind(types[FIELD_BOUND_UNION]),
+                           addHandler(this, &BlobWalker::matchFieldUnionRef));
     }
 }
 
+/**
+ * Checks whether any matcher looks inside function bodies. Besides
+ * calls and variable uses, classes, enums, structs and unions can be
+ * declared inside a function.
+ * @return Whether function bodies must be parsed.
+ */
+bool BlobWalker::needsFunctionBodies(){
+    return ASTWalker::needsFunctionBodies() || !exclusions.cClass || !exclusions.cEnum || !exclusions.cStruct ||
+           !exclusions.cUnion;
+}
+
 /**
  * For some declaration decl, gets the class of that decl and then adds it to that.
  * @param result The result for the match.
@@ -39,8 +39,8 @@ public:
     ~BlobWalker() override;
 
     /** Methods for running the AST Walker */
-    void run(const MatchFinder::MatchResult &result) override;
     void generateASTMatches(MatchFinder *finder) override;
+    bool needsFunctionBodies() override;
 
 private:
     /** Enum and Array for AST Matcher */
@@ -56,6 +56,30 @@ private:
                             "struct_ref", "struct_ref_decl", "var_bound_struct", "field_bound_struct", "union_decl",
                              "union_ref_item", "union_ref", "union_ref_decl", "var_bound_union", "field_bound_union"};
 
+    /** Match Handlers */
+    void matchFunctionDecl(const MatchFinder::MatchResult &result);
+    void matchVariableDecl(const MatchFinder::MatchResult &result);
+    void matchFieldDecl(const MatchFinder::MatchResult &result);
+    void matchVariableInside(const MatchFinder::MatchResult &result);
+    void matchFieldInside(const MatchFinder::MatchResult &result);
+    void matchVariableParam(const MatchFinder::MatchResult &result);
+    void matchFunctionCall(const MatchFinder::MatchResult &result);
+    void matchVariableCall(const MatchFinder::MatchResult &result);
+    void matchFieldCall(const MatchFinder::MatchResult &result);
+    void matchClassDecl(const MatchFinder::MatchResult &result);
+    void matchEnumDecl(const MatchFinder::MatchResult &result);
+    void matchEnumConstantDecl(const MatchFinder::MatchResult &result);
+    void matchVariableEnumRef(const MatchFinder::MatchResult &result);
+    void matchFieldEnumRef(const MatchFinder::MatchResult &result);
+    void matchStructDecl(const MatchFinder::MatchResult &result);
+    void matchStructItem(const MatchFinder::MatchResult &result);
+    void matchVariableStructRef(const MatchFinder::MatchResult &result);
+    void matchFieldStructRef(const MatchFinder::MatchResult &result);
+    void matchUnionDecl(const MatchFinder::MatchResult &result);
+    void matchUnionItem(const MatchFinder::MatchResult &result);
+    void matchVariableUnionRef(const MatchFinder::MatchResult &result);
+    void matchFieldUnionRef(const MatchFinder::MatchResult &result);
+
     /** Manages Classes */
     void performAddClassCall(const MatchFinder::MatchResult result, const clang::DeclaratorDecl *decl,
                              ClangNode::NodeType type);
@@ -0,0 +1,82 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// BodySkipConsumer.cpp
+//
+// Created By: Bryan J Muscedere
+// Date: 19/10/26.
+//
+// Consumer that passes the AST on to the matchers while telling Clang
+// which function bodies it doesn't have to parse. Bodies are skipped
+// when no enabled matcher needs them, when they're outside the main
+// file and only the main file is walked, or when their file is
+// filtered out.
+//
+// Copyright (C) 2017, Bryan J. Muscedere
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "BodySkipConsumer.h"
+#include "clang/AST/Decl.h"
+
+using namespace std;
+using namespace clang;
+
+/**
+ * Wraps the consumer that runs the matchers.
+ * @param consumer The consumer that gets the AST.
+ * @param srcMgr The source manager of the translation unit.
+ * @param policy Which function bodies are skipped.
+ */
+BodySkipConsumer::BodySkipConsumer(unique_ptr<ASTConsumer> consumer, SourceManager& srcMgr, BodyPolicy policy) :
+        MultiplexConsumer(wrap(move(consumer))), srcMgr(srcMgr), policy(policy) { }
+
+/**
+ * Destructor.
+ */
+BodySkipConsumer::~BodySkipConsumer() { }
+
+/**
+ * Checks whether Clang can skip the body of a function.
+ * @param decl The function being parsed.
+ * @return Whether the body is skipped.
+ */
+bool BodySkipConsumer::shouldSkipFunctionBody(Decl* decl){
+    if (policy.skipAll) return true;
+
+    SourceLocation loc = srcMgr.getExpansionLoc(decl->getLocation());
+    if (policy.skipOutsideMain && !srcMgr.isInMainFile(loc)) return true;
+    if (policy.filter == nullptr) return false;
+
+    return policy.filter->isExcluded(srcMgr, srcMgr.getFileID(loc), &filterCache);
+}
+
+/**
+ * Checks whether a policy skips any function bodies.
+ * @param policy The policy.
+ * @return Whether function bodies may be skipped.
+ */
+bool BodySkipConsumer::skipsBodies(BodyPolicy policy){
+    return policy.skipAll || policy.skipOutsideMain || policy.filter != nullptr;
+}
+
+/**
+ * Puts a consumer in the list the multiplexer expects.
+ * @param consumer The consumer.
+ * @return The list of consumers.
+ */
+vector<unique_ptr<ASTConsumer>> BodySkipConsumer::wrap(unique_ptr<ASTConsumer> consumer){
+    vector<unique_ptr<ASTConsumer>> consumers;
+    consumers.push_back(move(consumer));
+    return consumers;
+}
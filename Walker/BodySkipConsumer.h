@@ -0,0 +1,69 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// BodySkipConsumer.h
+//
+// Created By: Bryan J Muscedere
+// Date: 19/10/26.
+//
+// Consumer that passes the AST on to the matchers while telling Clang
+// which function bodies it doesn't have to parse. Bodies are skipped
+// when no enabled matcher needs them, when they're outside the main
+// file and only the main file is walked, or when their file is
+// filtered out.
+//
+// Copyright (C) 2017, Bryan J. Muscedere
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CLANGEX_BODYSKIPCONSUMER_H
+#define CLANGEX_BODYSKIPCONSUMER_H
+
+#include <memory>
+#include <vector>
+#include "clang/AST/ASTConsumer.h"
+#include "clang/Basic/SourceManager.h"
+#include "clang/Frontend/MultiplexConsumer.h"
+#include "../File/PathFilter.h"
+
+class BodySkipConsumer : public clang::MultiplexConsumer {
+public:
+    /** Function Body Settings */
+    typedef struct {
+        bool skipAll = false;
+        bool skipOutsideMain = false;
+        const PathFilter* filter = nullptr;
+    } BodyPolicy;
+
+    /** Constructor/Destructor */
+    BodySkipConsumer(std::unique_ptr<clang::ASTConsumer> consumer, clang::SourceManager& srcMgr, BodyPolicy policy);
+    ~BodySkipConsumer() override;
+
+    /** Consumer Operations */
+    bool shouldSkipFunctionBody(clang::Decl* decl) override;
+
+    /** Policy Operations */
+    static bool skipsBodies(BodyPolicy policy);
+
+private:
+    /** Consumer Variables */
+    clang::SourceManager& srcMgr;
+    BodyPolicy policy;
+    PathFilter::ResultCache filterCache;
+
+    /** Helper Methods */
+    static std::vector<std::unique_ptr<clang::ASTConsumer>> wrap(std::unique_ptr<clang::ASTConsumer> consumer);
+};
+
+
+#endif //CLANGEX_BODYSKIPCONSUMER_H
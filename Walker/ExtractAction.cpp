@@ -0,0 +1,111 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// ExtractAction.cpp
+//
+// Created By: Bryan J Muscedere
+// Date: 19/10/26.
+//
+// Frontend action used to run ClangEx on each file. It runs the AST
+// matchers of a walker and attaches the include collector to the
+// preprocessor so includes are recorded in the same pass.
+//
+// Copyright (C) 2017, Bryan J. Muscedere
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <boost/filesystem.hpp>
+#include "ExtractAction.h"
+#include "IncludeCollector.h"
+
+using namespace std;
+using namespace clang;
+using namespace clang::ast_matchers;
+
+/**
+ * Creates an action for a single file.
+ * @param finder The matchers to run.
+ * @param graph The graph that gets the include relations.
+ * @param addFiles Whether file entities are added for the includes.
+ * @param includes Where the includes of each file are collected or null.
+ * @param bodies Which function bodies are skipped.
+ */
+ExtractAction::ExtractAction(MatchFinder* finder, TAGraph* graph, bool addFiles, IncludeMap* includes,
+                             BodySkipConsumer::BodyPolicy bodies) {
+    this->finder = finder;
+    this->graph = graph;
+    this->addFiles = addFiles;
+    this->includes = includes;
+    this->bodies = bodies;
+}
+
+/**
+ * Destructor.
+ */
+ExtractAction::~ExtractAction() { }
+
+/**
+ * Attaches the include collector and creates the matcher consumer.
+ * When some function bodies aren't needed, Clang is told to skip
+ * them and the consumer decides which ones.
+ * @param compiler The compiler instance for the file.
+ * @param file The file being processed.
+ * @return The consumer that runs the matchers.
+ */
+unique_ptr<ASTConsumer> ExtractAction::CreateASTConsumer(CompilerInstance& compiler, llvm::StringRef file){
+    set<string>* fileIncludes = nullptr;
+    if (includes != nullptr) {
+        string name(file);
+        boost::system::error_code error;
+        boost::filesystem::path canonPath = canonical(boost::filesystem::path(name), error);
+        if (!error) name = canonPath.string();
+        fileIncludes = &(*includes)[name];
+    }
+
+    compiler.getPreprocessor().addPPCallbacks(unique_ptr<PPCallbacks>(
+            new IncludeCollector(compiler.getSourceManager(), graph, addFiles, fileIncludes)));
+    if (!BodySkipConsumer::skipsBodies(bodies)) return finder->newASTConsumer();
+
+    compiler.getFrontendOpts().SkipFunctionBodies = true;
+    return unique_ptr<ASTConsumer>(new BodySkipConsumer(finder->newASTConsumer(), compiler.getSourceManager(), bodies));
+}
+
+/**
+ * Creates a factory for the actions of a tool run.
+ * @param finder The matchers to run.
+ * @param graph The graph that gets the include relations.
+ * @param addFiles Whether file entities are added for the includes.
+ * @param includes Where the includes of each file are collected or null.
+ * @param bodies Which function bodies are skipped.
+ */
+ExtractActionFactory::ExtractActionFactory(MatchFinder* finder, TAGraph* graph, bool addFiles,
+                                           ExtractAction::IncludeMap* includes, BodySkipConsumer::BodyPolicy bodies) {
+    this->finder = finder;
+    this->graph = graph;
+    this->addFiles = addFiles;
+    this->includes = includes;
+    this->bodies = bodies;
+}
+
+/**
+ * Destructor.
+ */
+ExtractActionFactory::~ExtractActionFactory() { }
+
+/**
+ * Creates the action for the next file.
+ * @return The action.
+ */
+FrontendAction* ExtractActionFactory::create(){
+    return new ExtractAction(finder, graph, addFiles, includes, bodies);
+}
@@ -0,0 +1,86 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// ExtractAction.h
+//
+// Created By: Bryan J Muscedere
+// Date: 19/10/26.
+//
+// Frontend action used to run ClangEx on each file. It runs the AST
+// matchers of a walker and attaches the include collector to the
+// preprocessor so includes are recorded in the same pass.
+//
+// Copyright (C) 2017, Bryan J. Muscedere
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CLANGEX_EXTRACTACTION_H
+#define CLANGEX_EXTRACTACTION_H
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include "clang/Frontend/FrontendAction.h"
+#include "clang/Frontend/CompilerInstance.h"
+#include "clang/Tooling/Tooling.h"
+#include "clang/ASTMatchers/ASTMatchFinder.h"
+#include "../Graph/TAGraph.h"
+#include "BodySkipConsumer.h"
+
+class ExtractAction : public clang::ASTFrontendAction {
+public:
+    /** Files Included by Each Translation Unit */
+    typedef std::map<std::string, std::set<std::string>> IncludeMap;
+
+    /** Constructor/Destructor */
+    ExtractAction(clang::ast_matchers::MatchFinder* finder, TAGraph* graph, bool addFiles, IncludeMap* includes,
+                  BodySkipConsumer::BodyPolicy bodies);
+    ~ExtractAction() override;
+
+protected:
+    /** Frontend Operations */
+    std::unique_ptr<clang::ASTConsumer> CreateASTConsumer(clang::CompilerInstance& compiler,
+                                                          llvm::StringRef file) override;
+
+private:
+    /** Action Variables */
+    clang::ast_matchers::MatchFinder* finder;
+    TAGraph* graph;
+    bool addFiles;
+    IncludeMap* includes;
+    BodySkipConsumer::BodyPolicy bodies;
+};
+
+class ExtractActionFactory : public clang::tooling::FrontendActionFactory {
+public:
+    /** Constructor/Destructor */
+    ExtractActionFactory(clang::ast_matchers::MatchFinder* finder, TAGraph* graph, bool addFiles,
+                         ExtractAction::IncludeMap* includes = nullptr,
+                         BodySkipConsumer::BodyPolicy bodies = BodySkipConsumer::BodyPolicy());
+    ~ExtractActionFactory() override;
+
+    /** Factory Operations */
+    clang::FrontendAction* create() override;
+
+private:
+    /** Factory Variables */
+    clang::ast_matchers::MatchFinder* finder;
+    TAGraph* graph;
+    bool addFiles;
+    ExtractAction::IncludeMap* includes;
+    BodySkipConsumer::BodyPolicy bodies;
+};
+
+
+#endif //CLANGEX_EXTRACTACTION_H
@@ -0,0 +1,135 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// IncludeCollector.cpp
+//
+// Created By: Bryan J Muscedere
+// Date: 19/10/26.
+//
+// Preprocessor callbacks that record which files each translation unit
+// includes. Every include of a user file is added to the graph as an
+// include relation between file entities and collected so incremental
+// runs know which translation units a header change affects.
+//
+// Copyright (C) 2017, Bryan J. Muscedere
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <boost/filesystem.hpp>
+#include "IncludeCollector.h"
+#include "ASTWalker.h"
+
+using namespace std;
+using namespace clang;
+
+/**
+ * Creates a collector for a single translation unit.
+ * @param srcMgr The source manager of the translation unit.
+ * @param graph The graph that gets the include relations.
+ * @param addFiles Whether file entities are added for the includes.
+ * @param includes The files the translation unit includes or null.
+ */
+IncludeCollector::IncludeCollector(SourceManager& srcMgr, TAGraph* graph, bool addFiles, set<string>* includes) :
+        srcMgr(srcMgr) {
+    this->graph = graph;
+    this->addFiles = addFiles;
+    this->includes = includes;
+}
+
+/**
+ * Destructor.
+ */
+IncludeCollector::~IncludeCollector() { }
+
+/**
+ * Records a user file as it's entered. The main file sets the
+ * translation unit that the facts come from.
+ * @param loc The start of the file.
+ * @param reason Why the preprocessor changed files.
+ * @param fileType Whether the file is a user or system file.
+ * @param prevFID The file that was left.
+ */
+void IncludeCollector::FileChanged(SourceLocation loc, FileChangeReason reason, SrcMgr::CharacteristicKind fileType,
+                                   FileID prevFID){
+    if (reason != EnterFile || fileType != SrcMgr::C_User) return;
+
+    FileID curFID = srcMgr.getFileID(loc);
+    const FileEntry* entry = srcMgr.getFileEntryForID(curFID);
+    if (entry == nullptr) return;
+
+    //The main file isn't included by anything.
+    if (curFID == srcMgr.getMainFileID()) {
+        if (graph->isTrackingProvenance()) graph->setCurrentTU(getFileName(entry));
+        return;
+    }
+
+    addInclude(srcMgr.getIncludeLoc(curFID), entry);
+}
+
+/**
+ * Records a user file that wasn't entered again because of its
+ * include guard.
+ * @param skippedFile The file that was skipped.
+ * @param filenameTok The name in the include directive.
+ * @param fileType Whether the file is a user or system file.
+ */
+void IncludeCollector::FileSkipped(const FileEntry& skippedFile, const Token& filenameTok,
+                                   SrcMgr::CharacteristicKind fileType){
+    if (fileType != SrcMgr::C_User) return;
+    addInclude(filenameTok.getLocation(), &skippedFile);
+}
+
+/**
+ * Adds an include relation from the file with the directive.
+ * @param includeLoc The location of the include directive.
+ * @param included The file that was included.
+ */
+void IncludeCollector::addInclude(SourceLocation includeLoc, const FileEntry* included){
+    if (!includeLoc.isValid() || srcMgr.isInSystemHeader(includeLoc)) return;
+
+    const FileEntry* includer = srcMgr.getFileEntryForID(srcMgr.getFileID(srcMgr.getExpansionLoc(includeLoc)));
+    if (includer == nullptr) return;
+
+    string srcName = getFileName(includer);
+    string dstName = getFileName(included);
+    if (srcName.compare("") == 0 || dstName.compare("") == 0) return;
+    if (includes != nullptr) includes->insert(dstName);
+    if (!addFiles) return;
+
+    //Adds the files and the relation between them.
+    string srcID = ASTWalker::generateMD5(srcName);
+    string dstID = ASTWalker::generateMD5(dstName);
+    graph->addPath(srcName);
+    graph->addPath(dstName);
+    graph->addNode(new ClangNode(srcID, boost::filesystem::path(srcName).filename().string(), ClangNode::FILE));
+    graph->addNode(new ClangNode(dstID, boost::filesystem::path(dstName).filename().string(), ClangNode::FILE));
+    graph->addEdge(new ClangEdge(srcID, dstID, ClangEdge::INCLUDES));
+}
+
+/**
+ * Gets the canonical path of a file. Paths are cached per file.
+ * @param entry The file.
+ * @return The canonical path or an empty string.
+ */
+string IncludeCollector::getFileName(const FileEntry* entry){
+    auto it = names.find(entry);
+    if (it != names.end()) return it->second;
+
+    string name(entry->getName());
+    boost::system::error_code error;
+    boost::filesystem::path canonPath = canonical(boost::filesystem::path(name).normalize(), error);
+    if (!error) name = canonPath.string();
+
+    names[entry] = name;
+    return name;
+}
@@ -0,0 +1,64 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+// IncludeCollector.h
+//
+// Created By: Bryan J Muscedere
+// Date: 19/10/26.
+//
+// Preprocessor callbacks that record which files each translation unit
+// includes. Every include of a user file is added to the graph as an
+// include relation between file entities and collected so incremental
+// runs know which translation units a header change affects.
+//
+// Copyright (C) 2017, Bryan J. Muscedere
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CLANGEX_INCLUDECOLLECTOR_H
+#define CLANGEX_INCLUDECOLLECTOR_H
+
+#include <set>
+#include <string>
+#include <unordered_map>
+#include "clang/Basic/SourceManager.h"
+#include "clang/Lex/PPCallbacks.h"
+#include "../Graph/TAGraph.h"
+
+class IncludeCollector : public clang::PPCallbacks {
+public:
+    /** Constructor/Destructor */
+    IncludeCollector(clang::SourceManager& srcMgr, TAGraph* graph, bool addFiles, std::set<std::string>* includes);
+    ~IncludeCollector() override;
+
+    /** Preprocessor Callbacks */
+    void FileChanged(clang::SourceLocation loc, FileChangeReason reason, clang::SrcMgr::CharacteristicKind fileType,
+                     clang::FileID prevFID) override;
+    void FileSkipped(const clang::FileEntry& skippedFile, const clang::Token& filenameTok,
+                     clang::SrcMgr::CharacteristicKind fileType) override;
+
+private:
+    /** Collector Variables */
+    clang::SourceManager& srcMgr;
+    TAGraph* graph;
+    bool addFiles;
+    std::set<std::string>* includes;
+    std::unordered_map<const clang::FileEntry*, std::string> names;
+
+    /** Helper Methods */
+    void addInclude(clang::SourceLocation includeLoc, const clang::FileEntry* included);
+    std::string getFileName(const clang::FileEntry* entry);
+};
+
+
+#endif //CLANGEX_INCLUDECOLLECTOR_H
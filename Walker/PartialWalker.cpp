@@ -48,143 +48,222 @@ PartialWalker::PartialWalker(Printer* print, bool lowMemory, TAGraph::ClangExclu
 PartialWalker::~PartialWalker() { }
 
 /**
- * Runs the AST matcher system. Looks for the match type and then acts on it.
+ * Adds a function declaration.
  * @param result The result that triggers this function.
  */
-void PartialWalker::run(const MatchFinder::MatchResult &result) {
-    //Look for the AST matcher being triggered.
-    if (const FunctionDecl *functionDecl = result.Nodes.getNodeAs<clang::FunctionDecl>(types[FUNC_DEC])) {
-        //If a function has been found.
-        addFunctionDecl(result, functionDecl);
-
-        //Adds class declarations/references.
-        manageClasses(result, functionDecl, ClangNode::FUNCTION);
-    } else if (const CallExpr *expr = result.Nodes.getNodeAs<clang::CallExpr>(types[FUNC_CALL])) {
-        //If a function call has been found.
-        auto caller = result.Nodes.getNodeAs<clang::DeclaratorDecl>(types[CALLER]);
-        if (expr->getCalleeDecl() == nullptr || expr->getCalleeDecl()->getAsFunction() == nullptr) return;
-        auto callee = expr->getCalleeDecl()->getAsFunction();
-
-        addFunctionCall(result, caller, callee);
-    } else if (const VarDecl *varDecl = result.Nodes.getNodeAs<clang::VarDecl>(types[VAR_DEC])) {
-        //If a variable declaration has been found.
-        addVariableDecl(result, varDecl);
-
-        //Adds class declarations/references.
-        manageClasses(result, varDecl, ClangNode::VARIABLE);
-    } else if (const VarDecl *varInside = result.Nodes.getNodeAs<clang::VarDecl>(types[VAR_INSIDE])) {
-        //Gets the parent function.
-        auto *functionDecl = result.Nodes.getNodeAs<clang::FunctionDecl>(types[INSIDE_FUNC]);
-
-        //Adds the function.
-        addVariableInsideCall(result, functionDecl, varInside);
-    } else if (const ParmVarDecl *paramInside = result.Nodes.getNodeAs<clang::ParmVarDecl>(types[PARAM_INSIDE])) {
-        //Gets the parent function.
-        auto *functionDecl = result.Nodes.getNodeAs<clang::FunctionDecl>(types[INSIDE_FUNC]);
-
-        //Adds the function.
-        addVariableInsideCall(result, functionDecl, paramInside);
-    } else if (const VarDecl *varDeclExpr = result.Nodes.getNodeAs<clang::VarDecl>(types[VAR_CALL])) {
-        //If a variable reference has been found.
-        auto *caller = result.Nodes.getNodeAs<clang::DeclaratorDecl>(types[CALLER_VAR]);
-        auto *expr = result.Nodes.getNodeAs<clang::Expr>(types[VAR_EXPR]);
-
-        addVariableCall(result, caller, expr, varDeclExpr);
-    } else if (const FunctionDecl *functionDeclClass = result.Nodes.getNodeAs<clang::FunctionDecl>(
-            types[CLASS_DEC_FUNC])) {
-        //Get the variable declaration.
-        auto *var = result.Nodes.getNodeAs<clang::VarDecl>(types[CLASS_DEC_VAR]);
-
-        //Add the class reference.
-        manageClasses(result, functionDeclClass, ClangNode::VARIABLE, var);
-    } else if (const VarDecl *varRefDecl = result.Nodes.getNodeAs<clang::VarDecl>(types[ENUM_VAR])) {
-        auto *enumDecl = result.Nodes.getNodeAs<clang::EnumDecl>(types[ENUM_DEC]);
-
-        //Get the file name of the varRef.
-        string filename = generateFileName(result, varRefDecl->getInnerLocStart());
-
-        //Add the enum decl first.
-        addEnumDecl(result, enumDecl, filename);
-
-        //Add the variable reference.
-        addEnumCall(result, enumDecl, varRefDecl);
-
-        //Finally, add the enum constants.
-        addEnumConstants(result, enumDecl, filename);
-    } else if (const EnumDecl *enumDecl = result.Nodes.getNodeAs<clang::EnumDecl>(types[ENUM_DEC])) {
-        //Add the enum.
-        addEnumDecl(result, enumDecl);
-
-        //Add the enum constants.
-        addEnumConstants(result, enumDecl);
-    } else if (const RecordDecl *structDecl = result.Nodes.getNodeAs<clang::RecordDecl>(types[STRUCT_DECL])){
-        //Adds the struct.
-        addStructDecl(result, structDecl);
-    } else if (const DeclaratorDecl *itemDecl = result.Nodes.getNodeAs<clang::DeclaratorDecl>(types[STRUCT_REF_ITEM])) {
-        //Get the struct being referenced.
-        auto *structDecl = result.Nodes.getNodeAs<clang::RecordDecl>(types[STRUCT_REF]);
-
-        //Adds the structure.
-        addStructDecl(result, structDecl, generateFileName(result, itemDecl->getInnerLocStart()));
-        //addStructCall(result, structDecl, itemDecl);
-    }
+void PartialWalker::matchFunctionDecl(const MatchFinder::MatchResult &result){
+    const FunctionDecl *functionDecl = result.Nodes.getNodeAs<clang::FunctionDecl>(types[FUNC_DEC]);
+    if (functionDecl == nullptr) return;
+
+    //If a function has been found.
+    addFunctionDecl(result, functionDecl);
+
+    //Adds class declarations/references.
+    manageClasses(result, functionDecl, ClangNode::FUNCTION);
+}
+
+/**
+ * Adds a call from one function to another.
+ * @param result The result that triggers this function.
+ */
+void PartialWalker::matchFunctionCall(const MatchFinder::MatchResult &result){
+    const CallExpr *expr = result.Nodes.getNodeAs<clang::CallExpr>(types[FUNC_CALL]);
+
+    //If a function call has been found.
+    auto caller = result.Nodes.getNodeAs<clang::DeclaratorDecl>(types[CALLER]);
+    if (expr == nullptr || expr->getCalleeDecl() == nullptr || expr->getCalleeDecl()->getAsFunction() == nullptr) return;
+    auto callee = expr->getCalleeDecl()->getAsFunction();
+
+    addFunctionCall(result, caller, callee);
+}
+
+/**
+ * Adds a variable declaration.
+ * @param result The result that triggers this function.
+ */
+void PartialWalker::matchVariableDecl(const MatchFinder::MatchResult &result){
+    const VarDecl *varDecl = result.Nodes.getNodeAs<clang::VarDecl>(types[VAR_DEC]);
+    if (varDecl == nullptr) return;
+
+    //If a variable declaration has been found.
+    addVariableDecl(result, varDecl);
+
+    //Adds class declarations/references.
+    manageClasses(result, varDecl, ClangNode::VARIABLE);
+}
+
+/**
+ * Adds a function's use of a variable.
+ * @param result The result that triggers this function.
+ */
+void PartialWalker::matchVariableCall(const MatchFinder::MatchResult &result){
+    const VarDecl *varDeclExpr = result.Nodes.getNodeAs<clang::VarDecl>(types[VAR_CALL]);
+    if (varDeclExpr == nullptr) return;
+
+    //If a variable reference has been found.
+    auto *caller = result.Nodes.getNodeAs<clang::DeclaratorDecl>(types[CALLER_VAR]);
+    auto *expr = result.Nodes.getNodeAs<clang::Expr>(types[VAR_EXPR]);
+
+    addVariableCall(result, caller, expr, varDeclExpr);
+}
+
+/**
+ * Adds the class of a function to a variable inside it.
+ * @param result The result that triggers this function.
+ */
+void PartialWalker::matchClassRef(const MatchFinder::MatchResult &result){
+    const FunctionDecl *functionDeclClass = result.Nodes.getNodeAs<clang::FunctionDecl>(types[CLASS_DEC_FUNC]);
+    if (functionDeclClass == nullptr) return;
+
+    //Get the variable declaration.
+    auto *var = result.Nodes.getNodeAs<clang::VarDecl>(types[CLASS_DEC_VAR]);
+
+    //Add the class reference.
+    manageClasses(result, functionDeclClass, ClangNode::VARIABLE, var);
+}
+
+/**
+ * Adds a variable of an enum type along with the enum.
+ * @param result The result that triggers this function.
+ */
+void PartialWalker::matchEnumVariable(const MatchFinder::MatchResult &result){
+    const VarDecl *varRefDecl = result.Nodes.getNodeAs<clang::VarDecl>(types[ENUM_VAR]);
+    auto *enumDecl = result.Nodes.getNodeAs<clang::EnumDecl>(types[ENUM_DEC]);
+    if (varRefDecl == nullptr || enumDecl == nullptr) return;
+
+    //Get the file name of the varRef.
+    string filename = generateFileName(result, varRefDecl->getInnerLocStart());
+
+    //Add the enum decl first.
+    addEnumDecl(result, enumDecl, filename);
+
+    //Add the variable reference.
+    addEnumCall(result, enumDecl, varRefDecl);
+
+    //Finally, add the enum constants.
+    addEnumConstants(result, enumDecl, filename);
+}
+
+/**
+ * Adds an enum declaration.
+ * @param result The result that triggers this function.
+ */
+void PartialWalker::matchEnumDecl(const MatchFinder::MatchResult &result){
+    const EnumDecl *enumDecl = result.Nodes.getNodeAs<clang::EnumDecl>(types[ENUM_DEC]);
+    if (enumDecl == nullptr) return;
+
+    //Add the enum.
+    addEnumDecl(result, enumDecl);
+
+    //Add the enum constants.
+    addEnumConstants(result, enumDecl);
+}
+
+/**
+ * Adds a struct declaration.
+ * @param result The result that triggers this function.
+ */
+void PartialWalker::matchStructDecl(const MatchFinder::MatchResult &result){
+    const RecordDecl *structDecl = result.Nodes.getNodeAs<clang::RecordDecl>(types[STRUCT_DECL]);
+    if (structDecl == nullptr) return;
+
+    //Adds the struct.
+    addStructDecl(result, structDecl);
+}
+
+/**
+ * Adds the struct of an item that is part of it.
+ * @param result The result that triggers this function.
+ */
+void PartialWalker::matchStructItem(const MatchFinder::MatchResult &result){
+    const DeclaratorDecl *itemDecl = result.Nodes.getNodeAs<clang::DeclaratorDecl>(types[STRUCT_REF_ITEM]);
+    if (itemDecl == nullptr) return;
+
+    //Get the struct being referenced.
+    auto *structDecl = result.Nodes.getNodeAs<clang::RecordDecl>(types[STRUCT_REF]);
+
+    //Adds the structure.
+    addStructDecl(result, structDecl, generateFileName(result, itemDecl->getInnerLocStart()));
+    //addStructCall(result, structDecl, itemDecl);
 }
 
 /**
- * Generates the AST matchers that will trigger the run function.
+ * Generates the AST matchers. Each matcher gets its own handler so
+ * matches don't need to be told apart by their bindings.
  * @param finder The match finder that will store these triggers.
  */
 void PartialWalker::generateASTMatches(MatchFinder *finder) {
     //Function methods.
     if (!exclusions.cFunction){
         //Finds function declarations for current C/C++ file.
-        finder->addMatcher(functionDecl(isExpansionInMainFile()).bind(types[FUNC_DEC]), this);
+        finder->addMatcher(functionDecl(isExpansionInMainFile()).bind(types[FUNC_DEC]),
+                           addHandler(this, &PartialWalker::matchFunctionDecl));
 
         //Finds function calls from one function to another.
-        finder->addMatcher(callExpr(isExpansionInMainFile(), hasAncestor(functionDecl().bind(types[CALLER]))).bind(types[FUNC_CALL]), this);
+        finder->addMatcher(callExpr(isExpansionInMainFile(), hasAncestor(functionDecl().bind(types[CALLER]))).bind(types[FUNC_CALL]),
+                           addHandler(this, &PartialWalker::matchFunctionCall));
     }
 
     //Variable methods.
     if (!exclusions.cVariable){
         //Finds variables in functions or in class declaration.
-        finder->addMatcher(varDecl(isExpansionInMainFile()).bind(types[VAR_DEC]), this);
+        finder->addMatcher(varDecl(isExpansionInMainFile()).bind(types[VAR_DEC]),
+                           addHandler(this, &PartialWalker::matchVariableDecl));
 
         //Finds variable uses from a function to a variable.
         finder->addMatcher(declRefExpr(hasDeclaration(varDecl(isExpansionInMainFile()).bind(types[VAR_CALL])),
                                        hasAncestor(functionDecl().bind(types[CALLER_VAR])),
-                                       hasParent(expr().bind(types[VAR_EXPR]))), this);
+                                       hasParent(expr().bind(types[VAR_EXPR]))),
+                           addHandler(this, &PartialWalker::matchVariableCall));
     }
 
     //Class methods.
     if (!exclusions.cClass){
         //Finds any class declarations.
         finder->addMatcher(varDecl(isExpansionInMainFile(), hasAncestor(functionDecl().bind(types[CLASS_DEC_FUNC])))
-                                   .bind(types[CLASS_DEC_VAR]), this);
+                                   .bind(types[CLASS_DEC_VAR]),
+                           addHandler(this, &PartialWalker::matchClassRef));
     }
 
     if (!exclusions.cEnum){
         //Finds enum declarations (assuming they're defined in the source file).
-        finder->addMatcher(enumDecl(isExpansionInMainFile()).bind(types[ENUM_DEC]), this);
+        finder->addMatcher(enumDecl(isExpansionInMainFile()).bind(types[ENUM_DEC]),
+                           addHandler(this, &PartialWalker::matchEnumDecl));
 
         //Finds enums, adds them, and adds their associated references.
         finder->addMatcher(varDecl(isExpansionInMainFile(),
-                                   hasType(enumType(hasDeclaration(enumDecl().bind(types[ENUM_DEC]))))).bind(types[ENUM_VAR]), this);
+                                   hasType(enumType(hasDeclaration(enumDecl().bind(types[ENUM_DEC]))))).bind(types[ENUM_VAR]),
+                           addHandler(this, &PartialWalker::matchEnumVariable));
     }
 
     if (!exclusions.cStruct){
         //Finds struct declarations.
-        finder->addMatcher(recordDecl(isStruct(), isExpansionInMainFile()).bind(types[STRUCT_DECL]), this);
+        finder->addMatcher(recordDecl(isStruct(), isExpansionInMainFile()).bind(types[STRUCT_DECL]),
+                           addHandler(this, &PartialWalker::matchStructDecl));
 
         //Finds items that are part of structs.
         finder->addMatcher(varDecl(isExpansionInMainFile(),
-                                   hasAncestor(recordDecl(isStruct()).bind(types[STRUCT_REF]))).bind(types[STRUCT_REF_ITEM]), this);
+                                   hasAncestor(recordDecl(isStruct()).bind(types[STRUCT_REF]))).bind(types[STRUCT_REF_ITEM]),
+                           addHandler(this, &PartialWalker::matchStructItem));
         finder->addMatcher(fieldDecl(isExpansionInMainFile(),
-                                     hasAncestor(recordDecl(isStruct()).bind(types[STRUCT_REF]))).bind(types[STRUCT_REF_ITEM]), this);
+                                     hasAncestor(recordDecl(isStruct()).bind(types[STRUCT_REF]))).bind(types[STRUCT_REF_ITEM]),
+                           addHandler(this, &PartialWalker::matchStructItem));
         finder->addMatcher(functionDecl(isExpansionInMainFile(),
-                                        hasAncestor(recordDecl(isStruct()).bind(types[STRUCT_REF]))).bind(types[STRUCT_REF_ITEM]), this);
+                                        hasAncestor(recordDecl(isStruct()).bind(types[STRUCT_REF]))).bind(types[STRUCT_REF_ITEM]),
+                           addHandler(this, &PartialWalker::matchStructItem));
     }
 }
 
+/**
+ * Checks whether any matcher looks inside function bodies. Besides
+ * calls and variable uses, local variables are matched for their class
+ * and enum, and structs can be declared inside a function.
+ * @return Whether function bodies must be parsed.
+ */
+bool PartialWalker::needsFunctionBodies(){
+    return ASTWalker::needsFunctionBodies() || !exclusions.cClass || !exclusions.cEnum || !exclusions.cStruct;
+}
+
 /**
  * Adds the class for the decl being added.
  * @param result The result for the match.
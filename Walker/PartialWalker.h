@@ -39,8 +39,8 @@ public:
     ~PartialWalker() override;
 
     /** Methods for running the AST Walker */
-    void run(const MatchFinder::MatchResult &result) override;
     void generateASTMatches(MatchFinder *finder) override;
+    bool needsFunctionBodies() override;
 
 private:
     /** Enum and Array for AST Matcher */
@@ -50,6 +50,17 @@ private:
                              "var_call", "caller_var", "expr_var", "class_dec_func", "class_dec_var", "enum_dec",
                              "enum_var", "struct_decl", "struct_ref", "struct_ref_item"};
 
+    /** Match Handlers */
+    void matchFunctionDecl(const MatchFinder::MatchResult &result);
+    void matchFunctionCall(const MatchFinder::MatchResult &result);
+    void matchVariableDecl(const MatchFinder::MatchResult &result);
+    void matchVariableCall(const MatchFinder::MatchResult &result);
+    void matchClassRef(const MatchFinder::MatchResult &result);
+    void matchEnumVariable(const MatchFinder::MatchResult &result);
+    void matchEnumDecl(const MatchFinder::MatchResult &result);
+    void matchStructDecl(const MatchFinder::MatchResult &result);
+    void matchStructItem(const MatchFinder::MatchResult &result);
+
     /** Manages Classes and Enums */
     void manageClasses(const MatchFinder::MatchResult result, const clang::DeclaratorDecl *decl,
                        ClangNode::NodeType type, const clang::DeclaratorDecl *innerDecl = nullptr);